@@ -0,0 +1,535 @@
+/**
+ * ffgl-bench is a minimal headless FFGL host. It loads a plugin module, creates a surfaceless EGL context
+ * (llvmpipe is fine, no gpu or display required) and drives the plugin through it's exported plugMain the same
+ * way a real host would: FF_INITIALISE_V2 -> FF_INSTANTIATE_GL -> N x FF_PROCESS_OPENGL -> teardown.
+ * It reports how long the instantiation took and the latency distribution of the processed frames so that
+ * we have a repeatable performance baseline for our plugins on machines without a gpu.
+ *
+ * Usage: ffgl-bench <plugin.so> [options]
+ *   --frames <n>         Number of measured frames (default 500).
+ *   --warmup <n>         Number of frames to render before measuring (default 20).
+ *   --size <w>x<h>       Resolution of the host's output and input textures (default 1920x1080).
+ *   --set <param>=<val>  Set a parameter once after instantiating. May be repeated.
+ *   --sweep <param>      Automate a float parameter between 0 and 1 every frame. May be repeated. Plugins that support
+ *                        FF_CAP_SET_PARAMETERS get all automated parameters with a single FF_SET_PARAMETERS call.
+ *   --instances <n>      Number of instances to create, like a host loading a composition that uses the plugin n times (default 1).
+ *                        The instantiate time of the first and of the following instances is reported separately, frames
+ *                        are only processed by the first instance.
+ *   --program-cache <dir>
+ *                        Enable the sdk's program binary cache in dir by setting FFGL_PROGRAM_CACHE_DIR for the plugin.
+ *                        Run the bench twice to compare instantiating with a cold and a warm cache.
+ *
+ * Messages the plugin logs to the host are written to stderr.
+ *
+ * Like a real host, the bench sends a (synthetic) spectrum to fft buffer parameters every frame. Plugins that
+ * support FF_CAP_SET_PARAMETER_ELEMENT_VALUES get the whole spectrum with one call, others get one call per bin.
+ */
+#include <ffgl/FFGL.h>
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <dlfcn.h>
+#include <stdio.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+typedef std::chrono::steady_clock BenchClock;
+
+struct BenchOptions
+{
+	const char* pluginPath            = nullptr;
+	unsigned int numFrames            = 500;
+	unsigned int numWarmup            = 20;
+	unsigned int width                = 1920;
+	unsigned int height               = 1080;
+	unsigned int numInstances         = 1;
+	const char* programCacheDirectory = nullptr;
+
+	struct ParamValue
+	{
+		FFUInt32 index;
+		std::string value;
+	};
+	std::vector< ParamValue > setParams;//!< Parameters that we'll set once right after instantiating.
+	std::vector< FFUInt32 > sweepParams;//!< Parameters that we'll automate each frame.
+};
+
+struct FFTParam
+{
+	FFUInt32 index;
+	FFUInt32 numBins;
+};
+
+struct GLContext
+{
+	EGLDisplay display = EGL_NO_DISPLAY;
+	EGLContext context = EGL_NO_CONTEXT;
+};
+
+static void PrintUsage()
+{
+	printf( "Usage: ffgl-bench <plugin.so> [--frames n] [--warmup n] [--size WxH] [--set param=value]... [--sweep param]... [--instances n] [--program-cache dir]\n" );
+}
+
+static bool ParseOptions( int argc, char** argv, BenchOptions& options )
+{
+	for( int i = 1; i < argc; ++i )
+	{
+		std::string arg  = argv[ i ];
+		const char* next = i + 1 < argc ? argv[ i + 1 ] : nullptr;
+		if( arg[ 0 ] != '-' )
+		{
+			options.pluginPath = argv[ i ];
+			continue;
+		}
+		if( next == nullptr )
+			return false;
+
+		if( arg == "--frames" )
+			options.numFrames = (unsigned int)atoi( next );
+		else if( arg == "--warmup" )
+			options.numWarmup = (unsigned int)atoi( next );
+		else if( arg == "--size" )
+		{
+			if( sscanf( next, "%ux%u", &options.width, &options.height ) != 2 )
+				return false;
+		}
+		else if( arg == "--set" )
+		{
+			std::string assignment = next;
+			size_t separator       = assignment.find( '=' );
+			if( separator == std::string::npos )
+				return false;
+			options.setParams.push_back( { (FFUInt32)atoi( assignment.substr( 0, separator ).c_str() ), assignment.substr( separator + 1 ) } );
+		}
+		else if( arg == "--sweep" )
+			options.sweepParams.push_back( (FFUInt32)atoi( next ) );
+		else if( arg == "--instances" )
+			options.numInstances = (unsigned int)atoi( next );
+		else if( arg == "--program-cache" )
+			options.programCacheDirectory = next;
+		else
+			return false;
+		++i;
+	}
+
+	return options.pluginPath != nullptr && options.numFrames > 0 && options.width > 0 && options.height > 0 && options.numInstances > 0;
+}
+
+static void LogFromPlugin( char* message )
+{
+	fprintf( stderr, "plugin log: %s\n", message );
+}
+
+static bool CreateContext( GLContext& gl )
+{
+	//Prefer mesa's surfaceless platform, it doesn't need any display server to be running.
+	PFNEGLGETPLATFORMDISPLAYEXTPROC eglGetPlatformDisplayEXT = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress( "eglGetPlatformDisplayEXT" );
+	if( eglGetPlatformDisplayEXT )
+		gl.display = eglGetPlatformDisplayEXT( EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr );
+	if( gl.display == EGL_NO_DISPLAY )
+		gl.display = eglGetDisplay( EGL_DEFAULT_DISPLAY );
+	if( gl.display == EGL_NO_DISPLAY || !eglInitialize( gl.display, nullptr, nullptr ) )
+		return false;
+
+	if( !eglBindAPI( EGL_OPENGL_API ) )
+		return false;
+
+	//We never render to an egl surface so we don't need a config, the surfaceless platform doesn't even expose any.
+	//Other platforms may require one though.
+	const EGLint configAttributes[] = {
+		EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+		EGL_NONE
+	};
+	EGLConfig config  = EGL_NO_CONFIG_KHR;
+	EGLint numConfigs = 0;
+	if( !eglChooseConfig( gl.display, configAttributes, &config, 1, &numConfigs ) || numConfigs == 0 )
+		config = EGL_NO_CONFIG_KHR;
+
+	//FFGL 2.0 plugins are written against a 4.1 core profile.
+	const EGLint contextAttributes[] = {
+		EGL_CONTEXT_MAJOR_VERSION, 4,
+		EGL_CONTEXT_MINOR_VERSION, 1,
+		EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+		EGL_NONE
+	};
+	gl.context = eglCreateContext( gl.display, config, EGL_NO_CONTEXT, contextAttributes );
+	if( gl.context == EGL_NO_CONTEXT )
+		return false;
+	if( !eglMakeCurrent( gl.display, EGL_NO_SURFACE, EGL_NO_SURFACE, gl.context ) )
+		return false;
+
+	//Glew loads the glx entry points after the core ones, there's no glx display when running surfaceless so that part may fail.
+	glewExperimental  = GL_TRUE;
+	GLenum glewResult = glewInit();
+	return glewResult == GLEW_OK || glewResult == GLEW_ERROR_NO_GLX_DISPLAY;
+}
+
+static void DestroyContext( GLContext& gl )
+{
+	if( gl.display == EGL_NO_DISPLAY )
+		return;
+	eglMakeCurrent( gl.display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT );
+	if( gl.context != EGL_NO_CONTEXT )
+		eglDestroyContext( gl.display, gl.context );
+	eglTerminate( gl.display );
+}
+
+static GLuint CreateTexture( unsigned int width, unsigned int height, unsigned int seed )
+{
+	std::vector< unsigned char > pixels( width * height * 4 );
+	for( unsigned int y = 0; y < height; ++y )
+	{
+		for( unsigned int x = 0; x < width; ++x )
+		{
+			unsigned char* pixel = &pixels[ ( y * width + x ) * 4 ];
+			pixel[ 0 ]           = (unsigned char)( x * 255 / width );
+			pixel[ 1 ]           = (unsigned char)( y * 255 / height );
+			pixel[ 2 ]           = (unsigned char)( seed * 97 );
+			pixel[ 3 ]           = 255;
+		}
+	}
+
+	GLuint texture = 0;
+	glGenTextures( 1, &texture );
+	glBindTexture( GL_TEXTURE_2D, texture );
+	glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data() );
+	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
+	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+	glBindTexture( GL_TEXTURE_2D, 0 );
+	return texture;
+}
+
+static double ToMilliseconds( BenchClock::duration duration )
+{
+	return std::chrono::duration< double, std::milli >( duration ).count();
+}
+
+static double Percentile( const std::vector< double >& sorted, double percentile )
+{
+	size_t index = (size_t)std::ceil( percentile / 100.0 * sorted.size() );
+	return sorted[ std::min( std::max( index, (size_t)1 ), sorted.size() ) - 1 ];
+}
+
+static void SetParameter( FF_Main_FuncPtr plugMain, FFInstanceID instance, FFUInt32 index, const std::string& value )
+{
+	SetParameterStruct setParam;
+	setParam.ParameterNumber = index;
+
+	FFUInt32 type = plugMain( FF_GET_PARAMETER_TYPE, { index }, 0 ).UIntValue;
+	if( type == FF_TYPE_TEXT || type == FF_TYPE_FILE )
+	{
+		setParam.NewParameterValue.PointerValue = (void*)value.c_str();
+	}
+	else
+	{
+		float floatValue = (float)atof( value.c_str() );
+		memcpy( &setParam.NewParameterValue.UIntValue, &floatValue, sizeof( float ) );
+	}
+
+	FFMixed arg;
+	arg.PointerValue = &setParam;
+	if( plugMain( FF_SET_PARAMETER, arg, instance ).UIntValue != FF_SUCCESS )
+		fprintf( stderr, "Failed to set parameter %u\n", index );
+}
+
+static void SetFloatParameter( FF_Main_FuncPtr plugMain, FFInstanceID instance, FFUInt32 index, float value )
+{
+	SetParameterStruct setParam;
+	setParam.ParameterNumber = index;
+	memcpy( &setParam.NewParameterValue.UIntValue, &value, sizeof( float ) );
+
+	FFMixed arg;
+	arg.PointerValue = &setParam;
+	plugMain( FF_SET_PARAMETER, arg, instance );
+}
+
+static void SendSpectrum( FF_Main_FuncPtr plugMain, FFInstanceID instance, const FFTParam& param, const std::vector< float >& spectrum, bool batched )
+{
+	FFMixed arg;
+	if( batched )
+	{
+		SetParameterElementValuesStruct setValues;
+		setValues.ParameterNumber = param.index;
+		setValues.NumElements     = param.numBins;
+		setValues.NewValues       = spectrum.data();
+		arg.PointerValue          = &setValues;
+		plugMain( FF_SET_PARAMETER_ELEMENT_VALUES, arg, instance );
+		return;
+	}
+
+	SetParameterElementValueStruct setValue;
+	setValue.ParameterNumber = param.index;
+	arg.PointerValue         = &setValue;
+	for( FFUInt32 bin = 0; bin < param.numBins; ++bin )
+	{
+		setValue.ElementNumber = bin;
+		memcpy( &setValue.NewParameterValue.UIntValue, &spectrum[ bin ], sizeof( float ) );
+		plugMain( FF_SET_PARAMETER_ELEMENT_VALUE, arg, instance );
+	}
+}
+
+int main( int argc, char** argv )
+{
+	BenchOptions options;
+	if( !ParseOptions( argc, argv, options ) )
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	//The sdk reads the cache directory from the environment when it compiles it's first shader.
+	if( options.programCacheDirectory != nullptr )
+		setenv( "FFGL_PROGRAM_CACHE_DIR", options.programCacheDirectory, 1 );
+
+	void* module = dlopen( options.pluginPath, RTLD_NOW | RTLD_LOCAL );
+	if( module == nullptr )
+	{
+		fprintf( stderr, "Failed to load %s: %s\n", options.pluginPath, dlerror() );
+		return 1;
+	}
+	FF_Main_FuncPtr plugMain = (FF_Main_FuncPtr)dlsym( module, "plugMain" );
+	if( plugMain == nullptr )
+	{
+		fprintf( stderr, "%s doesn't export plugMain\n", options.pluginPath );
+		dlclose( module );
+		return 1;
+	}
+	FF_SetLogCallback_FuncPtr setLogCallback = (FF_SetLogCallback_FuncPtr)dlsym( module, "SetLogCallback" );
+	if( setLogCallback != nullptr )
+		setLogCallback( LogFromPlugin );
+
+	GLContext gl;
+	if( !CreateContext( gl ) )
+	{
+		fprintf( stderr, "Failed to create a surfaceless OpenGL 4.1 context\n" );
+		DestroyContext( gl );
+		dlclose( module );
+		return 1;
+	}
+
+	FFMixed arg;
+	arg.UIntValue = 0;
+	if( plugMain( FF_INITIALISE_V2, arg, 0 ).UIntValue != FF_SUCCESS )
+	{
+		fprintf( stderr, "FF_INITIALISE_V2 failed\n" );
+		DestroyContext( gl );
+		dlclose( module );
+		return 1;
+	}
+
+	const PluginInfoStruct* info = (const PluginInfoStruct*)plugMain( FF_GET_INFO, arg, 0 ).PointerValue;
+	std::string pluginName       = info ? std::string( info->PluginName, strnlen( info->PluginName, sizeof( info->PluginName ) ) ) : "?";
+
+	//Give the plugin the number of inputs it needs, mixers need two, effects one and sources none.
+	arg.UIntValue          = FF_CAP_MINIMUM_INPUT_FRAMES;
+	FFUInt32 minimumInputs = plugMain( FF_GET_PLUGIN_CAPS, arg, 0 ).UIntValue;
+	if( minimumInputs == FF_FAIL )
+		minimumInputs = 0;
+
+	//Setup the host side of things; output fbo and the input textures.
+	GLuint outputTexture = CreateTexture( options.width, options.height, 0 );
+	GLuint hostFBO       = 0;
+	glGenFramebuffers( 1, &hostFBO );
+	glBindFramebuffer( GL_FRAMEBUFFER, hostFBO );
+	glFramebufferTexture2D( GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, outputTexture, 0 );
+	if( glCheckFramebufferStatus( GL_FRAMEBUFFER ) != GL_FRAMEBUFFER_COMPLETE )
+		fprintf( stderr, "Host framebuffer is incomplete\n" );
+	glViewport( 0, 0, options.width, options.height );
+
+	std::vector< FFGLTextureStruct > inputs( minimumInputs );
+	std::vector< FFGLTextureStruct* > inputPointers( minimumInputs );
+	for( FFUInt32 index = 0; index < minimumInputs; ++index )
+	{
+		inputs[ index ].Width          = options.width;
+		inputs[ index ].Height         = options.height;
+		inputs[ index ].HardwareWidth  = options.width;
+		inputs[ index ].HardwareHeight = options.height;
+		inputs[ index ].Handle         = CreateTexture( options.width, options.height, index + 1 );
+		inputPointers[ index ]         = &inputs[ index ];
+	}
+
+	FFGLViewportStruct viewport = { 0, 0, options.width, options.height };
+	arg.PointerValue            = &viewport;
+	glFinish();
+	BenchClock::time_point instantiateStart = BenchClock::now();
+	FFInstanceID instance                   = plugMain( FF_INSTANTIATE_GL, arg, 0 ).PointerValue;
+	glFinish();
+	double instantiateTime = ToMilliseconds( BenchClock::now() - instantiateStart );
+	if( instance == nullptr || instance == (FFInstanceID)(uintptr_t)FF_FAIL )
+	{
+		fprintf( stderr, "FF_INSTANTIATE_GL failed\n" );
+		plugMain( FF_DEINITIALISE, { 0 }, 0 );
+		DestroyContext( gl );
+		dlclose( module );
+		return 1;
+	}
+
+	//The other instances are only created to measure how long it takes to instantiate a plugin that the host already has an instance of.
+	std::vector< FFInstanceID > otherInstances;
+	double otherInstantiateTime = 0.0;
+	for( unsigned int index = 1; index < options.numInstances; ++index )
+	{
+		glFinish();
+		BenchClock::time_point otherStart = BenchClock::now();
+		FFInstanceID otherInstance        = plugMain( FF_INSTANTIATE_GL, arg, 0 ).PointerValue;
+		glFinish();
+		otherInstantiateTime += ToMilliseconds( BenchClock::now() - otherStart );
+		if( otherInstance == nullptr || otherInstance == (FFInstanceID)(uintptr_t)FF_FAIL )
+			fprintf( stderr, "FF_INSTANTIATE_GL failed for instance %u\n", index );
+		else
+			otherInstances.push_back( otherInstance );
+	}
+
+	for( const BenchOptions::ParamValue& param : options.setParams )
+		SetParameter( plugMain, instance, param.index, param.value );
+
+	ProcessOpenGLStruct processStruct;
+	processStruct.numInputTextures = minimumInputs;
+	processStruct.inputTextures    = inputPointers.data();
+	processStruct.HostFBO          = hostFBO;
+
+	std::vector< FFTParam > fftParams;
+	FFUInt32 maxBins   = 0;
+	FFUInt32 numParams = plugMain( FF_GET_NUM_PARAMETERS, { 0 }, 0 ).UIntValue;
+	for( FFUInt32 index = 0; numParams != FF_FAIL && index < numParams; ++index )
+	{
+		if( plugMain( FF_GET_PARAMETER_TYPE, { index }, 0 ).UIntValue != FF_TYPE_BUFFER )
+			continue;
+		if( plugMain( FF_GET_PARAMETER_USAGE, { index }, 0 ).UIntValue != FF_USAGE_FFT )
+			continue;
+		FFUInt32 numBins = plugMain( FF_GET_NUM_PARAMETER_ELEMENTS, { index }, instance ).UIntValue;
+		if( numBins == FF_FAIL || numBins == 0 )
+			continue;
+		fftParams.push_back( { index, numBins } );
+		maxBins = std::max( maxBins, numBins );
+	}
+	bool setBinsBatched = plugMain( FF_GET_PLUGIN_CAPS, { FF_CAP_SET_PARAMETER_ELEMENT_VALUES }, 0 ).UIntValue == FF_TRUE;
+	std::vector< float > spectrum( maxBins );
+
+	//Hosts that support it set all of a frame's automated params with a single FF_SET_PARAMETERS call.
+	bool setParamsBatched = plugMain( FF_GET_PLUGIN_CAPS, { FF_CAP_SET_PARAMETERS }, 0 ).UIntValue == FF_TRUE;
+	std::vector< SetParameterStruct > sweepBatch( options.sweepParams.size() );
+	SetParametersStruct setParameters;
+	setParameters.numParameters = (FFUInt32)sweepBatch.size();
+	setParameters.parameters    = sweepBatch.data();
+
+	std::vector< double > frameTimes;
+	frameTimes.reserve( options.numFrames );
+	unsigned int failedFrames = 0;
+	double time               = 0.0;
+	for( unsigned int frame = 0; frame < options.numWarmup + options.numFrames; ++frame )
+	{
+		//Triangle wave so that automated params hit the full range and change every single frame.
+		float phase      = ( frame % 120 ) / 60.0f;
+		float sweepValue = phase <= 1.0f ? phase : 2.0f - phase;
+		if( setParamsBatched && !sweepBatch.empty() )
+		{
+			for( size_t index = 0; index < sweepBatch.size(); ++index )
+			{
+				sweepBatch[ index ].ParameterNumber = options.sweepParams[ index ];
+				memcpy( &sweepBatch[ index ].NewParameterValue.UIntValue, &sweepValue, sizeof( float ) );
+			}
+			arg.PointerValue = &setParameters;
+			plugMain( FF_SET_PARAMETERS, arg, instance );
+		}
+		else
+		{
+			for( FFUInt32 index : options.sweepParams )
+				SetFloatParameter( plugMain, instance, index, sweepValue );
+		}
+
+		//Falling spectrum with a peak that moves along with the sweep.
+		for( size_t bin = 0; bin < spectrum.size(); ++bin )
+		{
+			float position  = (float)bin / spectrum.size();
+			spectrum[ bin ] = std::max( 0.0f, 1.0f - position - std::fabs( position - sweepValue ) );
+		}
+		for( const FFTParam& fftParam : fftParams )
+			SendSpectrum( plugMain, instance, fftParam, spectrum, setBinsBatched );
+
+		time += 1.0 / 60.0;
+		arg.PointerValue = &time;
+		plugMain( FF_SET_TIME, arg, instance );
+
+		glClear( GL_COLOR_BUFFER_BIT );
+		arg.PointerValue                   = &processStruct;
+		BenchClock::time_point frameStart = BenchClock::now();
+		if( plugMain( FF_PROCESS_OPENGL, arg, instance ).UIntValue != FF_SUCCESS )
+			++failedFrames;
+		//Wait for the gpu to finish so that we're measuring the plugin's actual cost and not just the time spend queueing commands.
+		glFinish();
+		if( frame >= options.numWarmup )
+			frameTimes.push_back( ToMilliseconds( BenchClock::now() - frameStart ) );
+	}
+
+	//Plugins built with a recent sdk can tell us what the instance costs, including the gpu time we can't measure from here.
+	bool hasInstanceStats = plugMain( FF_GET_PLUGIN_CAPS, { FF_CAP_INSTANCE_STATS }, 0 ).UIntValue == FF_TRUE;
+	InstanceStatsStruct instanceStats;
+	if( hasInstanceStats )
+	{
+		arg.PointerValue = &instanceStats;
+		hasInstanceStats = plugMain( FF_GET_INSTANCE_STATS, arg, instance ).UIntValue == FF_SUCCESS;
+	}
+
+	for( FFInstanceID otherInstance : otherInstances )
+		plugMain( FF_DEINSTANTIATE_GL, { 0 }, otherInstance );
+	plugMain( FF_DEINSTANTIATE_GL, { 0 }, instance );
+	plugMain( FF_DEINITIALISE, { 0 }, 0 );
+
+	for( const FFGLTextureStruct& input : inputs )
+		glDeleteTextures( 1, &input.Handle );
+	glBindFramebuffer( GL_FRAMEBUFFER, 0 );
+	glDeleteFramebuffers( 1, &hostFBO );
+	glDeleteTextures( 1, &outputTexture );
+
+	std::vector< double > sorted = frameTimes;
+	std::sort( sorted.begin(), sorted.end() );
+	double total = 0.0;
+	for( double frameTime : frameTimes )
+		total += frameTime;
+
+	printf( "plugin:      %s (%s)\n", pluginName.c_str(), options.pluginPath );
+	printf( "renderer:    %s\n", (const char*)glGetString( GL_RENDERER ) );
+	printf( "resolution:  %ux%u, %u input(s)\n", options.width, options.height, minimumInputs );
+	printf( "instantiate: %.3f ms\n", instantiateTime );
+	if( options.numInstances > 1 )
+		printf( "instances:   %u, %.3f ms mean instantiate after the first\n", options.numInstances, otherInstantiateTime / ( options.numInstances - 1 ) );
+	printf( "frames:      %u (+%u warmup, %u failed)\n", options.numFrames, options.numWarmup, failedFrames );
+	if( !fftParams.empty() )
+		printf( "fft:         %u param(s), %s\n", (unsigned int)fftParams.size(), setBinsBatched ? "one FF_SET_PARAMETER_ELEMENT_VALUES call per param" : "one FF_SET_PARAMETER_ELEMENT_VALUE call per bin" );
+	if( !options.sweepParams.empty() )
+		printf( "sweep:       %u param(s), %s\n", (unsigned int)options.sweepParams.size(), setParamsBatched ? "one FF_SET_PARAMETERS call per frame" : "one FF_SET_PARAMETER call per param" );
+	printf( "frame ms:    mean %.3f  p50 %.3f  p95 %.3f  p99 %.3f  max %.3f\n",
+			total / sorted.size(),
+			Percentile( sorted, 50.0 ),
+			Percentile( sorted, 95.0 ),
+			Percentile( sorted, 99.0 ),
+			sorted.back() );
+	if( hasInstanceStats )
+	{
+		float cpuTotal = 0.0f;
+		float gpuTotal = 0.0f;
+		for( FFUInt32 index = 0; index < instanceStats.numCpuFrames; ++index )
+			cpuTotal += instanceStats.cpuMilliseconds[ index ];
+		for( FFUInt32 index = 0; index < instanceStats.numGpuFrames; ++index )
+			gpuTotal += instanceStats.gpuMilliseconds[ index ];
+		printf( "plugin ms:   cpu %.3f  gpu %.3f (mean of the last %u/%u frames)\n",
+				instanceStats.numCpuFrames > 0 ? cpuTotal / instanceStats.numCpuFrames : 0.0f,
+				instanceStats.numGpuFrames > 0 ? gpuTotal / instanceStats.numGpuFrames : 0.0f,
+				instanceStats.numCpuFrames,
+				instanceStats.numGpuFrames );
+		printf( "resources:   %u gl object(s), %llu bytes uploaded, %llu heap bytes\n",
+				instanceStats.numGLObjects,
+				(unsigned long long)instanceStats.numUploadedBytes,
+				(unsigned long long)instanceStats.numHeapBytes );
+	}
+
+	DestroyContext( gl );
+	dlclose( module );
+	return failedFrames == 0 ? 0 : 1;
+}
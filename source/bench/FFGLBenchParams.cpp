@@ -0,0 +1,149 @@
+/**
+ * ffgl-bench-params measures how long it takes CFFGLPluginManager to look up parameters. Nearly every parameter
+ * related plugMain call needs to find the param by it's id, so a host that sweeps all metadata of a plugin at load time
+ * does this (number of params * number of queries) times.
+ *
+ * For each param count it reports the cost of a single lookup and of a full metadata sweep like the one hosts do
+ * when loading a plugin. Params are registered with consecutive ids (the dense table) and with ids that are
+ * spread out far apart (the sparse map).
+ *
+ * Usage: ffgl-bench-params [--repeat n]
+ *   --repeat <n>         Number of times each measurement is repeated, the fastest run is reported (default 20).
+ */
+#include <ffgl/FFGLPluginManager.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+typedef std::chrono::steady_clock BenchClock;
+
+/**
+ * Bare plugin manager with nothing but a configurable number of params.
+ */
+class ParamTable : public CFFGLPluginManager
+{
+public:
+	ParamTable( unsigned int numParams, unsigned int idStride )
+	{
+		for( unsigned int index = 0; index < numParams; ++index )
+		{
+			unsigned int id  = index * idStride;
+			std::string name = "Param " + std::to_string( index );
+			SetParamInfo( id, name.c_str(), FF_TYPE_STANDARD, 0.5f );
+			SetParamRange( id, 0.0f, 1.0f );
+			ids.push_back( id );
+		}
+	}
+
+	bool HasParam( unsigned int id ) const
+	{
+		return GetParamInfo( id ) != nullptr;
+	}
+
+	std::vector< unsigned int > ids;//!< The ids of all registered params, in registration order.
+};
+
+static double ToNanoseconds( BenchClock::duration duration )
+{
+	return std::chrono::duration< double, std::nano >( duration ).count();
+}
+
+/**
+ * Looks up every param lots of times, returns the fastest run's average time per lookup in nanoseconds.
+ */
+static double MeasureLookup( const ParamTable& table, unsigned int numRepeats )
+{
+	//Visit the params in a scattered order so that we're not just measuring a linear scan hitting the front of the list.
+	std::vector< unsigned int > order = table.ids;
+	for( size_t index = 0; index < order.size(); ++index )
+		std::swap( order[ index ], order[ ( index * 7919 ) % order.size() ] );
+
+	const unsigned int numLookups = 1000000;
+	double fastest                = 0.0;
+	unsigned int numFound         = 0;
+	for( unsigned int repeat = 0; repeat < numRepeats; ++repeat )
+	{
+		BenchClock::time_point start = BenchClock::now();
+		for( unsigned int lookup = 0; lookup < numLookups; ++lookup )
+			numFound += table.HasParam( order[ lookup % order.size() ] ) ? 1 : 0;
+		double time = ToNanoseconds( BenchClock::now() - start ) / numLookups;
+		fastest     = repeat == 0 ? time : std::min( fastest, time );
+	}
+
+	if( numFound != numLookups * numRepeats )
+		fprintf( stderr, "Not all params were found\n" );
+	return fastest;
+}
+
+/**
+ * Queries the same metadata that a host queries for each param while loading a plugin,
+ * returns the fastest run's time in microseconds.
+ */
+static double MeasureSweep( ParamTable& table, unsigned int numRepeats )
+{
+	double fastest      = 0.0;
+	unsigned int result = 0;
+	for( unsigned int repeat = 0; repeat < numRepeats; ++repeat )
+	{
+		BenchClock::time_point start = BenchClock::now();
+		for( unsigned int id : table.ids )
+		{
+			result += table.GetParamName( id ) != nullptr ? 1 : 0;
+			result += table.GetParamType( id );
+			result += table.GetParamDefault( id ).UIntValue;
+			result += (unsigned int)table.GetParamRange( id ).max;
+			result += (unsigned int)table.GetParamGroup( id ).size();
+			result += (unsigned int)table.GetParamDisplayName( id ).size();
+			result += table.GetParamVisibility( id );
+			result += table.GetNumParamElements( id );
+		}
+		double time = ToNanoseconds( BenchClock::now() - start ) / 1000.0;
+		fastest     = repeat == 0 ? time : std::min( fastest, time );
+	}
+
+	//Make sure the compiler can't throw away the queries.
+	if( result == 0 )
+		fprintf( stderr, "Sweep didn't query anything\n" );
+	return fastest;
+}
+
+int main( int argc, char** argv )
+{
+	unsigned int numRepeats = 20;
+	for( int i = 1; i < argc; ++i )
+	{
+		std::string arg = argv[ i ];
+		if( arg == "--repeat" && i + 1 < argc )
+			numRepeats = std::max( atoi( argv[ ++i ] ), 1 );
+		else
+		{
+			printf( "Usage: ffgl-bench-params [--repeat n]\n" );
+			return 1;
+		}
+	}
+
+	struct Layout
+	{
+		const char* name;
+		unsigned int idStride;
+	};
+	const Layout layouts[]           = { { "dense", 1 }, { "sparse", 1000 } };
+	const unsigned int paramCounts[] = { 10, 200, 2000 };
+
+	printf( "%-8s %8s %12s %12s\n", "ids", "params", "lookup ns", "sweep us" );
+	for( const Layout& layout : layouts )
+	{
+		for( unsigned int numParams : paramCounts )
+		{
+			ParamTable table( numParams, layout.idStride );
+			double lookupTime = MeasureLookup( table, numRepeats );
+			double sweepTime  = MeasureSweep( table, numRepeats );
+			printf( "%-8s %8u %12.2f %12.2f\n", layout.name, numParams, lookupTime, sweepTime );
+		}
+	}
+
+	return 0;
+}
@@ -7,8 +7,17 @@
 #include "ffgl/FFGLPluginSDK.cpp"
 #include "ffgl/FFGLThumbnailInfo.cpp"
 #include "ffgl/FFGLLog.cpp"
+#include "ffgl/FFGLStateValidation.cpp"
+#include "ffgl/FFGLInstanceStats.cpp"
+#include "ffgl/FFGLGpuTimer.cpp"
+#include "ffgl/FFGLTrace.cpp"
 
+#include "ffglex/FFGLAsyncReadback.cpp"
 #include "ffglex/FFGLFBO.cpp"
+#include "ffglex/FFGLFullScreenPass.cpp"
+#include "ffglex/FFGLProgramCache.cpp"
+#include "ffglex/FFGLProgramRegistry.cpp"
+#include "ffglex/FFGLRenderTargetPool.cpp"
 #include "ffglex/FFGLScopedBufferBinding.cpp"
 #include "ffglex/FFGLScopedFBOBinding.cpp"
 #include "ffglex/FFGLScopedRenderBufferBinding.cpp"
@@ -18,6 +27,8 @@
 #include "ffglex/FFGLScopedVAOBinding.cpp"
 #include "ffglex/FFGLScreenQuad.cpp"
 #include "ffglex/FFGLShader.cpp"
+#include "ffglex/FFGLStateCache.cpp"
+#include "ffglex/FFGLStreamingTexture.cpp"
 #include "ffglex/FFGLUtilities.cpp"
 
 #include "ffglquickstart/FFGLAudio.cpp"
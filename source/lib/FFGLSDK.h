@@ -4,8 +4,19 @@
 #include "ffgl/FFGLPluginSDK.h"
 #include "ffgl/FFGLThumbnailInfo.h"
 #include "ffgl/FFGLLog.h"
+#include "ffgl/FFGLStateValidation.h"
+#include "ffgl/FFGLInstanceStats.h"
+#include "ffgl/FFGLGpuTimer.h"
+#include "ffgl/FFGLTrace.h"
+#include "ffgl/FFGLParamTable.h"
 
+#include "ffglex/FFGLAsyncReadback.h"
 #include "ffglex/FFGLFBO.h"
+#include "ffglex/FFGLFullScreenPass.h"
+#include "ffglex/FFGLGpuTimer.h"
+#include "ffglex/FFGLProgramCache.h"
+#include "ffglex/FFGLProgramRegistry.h"
+#include "ffglex/FFGLRenderTargetPool.h"
 #include "ffglex/FFGLScopedBufferBinding.h"
 #include "ffglex/FFGLScopedSamplerActivation.h"
 #include "ffglex/FFGLScopedShaderBinding.h"
@@ -13,6 +24,8 @@
 #include "ffglex/FFGLScopedVAOBinding.h"
 #include "ffglex/FFGLScreenQuad.h"
 #include "ffglex/FFGLShader.h"
+#include "ffglex/FFGLStateCache.h"
+#include "ffglex/FFGLStreamingTexture.h"
 #include "ffglex/FFGLUtilities.h"
 
 #include "ffglquickstart/FFGLAudio.h"
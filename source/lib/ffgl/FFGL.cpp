@@ -80,6 +80,8 @@
 #include "FFGLPluginSDK.h"
 #include "FFGLThumbnailInfo.h"
 #include "FFGLLog.h"
+#include "FFGLStateValidation.h"
+#include "FFGLTrace.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Static and extern variables used in the FreeFrame SDK
@@ -95,6 +97,7 @@ static CFFGLPlugin* s_pPrototype = nullptr;
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 void ValidateContextState();
+void ValidateFrameContextState( GLuint hostFBO, bool queryContext );
 
 bool InitGLExts()
 {
@@ -109,6 +112,20 @@ bool InitGLExts()
 		return false;
 	initResult = true;
 	return initResult;
+#elif defined( FFGL_LINUX )
+	static bool triedInit  = false;
+	static bool initResult = false;
+	if( triedInit )
+		return initResult;
+	triedInit = true;
+
+	//Glew also tries to load the glx entry points after the gl ones. Hosts rendering through egl don't have a glx display,
+	//in which case this fails but all the gl entry points we need have been loaded already.
+	GLenum glewResult = glewInit();
+	if( glewResult != GLEW_OK && glewResult != GLEW_ERROR_NO_GLX_DISPLAY )
+		return false;
+	initResult = true;
+	return initResult;
 #else
 	return true;
 #endif
@@ -123,6 +140,9 @@ FFResult initialise()
 	if( g_CurrPluginInfo == NULL )
 		return FF_FAIL;
 
+	//Tracing may be enabled by the host's environment, start it before the plugin gets to run any code.
+	FFGLTrace::StartFromEnvironment( std::string( g_CurrPluginInfo->GetPluginInfo()->PluginUniqueID, 4 ) );
+
 	//Allow the plugin to initialise itself before we do anything with it. This allows it
 	//to execute some setup code that it'll only ever need to do once.
 	if( FPINITIALISELIBRARY* pInitialise = g_CurrPluginInfo->GetInitialiseMethod() )
@@ -144,6 +164,8 @@ FFResult initialise()
 		if( ( ret == FF_FAIL ) || ( s_pPrototype == NULL ) )
 			return FF_FAIL;
 
+		//The prototype's params become the schema that's shared with all instances.
+		s_pPrototype->FinishParamRegistration();
 		return FF_SUCCESS;
 	}
 
@@ -159,12 +181,18 @@ FFResult deInitialise()
 		delete s_pPrototype;
 		s_pPrototype = NULL;
 	}
+	CFFGLPluginManager::ReleaseSharedParamSchema();
 
 	//Allow the plugin to initialise itself before we do anything with it. This allows it
 	//to execute some setup code that it'll only ever need to do once.
 	if( FPDEINITIALISELIBRARY* pDeinitialise = g_CurrPluginInfo->GetDeinitialiseMethod() )
 		pDeinitialise();
 
+	//The host may unload us after this call, so this is the last chance to write the trace and deliver the queued log messages
+	//while it's safe to wait for the background threads.
+	FFGLTrace::Stop();
+	FFGLLog::Stop();
+
 	return FF_SUCCESS;
 }
 unsigned int getNumParameters()
@@ -235,6 +263,11 @@ FFResult getPluginCaps( unsigned int index )
 			return FF_TRUE;
 		else
 			return FF_FALSE;
+	case FF_CAP_SET_PARAMETERS:
+	case FF_CAP_SET_PARAMETER_ELEMENT_VALUES:
+	case FF_CAP_INSTANCE_STATS:
+		//The sdk implements these for every plugin, CFFGLPlugin provides a default implementation of SetParameters.
+		return FF_TRUE;
 
 	default:
 		return FF_FALSE;
@@ -283,6 +316,7 @@ void* instantiateGL( const FFGLViewportStruct* pGLViewport )
 	if( ( dwRet == FF_FAIL ) || ( pInstance == NULL ) )
 		return (void*)FF_FAIL;
 
+	pInstance->FinishParamRegistration();
 	pInstance->m_pPlugin = pInstance;
 
 	// Initializing instance with default values
@@ -335,6 +369,8 @@ void* instantiateGL( const FFGLViewportStruct* pGLViewport )
 	if( !InitGLExts() )
 		return (void*)FF_FAIL;
 
+	//Everything InitGL uploads and creates is reported to this instance's stats.
+	ScopedInstanceStats instanceStats( &pInstance->instanceStats );
 	//The host should pass us a context in it's default state.
 	ValidateContextState();
 	//call the InitGL method
@@ -361,6 +397,7 @@ FFResult processGL( CFFGLPlugin* pPlugObj, ProcessOpenGLStruct* pogls )
 	{
 		if( pogls != NULL )
 		{
+			ScopedInstanceStats instanceStats( &pPlugObj->instanceStats );
 			// make sure Connect has been called
 			if( !pPlugObj->m_isConnected )
 			{
@@ -369,10 +406,14 @@ FFResult processGL( CFFGLPlugin* pPlugObj, ProcessOpenGLStruct* pogls )
 			}
 
 			//The host should pass us a context in it's default state.
-			ValidateContextState();
+			bool queryContext = FFGLStateValidation::ShouldQueryContext();
+			FFGLStateValidation::BeginFrame( pogls->HostFBO );
+			ValidateFrameContextState( pogls->HostFBO, queryContext );
+			pPlugObj->instanceStats.BeginFrame();
 			FFResult result = pPlugObj->ProcessOpenGL( pogls );
+			pPlugObj->instanceStats.EndFrame();
 			//The plugin should return the context to it's default state.
-			ValidateContextState();
+			ValidateFrameContextState( pogls->HostFBO, queryContext );
 			return result;
 		}
 		else
@@ -400,7 +441,9 @@ FFResult deInstantiateGL( void* instanceID )
 
 		//The host should pass us a context in it's default state.
 		ValidateContextState();
+		ScopedInstanceStats instanceStats( &p->instanceStats );
 		p->DeInitGL();
+		p->instanceStats.ReleaseGLResources();
 		//The plugin should return the context to it's default state.
 		ValidateContextState();
 		delete p;
@@ -630,6 +673,9 @@ extern "C" __declspec( dllexport ) FFMixed __stdcall plugMain( FFUInt32 function
 FFMixed plugMain( FFUInt32 functionCode, FFMixed inputValue, FFInstanceID instanceID )
 #endif
 {
+	//Records how long this call takes when tracing is enabled, otherwise this only checks whether it is.
+	FFGLTraceZone traceZone( functionCode, instanceID );
+
 	FFMixed retval;
 	retval.UIntValue = FF_FAIL;
 
@@ -686,6 +732,20 @@ FFMixed plugMain( FFUInt32 functionCode, FFMixed inputValue, FFInstanceID instan
 			retval.UIntValue = FF_FAIL;
 		}
 		break;
+	case FF_SET_PARAMETERS:
+		if( pPlugObj != NULL && inputValue.PointerValue != NULL )
+		{
+			const SetParametersStruct& setParametersStruct = *reinterpret_cast< const SetParametersStruct* >( inputValue.PointerValue );
+			if( setParametersStruct.numParameters == 0 || setParametersStruct.parameters != NULL )
+				retval.UIntValue = pPlugObj->SetParameters( setParametersStruct.parameters, setParametersStruct.numParameters );
+			else
+				retval.UIntValue = FF_FAIL;
+		}
+		else
+		{
+			retval.UIntValue = FF_FAIL;
+		}
+		break;
 	case FF_GET_PARAMETER:
 		if( pPlugObj != NULL )
 		{
@@ -801,6 +861,7 @@ FFMixed plugMain( FFUInt32 functionCode, FFMixed inputValue, FFInstanceID instan
 	case FF_RESIZE:
 		if( pPlugObj != NULL )
 		{
+			ScopedInstanceStats instanceStats( &pPlugObj->instanceStats );
 			retval.UIntValue = pPlugObj->Resize( (const FFGLViewportStruct*)inputValue.PointerValue );
 		}
 		else
@@ -808,6 +869,17 @@ FFMixed plugMain( FFUInt32 functionCode, FFMixed inputValue, FFInstanceID instan
 			retval.UIntValue = FF_FAIL;
 		}
 		break;
+	case FF_GET_INSTANCE_STATS:
+		if( pPlugObj != NULL && inputValue.PointerValue != NULL )
+		{
+			pPlugObj->GetInstanceStats( *(InstanceStatsStruct*)inputValue.PointerValue );
+			retval.UIntValue = FF_SUCCESS;
+		}
+		else
+		{
+			retval.UIntValue = FF_FAIL;
+		}
+		break;
 	case FF_GET_NUM_PARAMETER_ELEMENTS:
 		retval.UIntValue = getNumParameterElements( inputValue.UIntValue, pPlugObj );
 		break;
@@ -837,6 +909,17 @@ FFMixed plugMain( FFUInt32 functionCode, FFMixed inputValue, FFInstanceID instan
 			retval.UIntValue                                = pPlugObj->SetParamElementValue( arguments->ParameterNumber, arguments->ElementNumber, *(float*)&arguments->NewParameterValue.UIntValue );
 		}
 		break;
+	case FF_SET_PARAMETER_ELEMENT_VALUES:
+		if( pPlugObj != NULL && inputValue.PointerValue != NULL )
+		{
+			const SetParameterElementValuesStruct* arguments = (const SetParameterElementValuesStruct*)inputValue.PointerValue;
+			retval.UIntValue                                 = pPlugObj->SetParamElementValues( arguments->ParameterNumber, arguments->NewValues, arguments->NumElements );
+		}
+		else
+		{
+			retval.UIntValue = FF_FAIL;
+		}
+		break;
 	case FF_GET_PARAMETER_USAGE:
 		retval.UIntValue = getParameterUsage( inputValue.UIntValue );
 		break;
@@ -1098,3 +1181,47 @@ void ValidateContextState()
 	assert( glBool[ 3 ] == GL_TRUE );
 #endif
 }
+/**
+ * Querying all of the context's state on every frame stalls the driver so often that debug builds become useless for
+ * measuring performance. On most frames we only validate the shadow of the bindings that's kept by the scoped bindings,
+ * which doesn't need any gl calls. See FFGLStateValidation::SetQueryInterval for how often the context is queried. On those frames
+ * we also check that the shadow matches the context, as the shadow can't see bindings that were changed with direct gl calls.
+ *
+ * @param hostFBO: The fbo the host had bound when it called ProcessOpenGL, which has to be bound again when we return.
+ * @param queryContext: Whether or not to query the context, the result of FFGLStateValidation::ShouldQueryContext.
+ */
+void ValidateFrameContextState( GLuint hostFBO, bool queryContext )
+{
+#if defined( FFGL_DEBUG )
+	//Please use the scoped bindings and dont keep them alive after returning to the host.
+	assert( FFGLStateValidation::IsDefaultState( hostFBO ) );
+	if( !queryContext )
+		return;
+
+	struct ShadowBinding
+	{
+		GLenum binding;
+		FFGLStateValidation::Binding shadowBinding;
+	};
+	const std::array< ShadowBinding, 6 > SHADOW_BINDINGS = {
+		ShadowBinding{ GL_CURRENT_PROGRAM, FFGLStateValidation::BINDING_PROGRAM },
+		ShadowBinding{ GL_VERTEX_ARRAY_BINDING, FFGLStateValidation::BINDING_VAO },
+		ShadowBinding{ GL_RENDERBUFFER_BINDING, FFGLStateValidation::BINDING_RENDERBUFFER },
+		ShadowBinding{ GL_ACTIVE_TEXTURE, FFGLStateValidation::BINDING_ACTIVE_TEXTURE },
+		ShadowBinding{ GL_DRAW_FRAMEBUFFER_BINDING, FFGLStateValidation::BINDING_DRAW_FBO },
+		ShadowBinding{ GL_READ_FRAMEBUFFER_BINDING, FFGLStateValidation::BINDING_READ_FBO }
+	};
+	for( const auto& shadowBinding : SHADOW_BINDINGS )
+	{
+		//This binding has been changed with a direct gl call and hasn't been restored. Please use the scoped bindings.
+		GLint binding;
+		glGetIntegerv( shadowBinding.binding, &binding );
+		assert( (GLuint)binding == FFGLStateValidation::GetBinding( shadowBinding.shadowBinding ) );
+	}
+
+	ValidateContextState();
+#else
+	(void)hostFBO;
+	(void)queryContext;
+#endif
+}
@@ -364,7 +364,10 @@ static const FFUInt32 FF_GET_PRAMETER_VISIBILITY           = 45;
 static const FFUInt32 FF_GET_PARAMETER_EVENTS              = 46;
 static const FFUInt32 FF_GET_NUM_ELEMENT_SEPARATORS        = 47;
 static const FFUInt32 FF_GET_SEPARATOR_ELEMENT_INDEX       = 48;
-//Next ID = 52
+static const FFUInt32 FF_SET_PARAMETERS                    = 52;
+static const FFUInt32 FF_SET_PARAMETER_ELEMENT_VALUES      = 53;
+static const FFUInt32 FF_GET_INSTANCE_STATS                = 54;
+//Next ID = 55
 
 //Previously used function codes that are no longer in use. Should prevent using
 //these numbers for new function codes.
@@ -400,6 +403,9 @@ static const FFUInt32 FF_CAP_SET_TIME                     = 5;
 static const FFUInt32 FF_CAP_MINIMUM_INPUT_FRAMES         = 10;
 static const FFUInt32 FF_CAP_MAXIMUM_INPUT_FRAMES         = 11;
 static const FFUInt32 FF_CAP_TOP_LEFT_TEXTURE_ORIENTATION = 16;
+static const FFUInt32 FF_CAP_SET_PARAMETERS               = 17;
+static const FFUInt32 FF_CAP_SET_PARAMETER_ELEMENT_VALUES = 18;
+static const FFUInt32 FF_CAP_INSTANCE_STATS               = 19;
 //Previously used capability codes that are no longer in use. New codes should prevent using
 //these numbers for new capability codes.
 //static const FFUInt32 FF_CAP_16BITVIDEO         = 0;
@@ -491,6 +497,13 @@ typedef struct SetParameterStructTag
 	FFMixed NewParameterValue;
 } SetParameterStruct;
 
+// SetParametersStruct, used by FF_SET_PARAMETERS to set multiple parameters with a single call.
+typedef struct SetParametersStructTag
+{
+	FFUInt32 numParameters;              //!< The number of entries in the parameters array.
+	const SetParameterStruct* parameters;//!< The parameters to set, they're applied in order.
+} SetParametersStruct;
+
 // SetBeatinfoStruct
 typedef struct SetBeatinfoStructTag
 {
@@ -590,6 +603,14 @@ typedef struct SetParameterElementValueStructTag
 	FFMixed NewParameterValue;
 } SetParameterElementValueStruct;
 
+// SetParameterElementValuesStruct, used by FF_SET_PARAMETER_ELEMENT_VALUES to replace the values of a buffer parameter's elements with a single call.
+typedef struct SetParameterElementValuesStructTag
+{
+	FFUInt32 ParameterNumber;
+	FFUInt32 NumElements;  //!< The number of values in NewValues. May be less than the parameter's number of elements, the remaining elements are left unchanged.
+	const float* NewValues;//!< The new values of the elements, starting at element 0.
+} SetParameterElementValuesStruct;
+
 // GetSeparatorElementIndexStruct
 typedef struct GetSeparatorElementIndexStructTag
 {
@@ -615,6 +636,19 @@ typedef struct GetParamEventsStructTag
 	ParamEventStruct* events;//!< Buffer into which the plugin will write it's pending events.
 } GetParamEventsStruct;
 
+// InstanceStatsStruct, filled by FF_GET_INSTANCE_STATS with what an instance costs to run. Frame times are ordered from oldest to newest.
+static const FFUInt32 FF_INSTANCE_STATS_NUM_FRAMES = 16;//The number of frames of which the stats keep the cpu and gpu time.
+typedef struct InstanceStatsStructTag
+{
+	FFUInt32 numCpuFrames;                                //!< The number of valid entries in cpuMilliseconds.
+	float cpuMilliseconds[ FF_INSTANCE_STATS_NUM_FRAMES ];//!< The cpu time of the most recent ProcessOpenGL calls.
+	FFUInt32 numGpuFrames;                                //!< The number of valid entries in gpuMilliseconds. Stays 0 if the driver doesn't support timestamp queries.
+	float gpuMilliseconds[ FF_INSTANCE_STATS_NUM_FRAMES ];//!< The gpu time of the most recent ProcessOpenGL calls that the gpu has finished, these lag a frame or two behind.
+	FFUInt64 numUploadedBytes;                            //!< The number of bytes the instance has uploaded to textures and buffers since it was instantiated.
+	FFUInt32 numGLObjects;                                //!< The number of gl objects the instance currently holds.
+	FFUInt64 numHeapBytes;                                //!< The heap memory the instance currently holds, in bytes.
+} InstanceStatsStruct;
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Function prototypes
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -651,9 +685,15 @@ typedef void ( *PFNLog )( char* cStr );
 typedef FFMixed ( *FF_Main_FuncPtr )( FFUInt32, FFMixed, FFInstanceID );
 typedef void ( *FF_SetLogCallback_FuncPtr )( PFNLog );
 
+#if defined( FFGL_LINUX )
+//The sdk and plugins are built with hidden visibility, these are the only symbols the host should see.
+__attribute__( ( visibility( "default" ) ) ) FFMixed plugMain( FFUInt32 functionCode, FFMixed inputValue, FFInstanceID instanceID );
+__attribute__( ( visibility( "default" ) ) ) void SetLogCallback( PFNLog logCallback );
+#else
 FFMixed plugMain( FFUInt32 functionCode, FFMixed inputValue, FFInstanceID instanceID );
 void SetLogCallback( PFNLog logCallback );
 #endif
+#endif
 
 #if !defined( FFGL_WINDOWS )
 }//extern "C"
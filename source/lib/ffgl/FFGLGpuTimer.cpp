@@ -0,0 +1,183 @@
+#include "FFGLGpuTimer.h"
+#include <assert.h>
+#include <algorithm>
+#include "FFGLInstanceStats.h"
+
+FFGLGpuTimer::FFGLGpuTimer( const std::string& name ) :
+	name( name ),
+	nextQuery( 0 ),
+	oldestQuery( 0 ),
+	isMeasuring( false )
+{
+	ResetStats();
+}
+FFGLGpuTimer::~FFGLGpuTimer()
+{
+	//If this assertion hits you forgot to release this timer.
+	assert( queries.empty() );
+}
+
+/**
+ * Create the queries. This function needs to be called using an active OpenGL context, for example in your plugin's InitGL function.
+ * Measuring is optional, so it's fine to keep on rendering when this fails.
+ *
+ * @param numQueryPairs: The number of zones that can be waiting for the gpu, before zones aren't measured.
+ * @return: Whether or not the driver supports timestamps. If it doesn't, zones aren't measured.
+ */
+bool FFGLGpuTimer::Initialise( unsigned int numQueryPairs )
+{
+	if( !queries.empty() )
+		return true;
+
+	GLint numCounterBits = 0;
+	glGetQueryiv( GL_TIMESTAMP, GL_QUERY_COUNTER_BITS, &numCounterBits );
+	if( numCounterBits == 0 || numQueryPairs == 0 )
+		return false;
+
+	std::vector< GLuint > queryIDs( numQueryPairs * 2 );
+	glGenQueries( (GLsizei)queryIDs.size(), queryIDs.data() );
+	FFGLInstanceStats::AddGLObjects( (int)queryIDs.size() );
+	for( unsigned int index = 0; index < numQueryPairs; ++index )
+	{
+		QueryPair queryPair;
+		queryPair.beginQueryID = queryIDs[ index * 2 ];
+		queryPair.endQueryID   = queryIDs[ index * 2 + 1 ];
+		queryPair.isPending    = false;
+		queries.push_back( queryPair );
+	}
+	nextQuery   = 0;
+	oldestQuery = 0;
+	return true;
+}
+/**
+ * Release the queries, zones that are still waiting for the gpu aren't measured. Call this before destruction if you've
+ * previously initialised us, usually from your plugin's DeInitGL.
+ */
+void FFGLGpuTimer::Release()
+{
+	for( QueryPair& queryPair : queries )
+	{
+		glDeleteQueries( 1, &queryPair.beginQueryID );
+		glDeleteQueries( 1, &queryPair.endQueryID );
+	}
+	FFGLInstanceStats::AddGLObjects( -(int)queries.size() * 2 );
+	queries.clear();
+	isMeasuring = false;
+}
+
+/**
+ * Start measuring a zone by recording a timestamp. This also reads the results of the zones the gpu has finished.
+ */
+void FFGLGpuTimer::Begin()
+{
+	if( queries.empty() )
+		return;
+
+	//If this assertion hits you've started a zone of this timer without ending the previous one.
+	assert( !isMeasuring );
+	ReadFinishedQueries();
+
+	QueryPair& queryPair = queries[ nextQuery ];
+	if( queryPair.isPending )
+	{
+		stats.numDroppedSamples++;
+		return;
+	}
+	glQueryCounter( queryPair.beginQueryID, GL_TIMESTAMP );
+	isMeasuring = true;
+}
+/**
+ * Stop measuring the zone by recording a timestamp. It's result can be read once the gpu has written the timestamp.
+ */
+void FFGLGpuTimer::End()
+{
+	if( !isMeasuring )
+		return;
+
+	QueryPair& queryPair = queries[ nextQuery ];
+	glQueryCounter( queryPair.endQueryID, GL_TIMESTAMP );
+	queryPair.isPending = true;
+	nextQuery           = ( nextQuery + 1 ) % queries.size();
+	isMeasuring         = false;
+}
+
+const std::string& FFGLGpuTimer::GetName() const
+{
+	return name;
+}
+/**
+ * The stats of all zones of which the results have been read so far. Results are read when a zone begins, so the
+ * stats lag a frame or two behind the zones you've recorded.
+ */
+FFGLGpuTimer::Stats FFGLGpuTimer::GetStats() const
+{
+	return stats;
+}
+/**
+ * Called for every zone of which the result has been read, in the order the zones were recorded. Override this if you need
+ * the time of each zone rather than the stats, which is what FFGLInstanceStats does to keep it's history of frames.
+ */
+void FFGLGpuTimer::OnZoneMeasured( double /*milliseconds*/ )
+{
+}
+void FFGLGpuTimer::ResetStats()
+{
+	stats.numSamples          = 0;
+	stats.numDroppedSamples   = 0;
+	stats.lastMilliseconds    = 0.0;
+	stats.averageMilliseconds = 0.0;
+	stats.minMilliseconds     = 0.0;
+	stats.maxMilliseconds     = 0.0;
+	totalMilliseconds         = 0.0;
+}
+
+void FFGLGpuTimer::ReadFinishedQueries()
+{
+	//The gpu finishes the queries in the order we've recorded them, so we can stop at the first one that isn't available.
+	while( queries[ oldestQuery ].isPending )
+	{
+		QueryPair& queryPair = queries[ oldestQuery ];
+		GLint isAvailable    = GL_FALSE;
+		glGetQueryObjectiv( queryPair.endQueryID, GL_QUERY_RESULT_AVAILABLE, &isAvailable );
+		if( isAvailable == GL_FALSE )
+			return;
+
+		GLuint64 beginTime = 0;
+		GLuint64 endTime   = 0;
+		glGetQueryObjectui64v( queryPair.beginQueryID, GL_QUERY_RESULT, &beginTime );
+		glGetQueryObjectui64v( queryPair.endQueryID, GL_QUERY_RESULT, &endTime );
+		queryPair.isPending = false;
+		oldestQuery         = ( oldestQuery + 1 ) % queries.size();
+
+		double milliseconds    = endTime > beginTime ? ( endTime - beginTime ) / 1000000.0 : 0.0;
+		stats.minMilliseconds  = stats.numSamples == 0 ? milliseconds : std::min( stats.minMilliseconds, milliseconds );
+		stats.maxMilliseconds  = stats.numSamples == 0 ? milliseconds : std::max( stats.maxMilliseconds, milliseconds );
+		stats.lastMilliseconds = milliseconds;
+		totalMilliseconds += milliseconds;
+		stats.numSamples++;
+		stats.averageMilliseconds = totalMilliseconds / stats.numSamples;
+		OnZoneMeasured( milliseconds );
+	}
+}
+
+/**
+ * Starts measuring a zone of the timer, the zone ends when we're destructed.
+ */
+ScopedGpuZone::ScopedGpuZone( FFGLGpuTimer& timer ) :
+	timer( &timer )
+{
+	timer.Begin();
+}
+ScopedGpuZone::~ScopedGpuZone()
+{
+	EndScope();
+}
+
+void ScopedGpuZone::EndScope()
+{
+	if( timer != nullptr )
+	{
+		timer->End();
+		timer = nullptr;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,82 @@
+#pragma once
+#include "FFGL.h"
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/**
+ * The FFGLGpuTimer measures how much gpu time a zone of your rendering takes, eg a pass or your whole ProcessOpenGL. It records
+ * a timestamp query at the start and at the end of the zone. The gpu writes those timestamps when it gets to them, which is
+ * usually a frame or two later, so the timer keeps a ring of queries and only reads the ones that have finished. Reading the
+ * results never blocks. When all queries are still waiting for the gpu the zone isn't measured.
+ *
+ * Timestamps can be nested, so zones can be measured inside other zones. Use the ScopedGpuZone to measure a scope:
+ *
+ *	ScopedGpuZone zone( renderTimer );
+ *
+ * The sdk measures the gpu time of every instance's ProcessOpenGL with a timer for FF_GET_INSTANCE_STATS, see FFGLInstanceStats.
+ */
+class FFGLGpuTimer
+{
+public:
+	struct Stats
+	{
+		uint64_t numSamples;       //!< The number of zones that have been measured.
+		uint64_t numDroppedSamples;//!< The number of zones that weren't measured because all queries were still waiting for the gpu.
+		double lastMilliseconds;   //!< The gpu time of the most recently measured zone.
+		double averageMilliseconds;//!< The average gpu time of all measured zones.
+		double minMilliseconds;    //!< The gpu time of the fastest measured zone.
+		double maxMilliseconds;    //!< The gpu time of the slowest measured zone.
+	};
+
+	FFGLGpuTimer( const std::string& name );
+	FFGLGpuTimer( const FFGLGpuTimer& ) = delete;
+	virtual ~FFGLGpuTimer();
+
+	bool Initialise( unsigned int numQueryPairs = 4 );//Create the queries. Returns false if the driver doesn't support timestamps, after which zones aren't measured.
+	void Release();                                   //Release the queries. Call this before destruction if you've previously initialised us.
+
+	void Begin();//Start measuring a zone. Zones of the same timer can't overlap.
+	void End();  //Stop measuring the zone.
+
+	const std::string& GetName() const;
+	Stats GetStats() const;//The stats of all zones of which the results have been read so far.
+	void ResetStats();
+
+protected:
+	virtual void OnZoneMeasured( double milliseconds );//Called for every zone of which the result has been read, after the stats have been updated.
+
+private:
+	struct QueryPair
+	{
+		GLuint beginQueryID;
+		GLuint endQueryID;
+		bool isPending;//!< Whether or not we're waiting for the gpu to write the timestamps.
+	};
+
+	void ReadFinishedQueries();//Internal utility that reads the results of the queries the gpu has finished, in the order they were recorded.
+
+	std::string name;
+	std::vector< QueryPair > queries;
+	size_t nextQuery;   //!< The query pair the next zone is recorded with.
+	size_t oldestQuery; //!< The oldest query pair that may still be pending.
+	bool isMeasuring;   //!< Whether or not we're between a Begin and End of a zone that's being measured.
+	Stats stats;
+	double totalMilliseconds;
+};
+
+/**
+ * The ScopedGpuZone measures the gpu time of everything that's rendered during it's lifetime.
+ */
+class ScopedGpuZone
+{
+public:
+	ScopedGpuZone( FFGLGpuTimer& timer );
+	ScopedGpuZone( const ScopedGpuZone& ) = delete;
+	~ScopedGpuZone();
+
+	void EndScope();//Manually end the zone. The first time you call this the zone ends, consecutive calls have no effect.
+
+private:
+	FFGLGpuTimer* timer;
+};
\ No newline at end of file
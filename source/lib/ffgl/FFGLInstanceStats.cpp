@@ -0,0 +1,143 @@
+#include "FFGLInstanceStats.h"
+#include <algorithm>
+
+static const unsigned int NUM_TIMESTAMP_QUERIES = 4;//!< The number of frames that can be waiting for the gpu, before frames aren't measured on the gpu.
+
+static thread_local FFGLInstanceStats* s_activeStats = nullptr;
+
+FFGLInstanceStats::FFGLInstanceStats() :
+	cpuFrames(),
+	gpuFrames(),
+	gpuTimer( gpuFrames ),
+	hasInitialisedGpuTimer( false ),
+	numUploadedBytes( 0 ),
+	numGLObjects( 0 ),
+	numHeapBytes( 0 ),
+	instanceSize( 0 )
+{
+}
+
+/**
+ * Starts measuring a frame. The cpu time is measured right away, the gpu time is measured with an FFGLGpuTimer which reads
+ * the results a frame or two later without waiting for the gpu. If all of it's queries are still waiting the frame is only
+ * measured on the cpu.
+ */
+void FFGLInstanceStats::BeginFrame()
+{
+	//Not all drivers support timestamps, in which case the timer doesn't measure anything and we only measure the cpu time.
+	if( !hasInitialisedGpuTimer )
+	{
+		//The queries are the sdk's, they're not something the plugin has created.
+		ScopedInstanceStats noInstanceStats( nullptr );
+		gpuTimer.Initialise( NUM_TIMESTAMP_QUERIES );
+		hasInitialisedGpuTimer = true;
+	}
+
+	//Creating the timer's queries isn't part of the plugin's frame.
+	frameBeginTime = std::chrono::steady_clock::now();
+	gpuTimer.Begin();
+}
+void FFGLInstanceStats::EndFrame()
+{
+	gpuTimer.End();
+
+	std::chrono::duration< float, std::milli > frameTime = std::chrono::steady_clock::now() - frameBeginTime;
+	AddFrame( cpuFrames, frameTime.count() );
+}
+/**
+ * Deletes the timer's queries. Frames that are still waiting for the gpu aren't measured.
+ */
+void FFGLInstanceStats::ReleaseGLResources()
+{
+	ScopedInstanceStats noInstanceStats( nullptr );
+	gpuTimer.Release();
+	hasInitialisedGpuTimer = false;
+}
+
+void FFGLInstanceStats::SetInstanceSize( size_t numBytes )
+{
+	instanceSize = numBytes;
+}
+/**
+ * Fills the stats with what we've collected. The heap memory only includes the plugin's object and what's been reported with
+ * AddHeapBytes, CFFGLPlugin::GetInstanceStats adds the memory held by the params.
+ */
+void FFGLInstanceStats::GetStats( InstanceStatsStruct& stats ) const
+{
+	CopyFrames( cpuFrames, stats.cpuMilliseconds, stats.numCpuFrames );
+	CopyFrames( gpuFrames, stats.gpuMilliseconds, stats.numGpuFrames );
+	stats.numUploadedBytes = numUploadedBytes;
+	stats.numGLObjects     = (FFUInt32)std::max< int64_t >( numGLObjects, 0 );
+	stats.numHeapBytes     = (FFUInt64)std::max< int64_t >( (int64_t)instanceSize + numHeapBytes, 0 );
+}
+
+FFGLInstanceStats* FFGLInstanceStats::GetActive()
+{
+	return s_activeStats;
+}
+/**
+ * Reports bytes that have been uploaded to textures or buffers to the stats of the instance the host is calling into.
+ * This does nothing if there's no active stats, eg when the host calls in without an instance.
+ */
+void FFGLInstanceStats::AddUploadedBytes( uint64_t numBytes )
+{
+	if( s_activeStats != nullptr )
+		s_activeStats->numUploadedBytes += numBytes;
+}
+/**
+ * Reports gl objects that have been created, or deleted with a negative number, to the stats of the instance the host is calling into.
+ * Report every texture, buffer, framebuffer, renderbuffer, vertex array and query separately.
+ */
+void FFGLInstanceStats::AddGLObjects( int numObjects )
+{
+	if( s_activeStats != nullptr )
+		s_activeStats->numGLObjects += numObjects;
+}
+/**
+ * Reports heap memory that has been allocated, or freed with a negative number, to the stats of the instance the host is calling into.
+ * Report the memory you free while the same instance is active, eg allocate in InitGL and free in DeInitGL.
+ */
+void FFGLInstanceStats::AddHeapBytes( int64_t numBytes )
+{
+	if( s_activeStats != nullptr )
+		s_activeStats->numHeapBytes += numBytes;
+}
+
+void FFGLInstanceStats::AddFrame( FrameHistory& history, float milliseconds )
+{
+	history.milliseconds[ history.nextFrame ] = milliseconds;
+	history.nextFrame                         = ( history.nextFrame + 1 ) % FF_INSTANCE_STATS_NUM_FRAMES;
+	history.numFrames                         = std::min( history.numFrames + 1, FF_INSTANCE_STATS_NUM_FRAMES );
+}
+void FFGLInstanceStats::CopyFrames( const FrameHistory& history, float* milliseconds, FFUInt32& numFrames )
+{
+	//Until the history is full the oldest frame is at the start, after that it's the one that's going to be replaced next.
+	FFUInt32 oldestFrame = history.numFrames < FF_INSTANCE_STATS_NUM_FRAMES ? 0 : history.nextFrame;
+	for( FFUInt32 index = 0; index < history.numFrames; ++index )
+		milliseconds[ index ] = history.milliseconds[ ( oldestFrame + index ) % FF_INSTANCE_STATS_NUM_FRAMES ];
+	numFrames = history.numFrames;
+}
+FFGLInstanceStats::GpuFrameTimer::GpuFrameTimer( FrameHistory& frames ) :
+	FFGLGpuTimer( "ProcessOpenGL" ),
+	frames( frames )
+{
+}
+void FFGLInstanceStats::GpuFrameTimer::OnZoneMeasured( double milliseconds )
+{
+	AddFrame( frames, (float)milliseconds );
+}
+
+/**
+ * Activates the stats on this thread, until we're destructed.
+ *
+ * @param stats: The stats to activate, nullptr to not report anything to any instance during our lifetime.
+ */
+ScopedInstanceStats::ScopedInstanceStats( FFGLInstanceStats* stats ) :
+	previousStats( s_activeStats )
+{
+	s_activeStats = stats;
+}
+ScopedInstanceStats::~ScopedInstanceStats()
+{
+	s_activeStats = previousStats;
+}
\ No newline at end of file
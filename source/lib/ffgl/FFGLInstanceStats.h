@@ -0,0 +1,85 @@
+#pragma once
+#include "FFGL.h"
+#include "FFGLGpuTimer.h"
+#include <stdint.h>
+#include <chrono>
+
+/**
+ * The FFGLInstanceStats collects what an instance costs to run, which hosts can query per instance with FF_GET_INSTANCE_STATS.
+ * The sdk measures the cpu and gpu time of every ProcessOpenGL call. While the host is calling into an instance that instance's stats
+ * are active on the calling thread, and the ffglex helpers report the bytes they upload and the gl objects they create and delete to
+ * the active stats. That way every plugin gets these for free. If your plugin uploads or creates gl objects with direct gl calls you
+ * can report them yourself:
+ *
+ *	glBufferSubData( GL_ARRAY_BUFFER, 0, size, data );
+ *	FFGLInstanceStats::AddUploadedBytes( size );
+ */
+class FFGLInstanceStats
+{
+public:
+	FFGLInstanceStats();
+	FFGLInstanceStats( const FFGLInstanceStats& ) = delete;
+
+	void BeginFrame();        //Called by the sdk before ProcessOpenGL, starts measuring the frame.
+	void EndFrame();          //Called by the sdk after ProcessOpenGL, stops measuring the frame.
+	void ReleaseGLResources();//Called by the sdk when the instance is deinstantiated, while it's context is still current.
+
+	void SetInstanceSize( size_t numBytes );          //Called by PluginFactory with the size of the plugin's class.
+	void GetStats( InstanceStatsStruct& stats ) const;//Fills the stats, the plugin adds the memory held by it's params.
+
+	static FFGLInstanceStats* GetActive();            //The stats of the instance the host is calling into on this thread. nullptr if there is none.
+	static void AddUploadedBytes( uint64_t numBytes );//Report bytes uploaded to textures or buffers to the active stats.
+	static void AddGLObjects( int numObjects );       //Report gl objects that have been created, or deleted with a negative number, to the active stats.
+	static void AddHeapBytes( int64_t numBytes );     //Report heap memory that has been allocated, or freed with a negative number, to the active stats.
+
+private:
+	struct FrameHistory
+	{
+		float milliseconds[ FF_INSTANCE_STATS_NUM_FRAMES ];
+		FFUInt32 numFrames;//!< The number of valid entries in milliseconds.
+		FFUInt32 nextFrame;//!< The entry the next frame is written to, the oldest frame once the history is full.
+	};
+	/**
+	 * Measures the gpu time of ProcessOpenGL and adds every frame it has measured to the gpu history.
+	 */
+	class GpuFrameTimer : public FFGLGpuTimer
+	{
+	public:
+		GpuFrameTimer( FrameHistory& frames );
+
+	protected:
+		void OnZoneMeasured( double milliseconds ) override;
+
+	private:
+		FrameHistory& frames;
+	};
+
+	static void AddFrame( FrameHistory& history, float milliseconds );                              //Internal utility that adds a frame to a history, replacing the oldest one once it's full.
+	static void CopyFrames( const FrameHistory& history, float* milliseconds, FFUInt32& numFrames );//Internal utility that copies a history's frames, oldest first.
+
+	std::chrono::steady_clock::time_point frameBeginTime;
+	FrameHistory cpuFrames;
+	FrameHistory gpuFrames;
+	GpuFrameTimer gpuTimer;
+	bool hasInitialisedGpuTimer;//!< Whether or not we've tried to create the timer's queries, we only try once.
+	uint64_t numUploadedBytes;
+	int64_t numGLObjects;
+	int64_t numHeapBytes;
+	size_t instanceSize;
+};
+
+/**
+ * The ScopedInstanceStats makes the stats of the instance the host is calling into active on this thread during it's lifetime.
+ * The sdk does this around the calls that may use the gl context. Pass nullptr to deactivate the stats for things that are shared
+ * between instances, eg the render target pool's targets.
+ */
+class ScopedInstanceStats
+{
+public:
+	ScopedInstanceStats( FFGLInstanceStats* stats );
+	ScopedInstanceStats( const ScopedInstanceStats& ) = delete;
+	~ScopedInstanceStats();
+
+private:
+	FFGLInstanceStats* previousStats;//!< The stats that were active on this thread when we were constructed.
+};
\ No newline at end of file
@@ -1,13 +1,346 @@
 #include "FFGLLog.h"
+#include <stdio.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#if defined( FFGL_WINDOWS )
+#include <iostream>
+#endif
 
-static PFNLog s_logCallback = nullptr;
+static const uint32_t LOG_QUEUE_SIZE          = 1024;//!< The number of messages that can wait for the flusher. Has to be a power of two.
+static const unsigned int LOG_FLUSH_INTERVAL  = 50;  //!< How often the flusher delivers the queued messages, in milliseconds.
+static const unsigned int LOG_REPEAT_INTERVAL = 5;   //!< How often the flusher reports a message that keeps repeating, in seconds.
+
+/**
+ * A slot in the queue. The sequence tells producers and the flusher whose turn it is: a producer may fill the slot when the
+ * sequence equals it's index, the flusher may take the message once the sequence is one past it's index.
+ */
+struct LogSlot
+{
+	std::atomic< uint32_t > sequence;
+	FFGLLog::Level level;
+	std::string message;
+};
+struct LogData
+{
+	LogData();
+	~LogData();
+
+	LogSlot slots[ LOG_QUEUE_SIZE ];
+	std::atomic< uint32_t > enqueueIndex;//!< The index the next producer claims. Indices keep counting up, they're wrapped into the queue when they're used.
+	uint32_t dequeueIndex;               //!< The index of the oldest message that hasn't been delivered yet, only used by the flusher.
+
+	std::mutex deliverMutex;//!< Serialises delivering, which is done by the flusher thread while it's running and by Stop.
+	FFGLLog::Level lastLevel;
+	std::string lastMessage; //!< The message that's been delivered last, identical messages after it are collapsed.
+	uint32_t numRepeats;     //!< The number of times the last message has been repeated since we've reported it.
+	std::chrono::steady_clock::time_point lastReportTime;
+	uint64_t numReportedDrops;//!< The number of dropped messages we've reported to the host.
+
+	std::mutex controlMutex;//!< Serialises starting and stopping the flusher.
+	std::atomic< bool > isFlusherRunning;
+	std::thread flusherThread;
+	std::mutex flusherMutex;
+	std::condition_variable flusherCondition;
+	bool isStopRequested;
+};
+
+static std::atomic< PFNLog > s_logCallback( nullptr );
+#if defined( FFGL_DEBUG )
+static std::atomic< int > s_minimumLevel( FFGLLog::LL_DEBUG );
+#else
+static std::atomic< int > s_minimumLevel( FFGLLog::LL_INFO );
+#endif
+static std::atomic< uint64_t > s_numDroppedMessages( 0 );
+
+static LogData& GetLogData()
+{
+	static LogData data;
+	return data;
+}
+static int64_t GetCurrentSecond()
+{
+	return (int64_t)std::chrono::duration_cast< std::chrono::seconds >( std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+/**
+ * Delivers a message to the host, or to the debugger output if the host hasn't given us a log callback.
+ */
+static void DeliverMessage( FFGLLog::Level level, const std::string& message )
+{
+	std::string line;
+	if( level == FFGLLog::LL_WARNING )
+		line = "Warning: ";
+	else if( level == FFGLLog::LL_ERROR )
+		line = "Error: ";
+	line += message;
+
+	PFNLog logCallback = s_logCallback.load();
+	if( logCallback != nullptr )
+	{
+		logCallback( const_cast< char* >( line.c_str() ) );
+		return;
+	}
+#if defined( FFGL_WINDOWS )
+	OutputDebugStringA( line.c_str() );
+	OutputDebugStringA( "\n" );
+	std::cout << line << std::endl;
+#else
+	printf( "%s\n", line.c_str() );
+#endif
+}
+static void ReportRepeats( LogData& data )
+{
+	if( data.numRepeats == 0 )
+		return;
+	DeliverMessage( data.lastLevel, "Last message repeated " + std::to_string( data.numRepeats ) + ( data.numRepeats == 1 ? " time" : " times" ) );
+	data.numRepeats     = 0;
+	data.lastReportTime = std::chrono::steady_clock::now();
+}
+/**
+ * Delivers all messages that have been queued, collapsing the ones that are identical to the message before them.
+ * The caller needs to hold the deliver mutex.
+ */
+static void DeliverQueuedMessages( LogData& data )
+{
+	for( ;; )
+	{
+		LogSlot& slot = data.slots[ data.dequeueIndex % LOG_QUEUE_SIZE ];
+		if( slot.sequence.load( std::memory_order_acquire ) != data.dequeueIndex + 1 )
+			break;
+
+		std::string message  = std::move( slot.message );
+		FFGLLog::Level level = slot.level;
+		slot.sequence.store( data.dequeueIndex + LOG_QUEUE_SIZE, std::memory_order_release );
+		data.dequeueIndex++;
+
+		if( level == data.lastLevel && message == data.lastMessage )
+		{
+			data.numRepeats++;
+			continue;
+		}
+		ReportRepeats( data );
+		DeliverMessage( level, message );
+		data.lastLevel      = level;
+		data.lastMessage    = std::move( message );
+		data.lastReportTime = std::chrono::steady_clock::now();
+	}
+
+	uint64_t numDropped = s_numDroppedMessages.load();
+	if( numDropped != data.numReportedDrops )
+	{
+		ReportRepeats( data );
+		data.lastLevel   = FFGLLog::LL_WARNING;
+		data.lastMessage = std::to_string( numDropped - data.numReportedDrops ) + " messages have been dropped because the log queue was full";
+		DeliverMessage( data.lastLevel, data.lastMessage );
+		data.numReportedDrops = numDropped;
+	}
+
+	//A message that's repeated every frame would otherwise never be reported again until another message comes along.
+	if( std::chrono::steady_clock::now() - data.lastReportTime >= std::chrono::seconds( LOG_REPEAT_INTERVAL ) )
+		ReportRepeats( data );
+}
+static void RunFlusher( LogData* data )
+{
+	std::unique_lock< std::mutex > lock( data->flusherMutex );
+	while( !data->isStopRequested )
+	{
+		data->flusherCondition.wait_for( lock, std::chrono::milliseconds( LOG_FLUSH_INTERVAL ) );
+		lock.unlock();
+		{
+			std::lock_guard< std::mutex > deliverLock( data->deliverMutex );
+			DeliverQueuedMessages( *data );
+		}
+		lock.lock();
+	}
+}
+/**
+ * Starts the flusher the first time a message is queued, so that plugins that never log don't get a thread.
+ */
+static void StartFlusher( LogData& data )
+{
+	std::lock_guard< std::mutex > lock( data.controlMutex );
+	if( data.isFlusherRunning )
+		return;
+	data.isStopRequested  = false;
+	data.flusherThread    = std::thread( RunFlusher, &data );
+	data.isFlusherRunning = true;
+}
+/**
+ * Stops the flusher and delivers the messages it hasn't gotten to yet, including the repeats of the last message.
+ */
+static void StopFlusher( LogData& data )
+{
+	std::lock_guard< std::mutex > lock( data.controlMutex );
+	if( data.isFlusherRunning )
+	{
+		{
+			std::lock_guard< std::mutex > flusherLock( data.flusherMutex );
+			data.isStopRequested = true;
+		}
+		data.flusherCondition.notify_one();
+		data.flusherThread.join();
+		data.isFlusherRunning = false;
+	}
+
+	std::lock_guard< std::mutex > deliverLock( data.deliverMutex );
+	DeliverQueuedMessages( data );
+	ReportRepeats( data );
+}
+/**
+ * Queues a message without any locking. Producers claim a slot by advancing the enqueue index, and publish the message by
+ * advancing the slot's sequence. If the flusher hasn't freed the slot yet the queue is full and the message is dropped.
+ */
+static void EnqueueMessage( FFGLLog::Level level, std::string message )
+{
+	LogData& data = GetLogData();
+	if( !data.isFlusherRunning.load( std::memory_order_acquire ) )
+		StartFlusher( data );
+
+	uint32_t index = data.enqueueIndex.load( std::memory_order_relaxed );
+	LogSlot* slot;
+	for( ;; )
+	{
+		slot              = &data.slots[ index % LOG_QUEUE_SIZE ];
+		int32_t available = (int32_t)( slot->sequence.load( std::memory_order_acquire ) - index );
+		if( available == 0 )
+		{
+			if( data.enqueueIndex.compare_exchange_weak( index, index + 1, std::memory_order_relaxed ) )
+				break;
+		}
+		else if( available < 0 )
+		{
+			s_numDroppedMessages++;
+			return;
+		}
+		else
+		{
+			index = data.enqueueIndex.load( std::memory_order_relaxed );
+		}
+	}
+
+	slot->level   = level;
+	slot->message = std::move( message );
+	slot->sequence.store( index + 1, std::memory_order_release );
+}
+
+LogData::LogData() :
+	enqueueIndex( 0 ),
+	dequeueIndex( 0 ),
+	lastLevel( FFGLLog::LL_INFO ),
+	numRepeats( 0 ),
+	numReportedDrops( 0 ),
+	isFlusherRunning( false ),
+	isStopRequested( false )
+{
+	for( uint32_t index = 0; index < LOG_QUEUE_SIZE; ++index )
+		slots[ index ].sequence = index;
+}
+LogData::~LogData()
+{
+	//Hosts call FF_DEINITIALISE before unloading us, which has already stopped the flusher. Joining the flusher while the library
+	//is being unloaded could deadlock on Windows, so this is only a fallback for when the host didn't.
+	StopFlusher( *this );
+}
 
 void FFGLLog::SetLogCallback( PFNLog logCallback )
 {
 	s_logCallback = logCallback;
 }
+/**
+ * Queues an info message for the host. This returns right away, the message is delivered by a background thread.
+ *
+ * @param cStr: The message, nullptr is ignored.
+ */
 void FFGLLog::LogToHost( const char* cStr )
 {
-	if( s_logCallback != nullptr && cStr != nullptr )
-		s_logCallback( const_cast< char* >( cStr ) );
+	if( cStr != nullptr && IsLevelEnabled( LL_INFO ) )
+		EnqueueMessage( LL_INFO, cStr );
+}
+/**
+ * Queues a message for the host. This returns right away, the message is delivered by a background thread.
+ *
+ * @param level: The message's level, messages below the minimum level are discarded.
+ * @param message: The message.
+ * @param numSuppressed: The number of messages the call site has skipped before this one because of it's rate limit,
+ * which is mentioned at the end of the message if it's not 0.
+ */
+void FFGLLog::LogToHost( Level level, const std::string& message, uint32_t numSuppressed )
+{
+	if( !IsLevelEnabled( level ) )
+		return;
+	if( numSuppressed == 0 )
+		EnqueueMessage( level, message );
+	else
+		EnqueueMessage( level, message + " (" + std::to_string( numSuppressed ) + " similar messages suppressed)" );
+}
+/**
+ * Queues a message for the host, unless it's call site has already logged as many messages as it may this second.
+ *
+ * @param logSite: The call site's rate limit, usually a static local.
+ * @param level: The message's level, messages below the minimum level are discarded.
+ * @param message: The message.
+ */
+void FFGLLog::LogToHost( FFGLLogSite& logSite, Level level, const std::string& message )
+{
+	uint32_t numSuppressed = 0;
+	if( IsLevelEnabled( level ) && logSite.ShouldLog( numSuppressed ) )
+		LogToHost( level, message, numSuppressed );
+}
+/**
+ * Delivers the messages that are still queued and stops the background thread. The sdk calls this when the host deinitialises
+ * the plugin. Messages that are logged after this restart the thread.
+ */
+void FFGLLog::Stop()
+{
+	StopFlusher( GetLogData() );
+}
+
+void FFGLLog::SetMinimumLevel( Level level )
+{
+	s_minimumLevel = level;
+}
+bool FFGLLog::IsLevelEnabled( Level level )
+{
+	return level >= s_minimumLevel.load( std::memory_order_relaxed );
+}
+uint64_t FFGLLog::GetNumDroppedMessages()
+{
+	return s_numDroppedMessages.load();
+}
+
+/**
+ * @param maxMessagesPerSecond: The number of messages the site may log per second.
+ */
+FFGLLogSite::FFGLLogSite( unsigned int maxMessagesPerSecond ) :
+	maxMessagesPerSecond( maxMessagesPerSecond ),
+	currentSecond( 0 ),
+	numInSecond( 0 ),
+	numSuppressed( 0 )
+{
+}
+/**
+ * Counts a message against the site's rate limit. Threads that log at the exact moment the second rolls over may both
+ * start the new second, which at worst lets a message more through.
+ *
+ * @param numSuppressed: Receives the number of messages that have been skipped since the site last logged, if it may log now.
+ * @return: Whether or not the site may log now.
+ */
+bool FFGLLogSite::ShouldLog( uint32_t& numSuppressed )
+{
+	int64_t second = GetCurrentSecond();
+	if( currentSecond.load( std::memory_order_relaxed ) != second )
+	{
+		currentSecond = second;
+		numInSecond   = 0;
+	}
+
+	if( numInSecond++ >= maxMessagesPerSecond )
+	{
+		this->numSuppressed++;
+		return false;
+	}
+	numSuppressed = this->numSuppressed.exchange( 0 );
+	return true;
 }
\ No newline at end of file
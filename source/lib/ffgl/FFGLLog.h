@@ -1,9 +1,62 @@
 #pragma once
 #include "FFGL.h"
+#include <stdint.h>
+#include <atomic>
+#include <string>
 
+class FFGLLogSite;
+
+/**
+ * The FFGLLog passes your messages on to the host's log. Hosts may do file io or wait on a lock in their log callback, so
+ * messages are queued without any locking and a background thread delivers them to the host. That way logging never blocks
+ * the thread that's logging, so it's fine to log from ProcessOpenGL. If the host hasn't given us a log callback the messages
+ * are written to the debugger output and stdout instead.
+ *
+ * Consecutive identical messages are collapsed into a single "Last message repeated n times" message. To limit how often a
+ * call site can log, eg one that logs every frame while a shader fails to compile, give it an FFGLLogSite:
+ *
+ *	static FFGLLogSite logSite;
+ *	FFGLLog::LogToHost( logSite, FFGLLog::LL_ERROR, "Failed to compile " + shaderName );
+ *
+ * When the queue is full messages are dropped rather than waiting for the host, which you can see in GetNumDroppedMessages.
+ */
 class FFGLLog
 {
 public:
+	enum Level
+	{
+		LL_DEBUG,
+		LL_INFO,
+		LL_WARNING,
+		LL_ERROR
+	};
+
 	static void SetLogCallback( PFNLog logCallback );
-	static void LogToHost( const char* cStr );
+	static void LogToHost( const char* cStr );                                                   //Queue an info message.
+	static void LogToHost( Level level, const std::string& message, uint32_t numSuppressed = 0 );//Queue a message, numSuppressed is the number of messages the call site has skipped.
+	static void LogToHost( FFGLLogSite& logSite, Level level, const std::string& message );      //Queue a message if it's call site hasn't used up it's rate limit.
+	static void Stop();                                                                          //Deliver the queued messages and stop the background thread.
+
+	static void SetMinimumLevel( Level level );//Messages below this level are discarded. Defaults to LL_DEBUG in debug builds and LL_INFO otherwise.
+	static bool IsLevelEnabled( Level level ); //Whether or not messages of this level are logged, check it before building expensive messages.
+	static uint64_t GetNumDroppedMessages();   //The number of messages that didn't fit in the queue.
+};
+
+/**
+ * The FFGLLogSite limits how many messages a call site logs per second, the ones in excess are counted and skipped.
+ * The next message the site does log mentions how many have been skipped. It's safe to log from several threads at once.
+ */
+class FFGLLogSite
+{
+public:
+	FFGLLogSite( unsigned int maxMessagesPerSecond = 1 );
+	FFGLLogSite( const FFGLLogSite& ) = delete;
+
+	bool ShouldLog( uint32_t& numSuppressed );//Whether or not the site may log now, numSuppressed receives the number of messages skipped since it last logged.
+
+private:
+	const unsigned int maxMessagesPerSecond;
+	std::atomic< int64_t > currentSecond; //!< The second of the steady clock the site has last logged in.
+	std::atomic< uint32_t > numInSecond;  //!< The number of messages that have been logged or skipped in the current second.
+	std::atomic< uint32_t > numSuppressed;//!< The number of messages that have been skipped since the last one that was logged.
 };
\ No newline at end of file
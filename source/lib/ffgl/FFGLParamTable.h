@@ -0,0 +1,91 @@
+#pragma once
+#include "FFGLPluginSDK.h"
+#include <stddef.h>
+
+/**
+ * Describes a float param of a plugin that derives from CFFGLParamTablePlugin. The param's value is kept in a float
+ * member of the plugin, which the description points at.
+ */
+template< typename PluginType >
+struct FFGLParamDescription
+{
+	constexpr FFGLParamDescription( const char* name, FFUInt32 type, float PluginType::*value, float defaultValue, RangeStruct range = RangeStruct{ 0, 1 } ) :
+		name( name ),
+		type( type ),
+		value( value ),
+		defaultValue( defaultValue ),
+		range( range )
+	{
+	}
+
+	const char* name;
+	FFUInt32 type;           //!< The param's FF_TYPE_, anything but FF_TYPE_TEXT, FF_TYPE_FILE, FF_TYPE_OPTION and FF_TYPE_BUFFER.
+	float PluginType::*value;//!< The plugin's member that holds the param's value.
+	float defaultValue;      //!< The value the sdk sets when the host creates an instance. Boolean and event params use 0 or 1.
+	RangeStruct range;       //!< The range hosts should show the value in, the value itself is in the range [0, 1] like any other param.
+};
+
+/**
+ * The CFFGLParamTablePlugin registers a plugin's params from a table of FFGLParamDescriptions and implements
+ * SetFloatParameter and GetFloatParameter for them, so that plugins don't have to write switch statements to
+ * route each param to it's member. The param ids are the indices into the table. Declare the table as a static
+ * const member so that it may point at private members, and initialise it in your source file:
+ *
+ *	const FFGLParamDescription< MyPlugin > MyPlugin::PARAMS[] = {
+ *		{ "Brightness", FF_TYPE_STANDARD, &MyPlugin::brightness, 0.5f },
+ *		{ "Scale", FF_TYPE_STANDARD, &MyPlugin::scale, 0.25f, { 1.0f, 10.0f } },
+ *	};
+ *	MyPlugin::MyPlugin() :
+ *		CFFGLParamTablePlugin( PARAMS )
+ *
+ * The table is constant initialised, so it's built by the compiler and registering the params doesn't construct any
+ * strings for the instances that use the shared param schema. The sdk sets every param to it's default when the host
+ * creates an instance, so you don't need to initialise the members yourself. Plugins that have params the table can't
+ * describe can register them with ids after the table's and handle them before calling our Set/GetFloatParameter.
+ */
+template< typename PluginType >
+class CFFGLParamTablePlugin : public CFFGLPlugin
+{
+public:
+	FFResult SetFloatParameter( unsigned int index, float value ) override
+	{
+		if( index >= numParams )
+			return FF_FAIL;
+
+		static_cast< PluginType* >( this )->*params[ index ].value = value;
+		return FF_SUCCESS;
+	}
+	float GetFloatParameter( unsigned int index ) override
+	{
+		if( index >= numParams )
+			return 0.0f;
+
+		return static_cast< PluginType* >( this )->*params[ index ].value;
+	}
+
+protected:
+	/**
+	 * @param params: The plugin's param table, which has to outlive the plugin. A static const member does.
+	 * @param supportTopLeftTextureOrientation: See CFFGLPluginManager's constructor.
+	 */
+	template< size_t NumParams >
+	CFFGLParamTablePlugin( const FFGLParamDescription< PluginType > ( &params )[ NumParams ], bool supportTopLeftTextureOrientation = false ) :
+		CFFGLPlugin( supportTopLeftTextureOrientation ),
+		params( params ),
+		numParams( (unsigned int)NumParams )
+	{
+		for( unsigned int index = 0; index < numParams; ++index )
+		{
+			const FFGLParamDescription< PluginType >& param = params[ index ];
+			if( param.type == FF_TYPE_BOOLEAN || param.type == FF_TYPE_EVENT )
+				SetParamInfo( index, param.name, param.type, param.defaultValue != 0.0f );
+			else
+				SetParamInfo( index, param.name, param.type, param.defaultValue );
+			SetParamRange( index, param.range.min, param.range.max );
+		}
+	}
+
+private:
+	const FFGLParamDescription< PluginType >* params;
+	unsigned int numParams;
+};
\ No newline at end of file
@@ -168,6 +168,12 @@ private:
 	FPDEINITIALISELIBRARY* m_deinitialiseLibrary;
 };
 
+/**
+ * Lets the sdk include the size of the plugin's class in the heap memory it reports through FF_GET_INSTANCE_STATS.
+ * PluginFactory calls this for you, if you're using your own factory function you can call it yourself.
+ */
+void SetPluginInstanceSize( CFFGLPlugin* instance, size_t size );
+
 /**
  * This utility function can be used as factory function in your CFFGLPluginInfo structure.
  * This way you dont need to specify a factory function in each plugin you make but you can just
@@ -178,7 +184,10 @@ FFResult __stdcall PluginFactory( CFFGLPlugin** ppOutInstance )
 {
 	*ppOutInstance = new PluginType();
 	if( *ppOutInstance != nullptr )
+	{
+		SetPluginInstanceSize( *ppOutInstance, sizeof( PluginType ) );
 		return FF_SUCCESS;
+	}
 	return FF_FAIL;
 }
 
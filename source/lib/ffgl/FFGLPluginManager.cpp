@@ -28,13 +28,35 @@
 // CFFGLPluginManager constructor and destructor
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+const unsigned int CFFGLPluginManager::NO_PARAM;
+std::shared_ptr< const CFFGLPluginManager::ParamSchema > CFFGLPluginManager::sharedParamSchema;
+std::mutex CFFGLPluginManager::sharedParamSchemaMutex;
+
 CFFGLPluginManager::CFFGLPluginManager( bool supportTopLeftTextureOrientation ) :
+	ownParamSchema( nullptr ),
+	numRegisteredParams( 0 ),
 	m_iMinInputs( 0 ),
 	m_iMaxInputs( 0 ),
 	m_timeSupported( true ),
 	m_topLeftTextureOrientationSupported( supportTopLeftTextureOrientation ),
 	textureOrientation( TextureOrientation::BOTTOM_LEFT )
 {
+	//Instances that are created after the schema has been shared start out with it, and only register against it.
+	{
+		std::lock_guard< std::mutex > lock( sharedParamSchemaMutex );
+		paramSchema = sharedParamSchema;
+	}
+	if( paramSchema )
+	{
+		paramStates.resize( paramSchema->params.size() );
+		bufferValues.resize( paramSchema->numBufferValues, 0.0f );
+	}
+	else
+	{
+		std::shared_ptr< ParamSchema > schema = std::make_shared< ParamSchema >();
+		ownParamSchema                        = schema.get();
+		paramSchema                           = schema;
+	}
 }
 CFFGLPluginManager::~CFFGLPluginManager()
 {
@@ -68,11 +90,11 @@ void CFFGLPluginManager::HostEnabledTopLeftTextures()
 
 unsigned int CFFGLPluginManager::GetNumParams() const
 {
-	return static_cast< unsigned int >( params.size() );
+	return numRegisteredParams;
 }
 char* CFFGLPluginManager::GetParamName( unsigned int dwIndex )
 {
-	ParamInfo* paramInfo = FindParamInfo( dwIndex );
+	const ParamInfo* paramInfo = GetParamInfo( dwIndex );
 	if( paramInfo == nullptr )
 		return nullptr;
 
@@ -83,7 +105,7 @@ char* CFFGLPluginManager::GetParamName( unsigned int dwIndex )
 }
 unsigned int CFFGLPluginManager::GetParamType( unsigned int dwIndex ) const
 {
-	const ParamInfo* paramInfo = FindParamInfo( dwIndex );
+	const ParamInfo* paramInfo = GetParamInfo( dwIndex );
 	if( paramInfo == nullptr )
 		return FF_FAIL;
 
@@ -91,7 +113,7 @@ unsigned int CFFGLPluginManager::GetParamType( unsigned int dwIndex ) const
 }
 unsigned int CFFGLPluginManager::GetParamUsage( unsigned int dwIndex ) const
 {
-	const ParamInfo* paramInfo = FindParamInfo( dwIndex );
+	const ParamInfo* paramInfo = GetParamInfo( dwIndex );
 	if( paramInfo == nullptr )
 		return FF_FAIL;
 
@@ -101,7 +123,7 @@ FFMixed CFFGLPluginManager::GetParamDefault( unsigned int dwIndex ) const
 {
 	FFMixed result;
 	result.UIntValue           = FF_FAIL;
-	const ParamInfo* paramInfo = FindParamInfo( dwIndex );
+	const ParamInfo* paramInfo = GetParamInfo( dwIndex );
 	if( paramInfo == nullptr )
 		return result;
 
@@ -114,25 +136,37 @@ FFMixed CFFGLPluginManager::GetParamDefault( unsigned int dwIndex ) const
 }
 FFUInt32 CFFGLPluginManager::GetParamVisibility( unsigned int dwIndex ) const
 {
-	const ParamInfo* paramInfo = FindParamInfo( dwIndex );
-	return paramInfo != nullptr ? paramInfo->visibleInUI : FF_FAIL;
+	std::lock_guard< std::mutex > lock( paramStateMutex );
+	unsigned int paramIndex = FindParamIndex( dwIndex );
+	return paramIndex != NO_PARAM ? paramStates[ paramIndex ].visibleInUI : FF_FAIL;
 }
 
 unsigned int CFFGLPluginManager::GetNumParamElements( unsigned int dwIndex ) const
 {
-	const ParamInfo* paramInfo = FindParamInfo( dwIndex );
-	if( paramInfo == nullptr )
+	std::lock_guard< std::mutex > lock( paramStateMutex );
+	unsigned int paramIndex = FindParamIndex( dwIndex );
+	if( paramIndex == NO_PARAM )
 		return FF_FAIL;
 
-	return (unsigned int)paramInfo->elements.size();
+	const ParamInfo& paramInfo = paramSchema->params[ paramIndex ];
+	if( paramInfo.dwType == FF_TYPE_BUFFER )
+		return paramInfo.numBufferValues;
+	return (unsigned int)GetParamElements( paramIndex ).size();
 }
 char* CFFGLPluginManager::GetParamElementName( unsigned int dwIndex, unsigned int elIndex )
 {
-	ParamInfo* paramInfo = FindParamInfo( dwIndex );
-	if( paramInfo == nullptr )
+	std::lock_guard< std::mutex > lock( paramStateMutex );
+	unsigned int paramIndex = FindParamIndex( dwIndex );
+	if( paramIndex == NO_PARAM )
 		return nullptr;
 
-	if( elIndex >= paramInfo->elements.size() )
+	//Buffer elements dont have names.
+	const ParamInfo& paramInfo = paramSchema->params[ paramIndex ];
+	if( paramInfo.dwType == FF_TYPE_BUFFER )
+		return elIndex < paramInfo.numBufferValues ? const_cast< char* >( "" ) : nullptr;
+
+	const std::vector< ParamInfo::Element >& elements = GetParamElements( paramIndex );
+	if( elIndex >= elements.size() )
 		return nullptr;
 
 	/**
@@ -140,42 +174,79 @@ char* CFFGLPluginManager::GetParamElementName( unsigned int dwIndex, unsigned in
 	 * between constant and non constant pointers. This is also a problem of returning a pointer to our string rather than outputting
 	 * our string into the caller's buffer.
 	 */
-	return const_cast< char* >( paramInfo->elements[ elIndex ].name.c_str() );
+	return const_cast< char* >( elements[ elIndex ].name.c_str() );
 }
 FFMixed CFFGLPluginManager::GetParamElementDefault( unsigned int dwIndex, unsigned int elIndex ) const
 {
+	std::lock_guard< std::mutex > lock( paramStateMutex );
 	FFMixed result;
-	result.UIntValue           = FF_FAIL;
-	const ParamInfo* paramInfo = FindParamInfo( dwIndex );
-	if( paramInfo == nullptr )
+	result.UIntValue        = FF_FAIL;
+	unsigned int paramIndex = FindParamIndex( dwIndex );
+	if( paramIndex == NO_PARAM )
+		return result;
+
+	const ParamInfo& paramInfo = paramSchema->params[ paramIndex ];
+	if( paramInfo.dwType == FF_TYPE_BUFFER )
+	{
+		if( elIndex < paramInfo.numBufferValues )
+			result.UIntValue = *(unsigned int*)&bufferValues[ paramInfo.bufferOffset + elIndex ];
 		return result;
-	if( elIndex >= paramInfo->elements.size() )
+	}
+
+	const std::vector< ParamInfo::Element >& elements = GetParamElements( paramIndex );
+	if( elIndex >= elements.size() )
 		return result;
 
-	result.UIntValue = *(unsigned int*)&paramInfo->elements[ elIndex ].value;
+	result.UIntValue = *(unsigned int*)&elements[ elIndex ].value;
 
 	return result;
 }
 FFUInt32 CFFGLPluginManager::SetParamElementValue( unsigned int dwIndex, unsigned int elIndex, float newValue )
 {
-	ParamInfo* paramInfo = FindParamInfo( dwIndex );
-	if( paramInfo == nullptr )
+	unsigned int paramIndex = FindParamIndex( dwIndex );
+	if( paramIndex == NO_PARAM )
+		return FF_FAIL;
+
+	const ParamInfo& paramInfo = paramSchema->params[ paramIndex ];
+	if( paramInfo.dwType == FF_TYPE_BUFFER )
+	{
+		if( elIndex >= paramInfo.numBufferValues )
+			return FF_FAIL;
+		bufferValues[ paramInfo.bufferOffset + elIndex ] = newValue;
+		return FF_SUCCESS;
+	}
+
+	std::lock_guard< std::mutex > lock( paramStateMutex );
+	if( elIndex >= GetParamElements( paramIndex ).size() )
 		return FF_FAIL;
 
-	if( elIndex >= paramInfo->elements.size() )
+	//The schema's elements are shared with the other instances, so the first change gives this instance a copy of them.
+	ParamState& paramState = paramStates[ paramIndex ];
+	if( !paramState.elements )
+		paramState.elements.reset( new std::vector< ParamInfo::Element >( paramInfo.elements ) );
+	( *paramState.elements )[ elIndex ].value = newValue;
+	return FF_SUCCESS;
+}
+FFUInt32 CFFGLPluginManager::SetParamElementValues( unsigned int dwIndex, const float* newValues, unsigned int numValues )
+{
+	const ParamInfo* paramInfo = GetParamInfo( dwIndex );
+	if( paramInfo == nullptr || paramInfo->dwType != FF_TYPE_BUFFER )
 		return FF_FAIL;
 
-	paramInfo->elements[ elIndex ].value = newValue;
+	if( numValues > paramInfo->numBufferValues || ( numValues > 0 && newValues == nullptr ) )
+		return FF_FAIL;
+
+	std::copy( newValues, newValues + numValues, bufferValues.begin() + paramInfo->bufferOffset );
 	return FF_SUCCESS;
 }
 FFUInt32 CFFGLPluginManager::GetNumElementSeparators( unsigned int dwIndex )
 {
-	ParamInfo* paramInfo = FindParamInfo( dwIndex );
+	const ParamInfo* paramInfo = GetParamInfo( dwIndex );
 	return paramInfo != nullptr ? static_cast< FFUInt32 >( paramInfo->elementSeparators.size() ) : 0;
 }
 FFUInt32 CFFGLPluginManager::GetElementSeparatorElementIndex( unsigned int dwIndex, unsigned int separatorIndex )
 {
-	ParamInfo* paramInfo = FindParamInfo( dwIndex );
+	const ParamInfo* paramInfo = GetParamInfo( dwIndex );
 	if( paramInfo != nullptr && separatorIndex < paramInfo->elementSeparators.size() )
 		return paramInfo->elementSeparators[ separatorIndex ].beforeIndex;
 	else
@@ -184,7 +255,7 @@ FFUInt32 CFFGLPluginManager::GetElementSeparatorElementIndex( unsigned int dwInd
 
 unsigned int CFFGLPluginManager::GetNumFileParamExtensions( unsigned int index ) const
 {
-	const ParamInfo* paramInfo = FindParamInfo( index );
+	const ParamInfo* paramInfo = GetParamInfo( index );
 	if( paramInfo == nullptr )
 		return 0;
 
@@ -192,7 +263,7 @@ unsigned int CFFGLPluginManager::GetNumFileParamExtensions( unsigned int index )
 }
 char* CFFGLPluginManager::GetFileParamExtension( unsigned int paramIndex, unsigned int extensionIndex ) const
 {
-	const ParamInfo* paramInfo = FindParamInfo( paramIndex );
+	const ParamInfo* paramInfo = GetParamInfo( paramIndex );
 	if( paramInfo == nullptr )
 		return nullptr;
 
@@ -209,49 +280,74 @@ char* CFFGLPluginManager::GetFileParamExtension( unsigned int paramIndex, unsign
 
 RangeStruct CFFGLPluginManager::GetParamRange( unsigned int dwIndex )
 {
-	RangeStruct result   = { 0, 1 };
-	ParamInfo* paramInfo = FindParamInfo( dwIndex );
+	RangeStruct result         = { 0, 1 };
+	const ParamInfo* paramInfo = GetParamInfo( dwIndex );
 	if( paramInfo )
 		result = paramInfo->range;
 	return result;
 }
 std::string CFFGLPluginManager::GetParamGroup( unsigned int dwIndex )
 {
-	ParamInfo* paramInfo = FindParamInfo( dwIndex );
+	const ParamInfo* paramInfo = GetParamInfo( dwIndex );
 	return paramInfo != nullptr ? paramInfo->groupName : std::string();
 }
 std::string CFFGLPluginManager::GetParamDisplayName( unsigned int dwIndex )
 {
-	ParamInfo* paramInfo = FindParamInfo( dwIndex );
-	return paramInfo != nullptr ? paramInfo->displayName : std::string();
+	std::lock_guard< std::mutex > lock( paramStateMutex );
+	unsigned int paramIndex = FindParamIndex( dwIndex );
+	return paramIndex != NO_PARAM ? paramStates[ paramIndex ].displayName : std::string();
 }
 
 FFUInt32 CFFGLPluginManager::GetNumPendingParamEvents() const
 {
-	FFUInt32 numPendingEvents = 0;
-	for( const ParamInfo& param : params )
-	{
-		if( param.pendingEventFlags != 0 )
-			numPendingEvents++;
-	}
-	return numPendingEvents;
+	return numPendingEventParams.load( std::memory_order_acquire );
 }
 FFUInt32 CFFGLPluginManager::ConsumeParamEvents( ParamEventStruct* events, FFUInt32 maxNumEvents )
 {
-	FFUInt32 numEventsConsumed = 0;
-	for( size_t index = 0; index < params.size() && numEventsConsumed < maxNumEvents; ++index )
+	//Hosts poll for events every frame, most of the time there won't be any so dont bother taking the lock.
+	if( numPendingEventParams.load( std::memory_order_acquire ) == 0 )
+		return 0;
+
+	std::lock_guard< std::mutex > lock( paramStateMutex );
+	FFUInt32 numEventsConsumed = std::min( maxNumEvents, (FFUInt32)pendingEventParams.size() );
+	for( FFUInt32 index = 0; index < numEventsConsumed; ++index )
 	{
-		if( params[ index ].pendingEventFlags != 0 )
-		{
-			events[ numEventsConsumed ].ParameterNumber = params[ index ].ID;
-			events[ numEventsConsumed ].eventFlags      = params[ index ].pendingEventFlags;
-			params[ index ].pendingEventFlags           = 0;
-			numEventsConsumed++;
-		}
+		unsigned int paramIndex         = pendingEventParams[ index ];
+		ParamState& paramState          = paramStates[ paramIndex ];
+		events[ index ].ParameterNumber = paramSchema->params[ paramIndex ].ID;
+		events[ index ].eventFlags      = paramState.pendingEventFlags;
+		paramState.pendingEventFlags    = 0;
 	}
+	pendingEventParams.erase( pendingEventParams.begin(), pendingEventParams.begin() + numEventsConsumed );
+	numPendingEventParams.store( (FFUInt32)pendingEventParams.size(), std::memory_order_release );
 	return numEventsConsumed;
 }
 
+/**
+ * Shares this instance's schema with the instances that are created after it, if it's the first instance to finish registering
+ * it's params. If this instance is using the shared schema but hasn't registered all of it's params it gets a schema of it's own.
+ */
+void CFFGLPluginManager::FinishParamRegistration()
+{
+	if( ownParamSchema == nullptr )
+	{
+		if( numRegisteredParams != paramSchema->params.size() )
+			UnshareParamSchema();
+		return;
+	}
+
+	std::lock_guard< std::mutex > lock( sharedParamSchemaMutex );
+	if( sharedParamSchema )
+		return;
+	sharedParamSchema = paramSchema;
+	ownParamSchema    = nullptr;
+}
+void CFFGLPluginManager::ReleaseSharedParamSchema()
+{
+	std::lock_guard< std::mutex > lock( sharedParamSchemaMutex );
+	sharedParamSchema.reset();
+}
+
 void CFFGLPluginManager::SetMinInputs( unsigned int iMinInputs )
 {
 	m_iMinInputs = iMinInputs;
@@ -268,14 +364,6 @@ void CFFGLPluginManager::SetTimeSupported( bool supported )
 
 void CFFGLPluginManager::SetParamInfo( unsigned int paramID, const char* pchName, unsigned int pType, float fDefaultValue )
 {
-	ParamInfo pInfo;
-	pInfo.ID = paramID;
-
-	pInfo.elements.resize( 1 );
-	pInfo.usage = 0;
-	pInfo.name  = pchName;
-
-	pInfo.dwType = pType;
 	if( pType == FF_TYPE_STANDARD )
 	{
 		if( fDefaultValue > 1.0 )
@@ -284,21 +372,59 @@ void CFFGLPluginManager::SetParamInfo( unsigned int paramID, const char* pchName
 			fDefaultValue = 0.0;
 	}
 
+	//Plugins may change the default after registering the param, eg the quickstart's range params whose default isn't clamped,
+	//so we compare the shared default the way it would have been registered.
+	const ParamInfo* sharedInfo = FindSharedParam( paramID, pchName, pType );
+	if( sharedInfo != nullptr && sharedInfo->elements.size() == 1 && sharedInfo->usage == 0 )
+	{
+		float sharedDefault = sharedInfo->defaultFloatVal;
+		if( pType == FF_TYPE_STANDARD )
+			sharedDefault = std::min( std::max( sharedDefault, 0.0f ), 1.0f );
+		if( sharedDefault == fDefaultValue )
+		{
+			ReuseSharedParam();
+			return;
+		}
+	}
+
+	ParamInfo pInfo;
+	pInfo.ID = paramID;
+
+	pInfo.elements.resize( 1 );
+	pInfo.usage = 0;
+	pInfo.name  = pchName;
+
+	pInfo.dwType          = pType;
 	pInfo.defaultFloatVal = fDefaultValue;
-	params.push_back( pInfo );
+	AddParamInfo( std::move( pInfo ) );
 }
 void CFFGLPluginManager::SetParamInfo( unsigned int paramID, const char* pchName, unsigned int pType, bool bDefaultValue )
 {
+	float defaultValue          = bDefaultValue ? 1.0f : 0.0f;
+	const ParamInfo* sharedInfo = FindSharedParam( paramID, pchName, pType );
+	if( sharedInfo != nullptr && sharedInfo->elements.empty() && sharedInfo->defaultFloatVal == defaultValue )
+	{
+		ReuseSharedParam();
+		return;
+	}
+
 	ParamInfo pInfo;
 	pInfo.ID   = paramID;
 	pInfo.name = pchName;
 
 	pInfo.dwType          = pType;
-	pInfo.defaultFloatVal = bDefaultValue ? 1.0f : 0.0f;
-	params.push_back( pInfo );
+	pInfo.defaultFloatVal = defaultValue;
+	AddParamInfo( std::move( pInfo ) );
 }
 void CFFGLPluginManager::SetParamInfo( unsigned int dwIndex, const char* pchName, unsigned int dwType, const char* pchDefaultValue )
 {
+	const ParamInfo* sharedInfo = FindSharedParam( dwIndex, pchName, dwType );
+	if( sharedInfo != nullptr && sharedInfo->elements.size() == 1 && sharedInfo->usage == 0 && sharedInfo->defaultStringVal == pchDefaultValue )
+	{
+		ReuseSharedParam();
+		return;
+	}
+
 	ParamInfo pInfo;
 	pInfo.ID = dwIndex;
 
@@ -308,25 +434,40 @@ void CFFGLPluginManager::SetParamInfo( unsigned int dwIndex, const char* pchName
 
 	pInfo.dwType           = dwType;
 	pInfo.defaultStringVal = pchDefaultValue;
-	params.push_back( pInfo );
+	AddParamInfo( std::move( pInfo ) );
 }
 
 void CFFGLPluginManager::SetBufferParamInfo( unsigned int paramID, const char* pchName, unsigned int numElements, unsigned int usage )
 {
+	const ParamInfo* sharedInfo = FindSharedParam( paramID, pchName, FF_TYPE_BUFFER );
+	if( sharedInfo != nullptr && sharedInfo->numBufferValues == numElements && sharedInfo->usage == usage )
+	{
+		ReuseSharedParam();
+		return;
+	}
+
 	ParamInfo pInfo;
 	pInfo.ID = paramID;
 
-	pInfo.elements.resize( numElements );
-	pInfo.usage = usage;
-	pInfo.name  = pchName;
+	pInfo.numBufferValues = numElements;
+	pInfo.usage           = usage;
+	pInfo.name            = pchName;
 
 	pInfo.dwType = FF_TYPE_BUFFER;
 
 	pInfo.defaultFloatVal = 0.0f;
-	params.push_back( pInfo );
+	AddParamInfo( std::move( pInfo ) );
 }
 void CFFGLPluginManager::SetOptionParamInfo( unsigned int pIndex, const char* pchName, unsigned int numElements, float defaultValue )
 {
+	//The elements' names and values are compared when they're set with SetParamElementInfo.
+	const ParamInfo* sharedInfo = FindSharedParam( pIndex, pchName, FF_TYPE_OPTION );
+	if( sharedInfo != nullptr && sharedInfo->elements.size() == numElements && sharedInfo->defaultFloatVal == defaultValue )
+	{
+		ReuseSharedParam();
+		return;
+	}
+
 	ParamInfo pInfo;
 	pInfo.ID = pIndex;
 
@@ -337,32 +478,66 @@ void CFFGLPluginManager::SetOptionParamInfo( unsigned int pIndex, const char* pc
 	pInfo.dwType = FF_TYPE_OPTION;
 
 	pInfo.defaultFloatVal = defaultValue;
-	params.push_back( pInfo );
+	AddParamInfo( std::move( pInfo ) );
 }
 void CFFGLPluginManager::SetParamElementInfo( unsigned int paramID, unsigned int elementIndex, const char* elementName, float elementValue )
 {
-	ParamInfo* paramInfo = FindParamInfo( paramID );
-	if( paramInfo == nullptr )
+	unsigned int paramIndex = FindParamIndex( paramID );
+	if( paramIndex == NO_PARAM )
 		return;
 
-	if( elementIndex >= paramInfo->elements.size() )
+	{
+		//Once the instance has elements of it's own those are the ones that are shown, so that's where the change goes.
+		std::lock_guard< std::mutex > lock( paramStateMutex );
+		std::vector< ParamInfo::Element >* elements = paramStates[ paramIndex ].elements.get();
+		if( elements != nullptr )
+		{
+			if( elementIndex < elements->size() )
+			{
+				( *elements )[ elementIndex ].name  = elementName;
+				( *elements )[ elementIndex ].value = elementValue;
+			}
+			return;
+		}
+	}
+
+	const ParamInfo& paramInfo = paramSchema->params[ paramIndex ];
+	if( elementIndex >= paramInfo.elements.size() )
+		return;
+	if( paramInfo.elements[ elementIndex ].name == elementName && paramInfo.elements[ elementIndex ].value == elementValue )
 		return;
 
-	paramInfo->elements[ elementIndex ].name  = elementName;
-	paramInfo->elements[ elementIndex ].value = elementValue;
+	ParamInfo::Element& element = GetMutableParamInfo( paramID )->elements[ elementIndex ];
+	element.name                = elementName;
+	element.value               = elementValue;
 }
 
 void CFFGLPluginManager::AddElementSeparator( unsigned int paramID, unsigned int beforeElementIndex )
 {
-	ParamInfo* paramInfo = FindParamInfo( paramID );
+	const ParamInfo* paramInfo = GetParamInfo( paramID );
 	if( paramInfo == nullptr )
 		return;
 
-	paramInfo->elementSeparators.push_back( ParamInfo::ElementSeparator{ beforeElementIndex } );
+	//Instances that use the shared schema add the same separators again, which it already has. A schema that's been copied from
+	//the shared one while the instance was still registering it's params may also have them already.
+	for( const ParamInfo::ElementSeparator& separator : paramInfo->elementSeparators )
+	{
+		if( separator.beforeIndex == beforeElementIndex )
+			return;
+	}
+
+	GetMutableParamInfo( paramID )->elementSeparators.push_back( ParamInfo::ElementSeparator{ beforeElementIndex } );
 }
 
 void CFFGLPluginManager::SetFileParamInfo( unsigned int index, const char* pchName, std::vector< std::string > supportedExtensions, const char* defaultFile )
 {
+	const ParamInfo* sharedInfo = FindSharedParam( index, pchName, FF_TYPE_FILE );
+	if( sharedInfo != nullptr && sharedInfo->supportedExtensions == supportedExtensions && sharedInfo->defaultStringVal == defaultFile )
+	{
+		ReuseSharedParam();
+		return;
+	}
+
 	ParamInfo pInfo;
 	pInfo.ID   = index;
 	pInfo.name = pchName;
@@ -373,92 +548,277 @@ void CFFGLPluginManager::SetFileParamInfo( unsigned int index, const char* pchNa
 
 	pInfo.supportedExtensions = std::move( supportedExtensions );
 	pInfo.defaultStringVal    = defaultFile;
-	params.push_back( pInfo );
+	AddParamInfo( std::move( pInfo ) );
 }
 
 void CFFGLPluginManager::SetParamVisibility( unsigned int paramID, bool shouldBeVisible, bool raiseEvent )
 {
-	ParamInfo* paramInfo = FindParamInfo( paramID );
-	if( paramInfo == nullptr )
+	unsigned int paramIndex = FindParamIndex( paramID );
+	if( paramIndex == NO_PARAM )
 		return;
 
-	bool wasVisible        = paramInfo->visibleInUI;
-	paramInfo->visibleInUI = shouldBeVisible;
+	std::lock_guard< std::mutex > lock( paramStateMutex );
+	ParamState& paramState = paramStates[ paramIndex ];
+	bool wasVisible        = paramState.visibleInUI;
+	paramState.visibleInUI = shouldBeVisible;
 	if( raiseEvent && wasVisible != shouldBeVisible )
-		paramInfo->pendingEventFlags |= FF_EVENT_FLAG_VISIBILITY;
+		AddPendingParamEvent( paramIndex, FF_EVENT_FLAG_VISIBILITY );
 }
 void CFFGLPluginManager::SetParamRange( unsigned int paramID, float min, float max )
 {
-	ParamInfo* paramInfo = FindParamInfo( paramID );
-	if( paramInfo != nullptr )
-		paramInfo->range = { min, max };
+	const ParamInfo* paramInfo = GetParamInfo( paramID );
+	if( paramInfo != nullptr && ( paramInfo->range.min != min || paramInfo->range.max != max ) )
+		GetMutableParamInfo( paramID )->range = { min, max };
 }
 void CFFGLPluginManager::SetParamGroup( unsigned int dwIndex, std::string newGroupName )
 {
-	ParamInfo* paramInfo = FindParamInfo( dwIndex );
-	if( paramInfo != nullptr )
-		paramInfo->groupName = newGroupName;
+	const ParamInfo* paramInfo = GetParamInfo( dwIndex );
+	if( paramInfo != nullptr && paramInfo->groupName != newGroupName )
+		GetMutableParamInfo( dwIndex )->groupName = std::move( newGroupName );
 }
 void CFFGLPluginManager::SetParamDisplayName( unsigned int paramID, std::string newDisplayName, bool raiseEvent )
 {
-	ParamInfo* paramInfo = FindParamInfo( paramID );
-	if( paramInfo == nullptr )
+	unsigned int paramIndex = FindParamIndex( paramID );
+	if( paramIndex == NO_PARAM )
 		return;
 
-	std::string previousDisplayName = std::move( paramInfo->displayName );
-	paramInfo->displayName          = std::move( newDisplayName );
-	if( raiseEvent && previousDisplayName != paramInfo->displayName )
-		paramInfo->pendingEventFlags |= FF_EVENT_FLAG_DISPLAY_NAME;
+	std::lock_guard< std::mutex > lock( paramStateMutex );
+	ParamState& paramState          = paramStates[ paramIndex ];
+	std::string previousDisplayName = std::move( paramState.displayName );
+	paramState.displayName          = std::move( newDisplayName );
+	if( raiseEvent && previousDisplayName != paramState.displayName )
+		AddPendingParamEvent( paramIndex, FF_EVENT_FLAG_DISPLAY_NAME );
 }
 
 void CFFGLPluginManager::SetParamElements( unsigned int dwIndex, std::vector< std::string > newElements, const std::vector< float >& elementValues, bool raiseEvent )
 {
-	ParamInfo* paramInfo = FindParamInfo( dwIndex );
-	if( paramInfo == nullptr )
+	std::shared_ptr< const ParamSchema > schema = std::atomic_load( &paramSchema );
+	unsigned int paramIndex                     = FindParamIndex( *schema, dwIndex );
+	if( paramIndex == NO_PARAM )
 		return;
-	if( paramInfo->dwType != FF_TYPE_OPTION )
+	if( schema->params[ paramIndex ].dwType != FF_TYPE_OPTION )
 		return;
 	if( newElements.size() != elementValues.size() )
 		return;
 
-	paramInfo->elements.resize( newElements.size() );
+	std::unique_ptr< std::vector< ParamInfo::Element > > elements( new std::vector< ParamInfo::Element >( newElements.size() ) );
 	for( size_t index = 0, num = newElements.size(); index < num; ++index )
 	{
-		paramInfo->elements[ index ].name = std::move( newElements[ index ] );
-		paramInfo->elements[ index ].value = elementValues[ index ];
+		( *elements )[ index ].name  = std::move( newElements[ index ] );
+		( *elements )[ index ].value = elementValues[ index ];
 	}
+
+	std::lock_guard< std::mutex > lock( paramStateMutex );
+	paramStates[ paramIndex ].elements = std::move( elements );
 	if( raiseEvent )
-		paramInfo->pendingEventFlags |= FF_EVENT_FLAG_ELEMENTS;
+		AddPendingParamEvent( paramIndex, FF_EVENT_FLAG_ELEMENTS );
 }
 
 void CFFGLPluginManager::RaiseParamEvent( unsigned int paramID, FFUInt64 eventToRaise )
 {
-	ParamInfo* paramInfo = FindParamInfo( paramID );
-	if( paramInfo != nullptr )
-		paramInfo->pendingEventFlags |= eventToRaise;
+	unsigned int paramIndex = FindParamIndex( paramID );
+	if( paramIndex == NO_PARAM )
+		return;
+
+	std::lock_guard< std::mutex > lock( paramStateMutex );
+	AddPendingParamEvent( paramIndex, eventToRaise );
+}
+void CFFGLPluginManager::AddPendingParamEvent( unsigned int paramIndex, FFUInt64 eventToRaise )
+{
+	if( eventToRaise == 0 )
+		return;
+
+	//Only queue the param for it's first pending event, later events are merged into the flags that are already pending.
+	ParamState& paramState = paramStates[ paramIndex ];
+	if( paramState.pendingEventFlags == 0 )
+	{
+		pendingEventParams.push_back( paramIndex );
+		numPendingEventParams.store( (FFUInt32)pendingEventParams.size(), std::memory_order_release );
+	}
+	paramState.pendingEventFlags |= eventToRaise;
 }
 
+bool CFFGLPluginManager::UseSharedParamSchema()
+{
+	if( ownParamSchema != nullptr || numRegisteredParams != 0 )
+		return false;
+
+	numRegisteredParams = (unsigned int)paramSchema->params.size();
+	return true;
+}
 CFFGLPluginManager::ParamInfo* CFFGLPluginManager::FindParamInfo( unsigned int ID )
 {
-	for( ParamInfo& param : params )
+	return GetMutableParamInfo( ID );
+}
+const CFFGLPluginManager::ParamInfo* CFFGLPluginManager::FindParamInfo( unsigned int ID ) const
+{
+	return GetParamInfo( ID );
+}
+const CFFGLPluginManager::ParamInfo* CFFGLPluginManager::GetParamInfo( unsigned int paramID ) const
+{
+	unsigned int paramIndex = FindParamIndex( paramID );
+	return paramIndex != NO_PARAM ? &paramSchema->params[ paramIndex ] : nullptr;
+}
+CFFGLPluginManager::ParamInfo* CFFGLPluginManager::GetMutableParamInfo( unsigned int paramID )
+{
+	unsigned int paramIndex = FindParamIndex( paramID );
+	if( paramIndex == NO_PARAM )
+		return nullptr;
+
+	if( ownParamSchema == nullptr )
+		UnshareParamSchema();
+	return &ownParamSchema->params[ paramIndex ];
+}
+const float* CFFGLPluginManager::GetBufferParamValues( unsigned int paramID ) const
+{
+	const ParamInfo* paramInfo = GetParamInfo( paramID );
+	if( paramInfo == nullptr || paramInfo->dwType != FF_TYPE_BUFFER )
+		return nullptr;
+
+	return bufferValues.data() + paramInfo->bufferOffset;
+}
+CFFGLPluginManager::TextureOrientation CFFGLPluginManager::GetTextureOrientation() const
+{
+	return textureOrientation;
+}
+/**
+ * The shared schema isn't counted, only the schema of an instance that has one of it's own. That way the shared schema is
+ * counted once, for the prototype, which isn't one of the host's instances.
+ */
+size_t CFFGLPluginManager::GetParamHeapBytes() const
+{
+	//Strings that fit in their small string buffer don't allocate, but counting their capacity keeps this simple and close enough.
+	std::lock_guard< std::mutex > lock( paramStateMutex );
+	size_t numBytes = paramStates.capacity() * sizeof( ParamState );
+	numBytes += bufferValues.capacity() * sizeof( float );
+	numBytes += pendingEventParams.capacity() * sizeof( unsigned int );
+	for( const ParamState& paramState : paramStates )
 	{
-		if( param.ID == ID )
-			return &param;
+		numBytes += paramState.displayName.capacity();
+		if( !paramState.elements )
+			continue;
+		numBytes += sizeof( std::vector< ParamInfo::Element > ) + paramState.elements->capacity() * sizeof( ParamInfo::Element );
+		for( const ParamInfo::Element& element : *paramState.elements )
+			numBytes += element.name.capacity();
 	}
 
-	return nullptr;
+	if( ownParamSchema == nullptr )
+		return numBytes;
+
+	numBytes += sizeof( ParamSchema ) + ownParamSchema->params.capacity() * sizeof( ParamInfo );
+	numBytes += ownParamSchema->denseParamIndices.capacity() * sizeof( unsigned int );
+	numBytes += ownParamSchema->sparseParamIndices.size() * ( sizeof( unsigned int ) * 2 + sizeof( void* ) );
+	for( const ParamInfo& param : ownParamSchema->params )
+	{
+		numBytes += param.name.capacity() + param.defaultStringVal.capacity() + param.groupName.capacity();
+		numBytes += param.elements.capacity() * sizeof( ParamInfo::Element );
+		for( const ParamInfo::Element& element : param.elements )
+			numBytes += element.name.capacity();
+		numBytes += param.elementSeparators.capacity() * sizeof( ParamInfo::ElementSeparator );
+		numBytes += param.supportedExtensions.capacity() * sizeof( std::string );
+		for( const std::string& extension : param.supportedExtensions )
+			numBytes += extension.capacity();
+	}
+	return numBytes;
 }
-const CFFGLPluginManager::ParamInfo* CFFGLPluginManager::FindParamInfo( unsigned int ID ) const
+
+void CFFGLPluginManager::AddParamInfo( ParamInfo&& paramInfo )
 {
-	for( const ParamInfo& param : params )
+	if( ownParamSchema == nullptr )
+		UnshareParamSchema();
+
+	unsigned int paramIndex = numRegisteredParams;
+	if( paramInfo.dwType == FF_TYPE_BUFFER )
+	{
+		paramInfo.bufferOffset = ownParamSchema->numBufferValues;
+		ownParamSchema->numBufferValues += paramInfo.numBufferValues;
+		bufferValues.resize( ownParamSchema->numBufferValues, 0.0f );
+	}
+	ownParamSchema->params.push_back( std::move( paramInfo ) );
 	{
-		if( param.ID == ID )
-			return &param;
+		std::lock_guard< std::mutex > lock( paramStateMutex );
+		paramStates.emplace_back();
 	}
+	numRegisteredParams++;
+	IndexParam( *ownParamSchema, paramIndex );
+}
+const CFFGLPluginManager::ParamInfo* CFFGLPluginManager::FindSharedParam( unsigned int paramID, const char* name, unsigned int type ) const
+{
+	//Instances register their params in the same order as the instance that shared the schema, so it can only be the next one.
+	if( ownParamSchema != nullptr || numRegisteredParams >= paramSchema->params.size() )
+		return nullptr;
 
-	return nullptr;
+	const ParamInfo& paramInfo = paramSchema->params[ numRegisteredParams ];
+	if( paramInfo.ID != paramID || paramInfo.dwType != type || paramInfo.name != name )
+		return nullptr;
+	return &paramInfo;
 }
-CFFGLPluginManager::TextureOrientation CFFGLPluginManager::GetTextureOrientation() const
+void CFFGLPluginManager::ReuseSharedParam()
 {
-	return textureOrientation;
+	numRegisteredParams++;
+}
+void CFFGLPluginManager::UnshareParamSchema()
+{
+	std::shared_ptr< ParamSchema > schema = std::make_shared< ParamSchema >();
+	schema->params.assign( paramSchema->params.begin(), paramSchema->params.begin() + numRegisteredParams );
+	for( const ParamInfo& param : schema->params )
+		schema->numBufferValues += param.numBufferValues;
+	for( unsigned int paramIndex = 0; paramIndex < numRegisteredParams; ++paramIndex )
+		IndexParam( *schema, paramIndex );
+
+	//Other threads may be looking up params while we're replacing the schema. They either find them in the schema we're
+	//replacing, which they keep alive while they're using it, or in the new schema which is complete by now.
+	std::atomic_store( &paramSchema, std::shared_ptr< const ParamSchema >( schema ) );
+	ownParamSchema = schema.get();
+
+	//The params of the shared schema this instance hasn't registered don't exist for it.
+	{
+		std::lock_guard< std::mutex > lock( paramStateMutex );
+		paramStates.resize( numRegisteredParams );
+	}
+	bufferValues.resize( schema->numBufferValues );
+}
+void CFFGLPluginManager::IndexParam( ParamSchema& schema, unsigned int paramIndex )
+{
+	//When an id is registered twice we keep finding the first param that was registered with it.
+	unsigned int paramID = schema.params[ paramIndex ].ID;
+	if( FindParamIndex( schema, paramID ) != NO_PARAM )
+		return;
+
+	//Ids are expected to be (mostly) consecutive. The dense table is allowed to grow to about twice the number of params,
+	//ids beyond that would waste too much memory and are put in the sparse map instead.
+	std::vector< unsigned int >& denseParamIndices = schema.denseParamIndices;
+	if( paramID >= denseParamIndices.size() && paramID <= 2 * paramIndex + 64 )
+		denseParamIndices.resize( paramID + 1, NO_PARAM );
+	if( paramID < denseParamIndices.size() )
+		denseParamIndices[ paramID ] = paramIndex;
+	else
+		schema.sparseParamIndices[ paramID ] = paramIndex;
+}
+unsigned int CFFGLPluginManager::FindParamIndex( unsigned int ID ) const
+{
+	std::shared_ptr< const ParamSchema > schema = std::atomic_load( &paramSchema );
+	return FindParamIndex( *schema, ID );
+}
+unsigned int CFFGLPluginManager::FindParamIndex( const ParamSchema& schema, unsigned int ID ) const
+{
+	unsigned int paramIndex = NO_PARAM;
+	if( ID < schema.denseParamIndices.size() )
+		paramIndex = schema.denseParamIndices[ ID ];
+
+	//An id may have been put in the sparse map before the dense table had grown far enough to contain it.
+	if( paramIndex == NO_PARAM && !schema.sparseParamIndices.empty() )
+	{
+		auto sparseIndex = schema.sparseParamIndices.find( ID );
+		if( sparseIndex != schema.sparseParamIndices.end() )
+			paramIndex = sparseIndex->second;
+	}
+
+	//The shared schema may contain params this instance hasn't registered (yet).
+	return paramIndex < numRegisteredParams ? paramIndex : NO_PARAM;
+}
+const std::vector< CFFGLPluginManager::ParamInfo::Element >& CFFGLPluginManager::GetParamElements( unsigned int paramIndex ) const
+{
+	const ParamState& paramState = paramStates[ paramIndex ];
+	return paramState.elements ? *paramState.elements : paramSchema->params[ paramIndex ].elements;
 }
@@ -21,6 +21,10 @@
 #define FFGLPLUGINMANAGER_STANDARD
 #include <vector>
 #include <string>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
+#include <memory>
 
 #include "FFGL.h"
 
@@ -146,6 +150,7 @@ public:
 	///						It should be in the range [0, parameter.Number of elements).
 	///	\return				The name of the parameter's element whose indices are passed to the method.
 	///						The return value is a pointer to a null terminated c string of ASCII characters.
+	///						It stays valid until the plugin changes the parameter's elements with SetParamElements.
 	///						In case of error, NULL is returned.
 	char* GetParamElementName( unsigned int dwIndex, unsigned int elIndex );
 	/// Get the default value of an element for a parameter whose elements default values have any effect (eg FF_TYPE_OPTION)
@@ -172,6 +177,17 @@ public:
 	///	\return				FFGL result indicating if setting the value succeeded. Setting a value might fail
 	///						if either of the provided indices is out of range. FF_SUCCESS on success, FF_FAIL otherwise.
 	FFUInt32 SetParamElementValue( unsigned int dwIndex, unsigned int elIndex, float newValue );
+	/// Replace the values of a buffer parameter's (FF_TYPE_BUFFER) elements at once. Hosts use this to send eg a whole
+	/// fft spectrum with a single call instead of setting it one element at a time.
+	///
+	/// \param	dwIndex		The index of the buffer parameter whose element values are to be changed.
+	///						It should be in the range[0, Number of plugin parameters).
+	///	\param	newValues	The new values, starting with the value for element 0.
+	///	\param	numValues	The number of values in newValues. This may be less than the parameter's number of elements,
+	///						in which case the remaining elements keep their value.
+	///	\return				FF_SUCCESS on success, FF_FAIL if the parameter doesn't exist, isn't a buffer parameter or
+	///						if numValues is larger than it's number of elements.
+	FFUInt32 SetParamElementValues( unsigned int dwIndex, const float* newValues, unsigned int numValues );
 	/// Get the number of element separators a parameter may have. Calling this only makes sense for FF_TYPE_OPTION parameters
 	/// as those are the only parameters which can contain separatable elements.
 	///
@@ -196,17 +212,26 @@ public:
 	std::string GetParamGroup( unsigned int dwIndex );
 	std::string GetParamDisplayName( unsigned int dwIndex );
 
-	/// Get the number of parameter events that are currently pending.
+	/// Get the number of parameter events that are currently pending. This doesn't look at the params so it's cheap
+	/// enough for hosts to poll every frame.
 	FFUInt32 GetNumPendingParamEvents() const;
 	/// Consumes currently pending parameter events.
-	/// This function loops over the currently pending parameter events and writes out ParamEventStructs into the passed in events buffer.
-	/// It then resets the events that it has consumed so that the next consume call will not return the same events.
+	/// This function writes out ParamEventStructs for the pending parameter events, in the order in which they were first raised,
+	/// into the passed in events buffer. It then resets the events that it has consumed so that the next consume call will not return the same events.
 	///
 	/// \param events		The buffer into which param events should be written.
 	/// \param maxNumEvents	The maximum number of events that should be consumed.
 	/// \return				The number of events that were consumed. This may be smaller than maxNumEvents when there aren't any more pending events.
 	FFUInt32 ConsumeParamEvents( ParamEventStruct* events, FFUInt32 maxNumEvents );
 
+	/// Called by the sdk after it has constructed an instance. The first instance to finish, which is the prototype the sdk
+	/// creates when the host initialises the plugin, shares it's param schema with the instances that are created after it.
+	/// An instance that has registered different params than the shared schema gets a schema of it's own instead.
+	void FinishParamRegistration();
+	/// Called by the sdk when the host deinitialises the plugin, so that the params are registered again if the host
+	/// initialises it again. Instances that are still alive keep the schema they're using.
+	static void ReleaseSharedParamSchema();
+
 protected:
 	/// The standard constructor of CFFGLPluginManager.
 	///
@@ -346,6 +371,12 @@ protected:
 	///                        Probably you want to pass false during initialization and true when changing a display name while the plugin is running.
 	void SetParamDisplayName( unsigned int paramID, std::string newDisplayName, bool raiseEvent );
 
+	/// Replaces the elements of an option parameter.
+	///
+	/// \param dwIndex			Index of the option parameter whose elements have to be changed.
+	/// \param newElements		The names of the new elements.
+	/// \param elementValues		The values of the new elements, this needs to contain a value for each of the names in newElements.
+	/// \param raiseEvent		Whether or not an elements change event should be fired to make stateful hosts pick up the change.
 	void SetParamElements( unsigned int dwIndex, std::vector< std::string > newElements, const std::vector< float >& elementValues, bool raiseEvent );
 
 	/// Raises an event flag on a certain parameter. Calling this will store the event as being a pending event
@@ -356,10 +387,29 @@ protected:
 	///
 	/// \param paramID			Index of the parameter for which you want the event to be raised.
 	/// \param eventToRaise		The event flag to raise for the parameter. This has to be one of the FF_EVENT_FLAG_ flags.
+	///
+	/// RaiseParamEvent, SetParamVisibility, SetParamDisplayName and SetParamElements may be called from any thread, eg from
+	/// a worker thread that has finished loading something the parameter's options depend on.
 	void RaiseParamEvent( unsigned int paramID, FFUInt64 eventToRaise );
 
+	/// The names, types, defaults, ranges, groups and elements of the params are the same for every instance of a plugin,
+	/// so they're registered once and shared by all instances as an immutable schema. Only the state that can change per
+	/// instance, eg visibility, display names, buffer values and pending events, is kept per instance.
+	///
+	/// Instances that register their params after the schema has been shared only compare what they register against it,
+	/// which is cheap but still requires you to build the names and values you pass. If building those is expensive you
+	/// can call this first: it registers all params of the shared schema for this instance at once, so that you can skip
+	/// registering them yourself. This only works if your params don't depend on the instance.
+	///
+	///	if( !UseSharedParamSchema() )
+	///		RegisterParams();
+	///
+	/// \return				True if the params have been registered from the shared schema, false if you have to register them.
+	bool UseSharedParamSchema();
+
 protected:
-	// Structure for keeping information about each plugin parameter
+	// Structure for keeping information about each plugin parameter. It's part of the param schema, which is shared between
+	// instances, so it may only be changed through the CFFGLPluginManager functions.
 	struct ParamInfo
 	{
 		ParamInfo() :
@@ -367,9 +417,8 @@ protected:
 		{
 		}
 
-		unsigned int ID;        //!< The id is used to represent this parameter in communication between host and plugin.
-		std::string name;       //!< The name is shown by the host to the user to identify this plugin. It may also be used by the host for parameter serialization.
-		std::string displayName;//!< Override for the name shown by the host. Params should retain the same names for serialization, but display names can change as those aren't used for identification.
+		unsigned int ID; //!< The id is used to represent this parameter in communication between host and plugin.
+		std::string name;//!< The name is shown by the host to the user to identify this plugin. It may also be used by the host for parameter serialization.
 		unsigned int dwType;
 
 		// extra parameters
@@ -378,23 +427,23 @@ protected:
 			std::string name;
 			float value = 0.0f;
 		};
-		std::vector< Element > elements;
+		std::vector< Element > elements;//!< The param's initial elements, eg the options of an option param. Buffer params store their element values per instance instead.
 		struct ElementSeparator
 		{
 			unsigned int beforeIndex;
 		};
 		std::vector< ElementSeparator > elementSeparators;
+		unsigned int numBufferValues = 0;//!< The number of element values of FF_TYPE_BUFFER params.
+		unsigned int bufferOffset    = 0;//!< Where the param's element values start in the instance's buffer values.
 		unsigned int usage;
 
-		bool visibleInUI = true;
 		RangeStruct range;
 
 		float defaultFloatVal = 0.0f;
 		std::string defaultStringVal;
 		std::vector< std::string > supportedExtensions;//!< The extensions this parameter supports. Only used if dwType is FF_TYPE_FILE.
 
-		FFUInt64 pendingEventFlags = 0;//!< Event flags for events that are pending for the current parameter.
-		std::string groupName;         //!< Name for the param group this param is a member of. Empty for ungrouped.
+		std::string groupName;//!< Name for the param group this param is a member of. Empty for ungrouped.
 	};
 	enum class TextureOrientation
 	{
@@ -402,14 +451,93 @@ protected:
 		TOP_LEFT
 	};
 
+	/// Deprecated, use GetParamInfo to read a param's info and GetMutableParamInfo to change it. Changing a param's info through
+	/// the pointer this returns would also change it for the other instances that share the schema, so this gives this instance
+	/// a schema of it's own just like GetMutableParamInfo. That's also the overload non-const member functions end up calling.
 	ParamInfo* FindParamInfo( unsigned int ID );
 	const ParamInfo* FindParamInfo( unsigned int ID ) const;
+	/// Get a param's info to read it, which doesn't cost this instance a schema of it's own.
+	///
+	/// \param	paramID		The id of the param.
+	/// \return				The param's info, or nullptr if the param doesn't exist.
+	const ParamInfo* GetParamInfo( unsigned int paramID ) const;
+	/// Get a param's info to change it. If the schema is shared this instance gets a copy of it's own first, so only call this
+	/// if you're actually going to change something.
+	///
+	/// \param	paramID		The id of the param.
+	/// \return				The param's info, or nullptr if the param doesn't exist.
+	ParamInfo* GetMutableParamInfo( unsigned int paramID );
+	/// Get the current values of a buffer parameter's elements. The values are stored contiguously so that plugins can
+	/// copy or upload them in one go, GetNumParamElements returns how many values there are.
+	///
+	/// \param	paramID		The index of the buffer parameter.
+	/// \return				Pointer to the first element's value or nullptr if the parameter doesn't exist or isn't a buffer parameter.
+	const float* GetBufferParamValues( unsigned int paramID ) const;
 	/// Get the current texture orientation. Plugin subclasses that support the top-left texture orientation will call this
 	/// to know if the top-left orientation has been enabled by the host.
 	TextureOrientation GetTextureOrientation() const;
+	/// Get an estimate of the heap memory held by the parameters, eg their names, elements and buffer values. This is
+	/// included in the heap memory that's reported to hosts through FF_GET_INSTANCE_STATS.
+	///
+	/// \return				The number of bytes held by the parameters.
+	size_t GetParamHeapBytes() const;
 
 private:
-	std::vector< ParamInfo > params;
+	/// The params of a plugin, which don't change once the schema has been shared.
+	struct ParamSchema
+	{
+		std::vector< ParamInfo > params;
+		std::vector< unsigned int > denseParamIndices;                      //!< Index into params for each id. Plugins almost always use the ids 0...N-1 so this is where we find most params.
+		std::unordered_map< unsigned int, unsigned int > sparseParamIndices;//!< Index into params for ids that are too far out of range to fit in the dense table.
+		unsigned int numBufferValues = 0;                                   //!< The number of element values of all buffer params together.
+	};
+	/// The state of a param that can change per instance.
+	struct ParamState
+	{
+		FFUInt64 pendingEventFlags = 0;//!< Event flags for events that are pending for the current parameter.
+		bool visibleInUI           = true;
+		std::string displayName;                                      //!< Override for the name shown by the host. Params should retain the same names for serialization, but display names can change as those aren't used for identification.
+		std::unique_ptr< std::vector< ParamInfo::Element > > elements;//!< The instance's own elements once they've been changed, nullptr while it uses the schema's.
+	};
+
+	/// Adds the param and registers it's index so that GetParamInfo can find it without searching.
+	void AddParamInfo( ParamInfo&& paramInfo );
+	/// Finds the next param of the shared schema if it's the one that's being registered.
+	///
+	/// \return				The shared schema's param if it matches the id, name and type, nullptr otherwise. The caller
+	///						has to compare the rest of what it's registering and call ReuseSharedParam if that matches too.
+	const ParamInfo* FindSharedParam( unsigned int paramID, const char* name, unsigned int type ) const;
+	/// Registers the next param of the shared schema for this instance instead of adding it.
+	void ReuseSharedParam();
+	/// Replaces the shared schema with a copy of the params this instance has registered so far, which it may change.
+	void UnshareParamSchema();
+	/// Registers the index of a param of our own schema for it's id, unless another param has already been registered with that id.
+	void IndexParam( ParamSchema& schema, unsigned int paramIndex );
+	/// Finds the index into the schema's params for a param that this instance has registered. Plugins may call this from
+	/// other threads while we're replacing the schema, so this looks the param up in a snapshot of the schema.
+	unsigned int FindParamIndex( unsigned int ID ) const;
+	/// Finds the index into the given schema's params for a param that this instance has registered.
+	unsigned int FindParamIndex( const ParamSchema& schema, unsigned int ID ) const;
+	/// The elements of a param, which are the schema's until this instance changes them. The caller has to hold paramStateMutex.
+	const std::vector< ParamInfo::Element >& GetParamElements( unsigned int paramIndex ) const;
+	/// Adds the event flags to the param's pending events and queues the param if it didn't have any pending events yet.
+	/// The caller has to hold paramStateMutex.
+	void AddPendingParamEvent( unsigned int paramIndex, FFUInt64 eventToRaise );
+
+	static const unsigned int NO_PARAM = ~0u;//!< Marks an entry of the dense id table that doesn't refer to any param.
+
+	static std::shared_ptr< const ParamSchema > sharedParamSchema;//!< The schema of the first instance that has finished registering it's params.
+	static std::mutex sharedParamSchemaMutex;
+
+	std::shared_ptr< const ParamSchema > paramSchema;//!< The schema this instance uses, either the shared one or it's own. Replaced with std::atomic_store as other threads may be reading it.
+	ParamSchema* ownParamSchema;                     //!< The same schema if this instance is the only one using it, in which case it may change it. nullptr while it's shared.
+	unsigned int numRegisteredParams;                //!< The number of the schema's params this instance has registered, the others don't exist for it yet.
+	std::vector< ParamState > paramStates;           //!< The state of each of the schema's params.
+	std::vector< float > bufferValues;               //!< The element values of all buffer params, kept contiguous so that they can be set and read in bulk.
+
+	mutable std::mutex paramStateMutex;                //!< Guards the param state that plugins may change from other threads: visibility, display names, option elements and pending events.
+	std::vector< unsigned int > pendingEventParams;    //!< Index into the schema's params for each param that has pending events, in the order in which the events were raised.
+	std::atomic< FFUInt32 > numPendingEventParams{ 0 };//!< Size of pendingEventParams, readable without locking so that polling for events is free when there are none.
 
 	// Inputs
 	int m_iMinInputs;
@@ -43,6 +43,11 @@ CFFGLPlugin::~CFFGLPlugin()
 {
 }
 
+void SetPluginInstanceSize( CFFGLPlugin* instance, size_t size )
+{
+	instance->instanceStats.SetInstanceSize( size );
+}
+
 ////////////////////////////////////////////////////////
 // Default implementation of CFFGLPlugin methods
 ////////////////////////////////////////////////////////
@@ -87,6 +92,30 @@ char* CFFGLPlugin::GetTextParameter( unsigned int index )
 	return (char*)FF_FAIL;
 }
 
+FFResult CFFGLPlugin::SetParameters( const SetParameterStruct* parameters, FFUInt32 numParameters )
+{
+	FFResult result = FF_SUCCESS;
+	for( FFUInt32 index = 0; index < numParameters; ++index )
+	{
+		const SetParameterStruct& parameter = parameters[ index ];
+		unsigned int paramType              = GetParamType( parameter.ParameterNumber );
+		FFResult paramResult;
+		if( paramType == FF_TYPE_TEXT || paramType == FF_TYPE_FILE )
+			paramResult = SetTextParameter( parameter.ParameterNumber, (const char*)parameter.NewParameterValue.PointerValue );
+		else
+			paramResult = SetFloatParameter( parameter.ParameterNumber, *(float*)&parameter.NewParameterValue.UIntValue );
+		if( paramResult != FF_SUCCESS )
+			result = FF_FAIL;
+	}
+	return result;
+}
+
+void CFFGLPlugin::GetInstanceStats( InstanceStatsStruct& stats )
+{
+	instanceStats.GetStats( stats );
+	stats.numHeapBytes += GetParamHeapBytes();
+}
+
 FFResult CFFGLPlugin::GetInputStatus( unsigned int index )
 {
 	if( index >= GetMaxInputs() )
@@ -22,6 +22,7 @@
 
 #include "FFGLPluginManager.h"
 #include "FFGLPluginInfo.h"
+#include "FFGLInstanceStats.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// \class		CFFGLPlugin
@@ -87,6 +88,15 @@ public:
 	virtual FFResult SetTextParameter( unsigned int index, const char* value );
 	virtual float GetFloatParameter( unsigned int index );
 	virtual char* GetTextParameter( unsigned int index );
+	/// Default implementation of FF_SET_PARAMETERS, which hosts use to set many parameters with a single call. This
+	/// implementation just calls SetFloatParameter or SetTextParameter for each of the parameters, plugins that can apply
+	/// a batch of parameters more efficiently than one at a time may override this.
+	///
+	/// \param		parameters		The parameters to set, in the order in which they should be applied.
+	/// \param		numParameters	The number of entries in the parameters array.
+	/// \return					FF_SUCCESS if all parameters have been set, FF_FAIL if setting any of them failed.
+	///							Parameters that come after a parameter that failed are still applied.
+	virtual FFResult SetParameters( const SetParameterStruct* parameters, FFUInt32 numParameters );
 
 	void SetParamInfof( unsigned int index, const char* pchName, unsigned int type )
 	{
@@ -166,9 +176,18 @@ public:
 		return FF_SUCCESS;
 	}
 
+	/// Fills the stats that hosts query with FF_GET_INSTANCE_STATS. The sdk collects these for every instance, see
+	/// FFGLInstanceStats for how a plugin can report what it uploads and allocates with direct gl calls.
+	///
+	/// \param		stats		The host provided struct to fill.
+	void GetInstanceStats( InstanceStatsStruct& stats );
+
 	/// This flag indicates that Connect has been called by the host, or automatically called by FFGL
 	bool m_isConnected;
 
+	/// What this instance costs to run, collected by the sdk around the host's calls into the instance.
+	FFGLInstanceStats instanceStats;
+
 	/// The only public data field CFFGLPlugin contains is m_pPlugin, a pointer to the plugin instance.
 	/// Subclasses may use this pointer for self-referencing (e.g., a plugin may pass this pointer to external modules,
 	/// so that they can use it for calling the plugin methods).
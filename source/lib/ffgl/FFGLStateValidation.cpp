@@ -0,0 +1,212 @@
+#include "FFGLStateValidation.h"
+#include "FFGL.h"
+#include <stdlib.h>
+#include <atomic>
+#include <vector>
+
+static const unsigned int DEFAULT_QUERY_INTERVAL = 60;
+static const int NO_QUERY_INTERVAL               = -1;//!< The query interval until it's been configured.
+
+struct ShadowTextureBinding
+{
+	GLenum textureUnit;
+	GLenum target;
+	GLuint textureID;
+};
+struct ShadowBufferBinding
+{
+	GLenum target;
+	GLuint index;  //!< The binding point within the target for indexed bindings.
+	bool isIndexed;//!< Whether or not this is the indexed binding point, or the target's generic binding point.
+	GLuint bufferID;
+};
+/**
+ * The bindings the scoped bindings have made on a thread. Textures and buffers that aren't listed are unbound.
+ */
+struct ShadowState
+{
+	GLuint bindings[ FFGLStateValidation::NUM_BINDINGS ] = { 0, 0, 0, GL_TEXTURE0, 0, 0 };//!< In the order of FFGLStateValidation::Binding.
+	std::vector< ShadowTextureBinding > textures;
+	std::vector< ShadowBufferBinding > buffers;
+};
+
+static thread_local ShadowState s_shadow;
+static std::atomic< int > s_queryInterval( NO_QUERY_INTERVAL );
+static std::atomic< unsigned int > s_numFrames( 0 );
+
+static GLuint* FindShadowBuffer( GLenum target, GLuint index, bool isIndexed )
+{
+	for( ShadowBufferBinding& binding : s_shadow.buffers )
+	{
+		if( binding.target == target && binding.index == index && binding.isIndexed == isIndexed )
+			return &binding.bufferID;
+	}
+	ShadowBufferBinding binding;
+	binding.target    = target;
+	binding.index     = index;
+	binding.isIndexed = isIndexed;
+	binding.bufferID  = 0;
+	s_shadow.buffers.push_back( binding );
+	return &s_shadow.buffers.back().bufferID;
+}
+
+/**
+ * Resets this thread's shadow to the state the host calls ProcessOpenGL with: everything unbound except for the host's fbo.
+ *
+ * @param hostFBO: The fbo the host has bound, available in ProcessOpenGLStruct::HostFBO.
+ */
+void FFGLStateValidation::BeginFrame( GLuint hostFBO )
+{
+#if defined( FFGL_DEBUG )
+	for( GLuint& binding : s_shadow.bindings )
+		binding = 0;
+	s_shadow.bindings[ BINDING_ACTIVE_TEXTURE ] = GL_TEXTURE0;
+	s_shadow.bindings[ BINDING_DRAW_FBO ]       = hostFBO;
+	s_shadow.bindings[ BINDING_READ_FBO ]       = hostFBO;
+	s_shadow.textures.clear();
+	s_shadow.buffers.clear();
+#else
+	(void)hostFBO;
+#endif
+}
+/**
+ * Called by the scoped bindings when they bind, and when they restore the previous binding at the end of their scope.
+ */
+void FFGLStateValidation::SetBinding( Binding binding, GLuint value )
+{
+#if defined( FFGL_DEBUG )
+	s_shadow.bindings[ binding ] = value;
+#else
+	(void)binding;
+	(void)value;
+#endif
+}
+/**
+ * Called by the scoped texture bindings, which bind to the texture unit that's active in the shadow.
+ */
+void FFGLStateValidation::SetTextureBinding( GLenum target, GLuint textureID )
+{
+#if defined( FFGL_DEBUG )
+	GLenum textureUnit = s_shadow.bindings[ BINDING_ACTIVE_TEXTURE ];
+	for( ShadowTextureBinding& binding : s_shadow.textures )
+	{
+		if( binding.textureUnit == textureUnit && binding.target == target )
+		{
+			binding.textureID = textureID;
+			return;
+		}
+	}
+	ShadowTextureBinding binding;
+	binding.textureUnit = textureUnit;
+	binding.target      = target;
+	binding.textureID   = textureID;
+	s_shadow.textures.push_back( binding );
+#else
+	(void)target;
+	(void)textureID;
+#endif
+}
+/**
+ * Called by the scoped buffer bindings when they bind to a target's generic binding point.
+ */
+void FFGLStateValidation::SetBufferBinding( GLenum target, GLuint bufferID )
+{
+#if defined( FFGL_DEBUG )
+	*FindShadowBuffer( target, 0, false ) = bufferID;
+#else
+	(void)target;
+	(void)bufferID;
+#endif
+}
+/**
+ * Called by the scoped buffer bindings when they bind to an indexed binding point. Just like glBindBufferBase this
+ * also binds the buffer to the target's generic binding point.
+ */
+void FFGLStateValidation::SetIndexedBufferBinding( GLenum target, GLuint index, GLuint bufferID )
+{
+#if defined( FFGL_DEBUG )
+	*FindShadowBuffer( target, index, true ) = bufferID;
+	*FindShadowBuffer( target, 0, false )    = bufferID;
+#else
+	(void)target;
+	(void)index;
+	(void)bufferID;
+#endif
+}
+/**
+ * The shadow of a binding on this thread, which is what the scoped bindings have bound. Always the default state in
+ * release builds as the shadow isn't tracked there.
+ */
+GLuint FFGLStateValidation::GetBinding( Binding binding )
+{
+	return s_shadow.bindings[ binding ];
+}
+/**
+ * Whether or not this thread's shadow is in FFGL's default state, in which case the scoped bindings have restored all
+ * bindings they've changed. Always true in release builds as the shadow isn't tracked there.
+ *
+ * @param hostFBO: The fbo the host had bound when it called into the plugin.
+ */
+bool FFGLStateValidation::IsDefaultState( GLuint hostFBO )
+{
+#if defined( FFGL_DEBUG )
+	const GLuint* bindings = s_shadow.bindings;
+	if( bindings[ BINDING_PROGRAM ] != 0 || bindings[ BINDING_VAO ] != 0 || bindings[ BINDING_RENDERBUFFER ] != 0 )
+		return false;
+	if( bindings[ BINDING_ACTIVE_TEXTURE ] != GL_TEXTURE0 )
+		return false;
+	if( bindings[ BINDING_DRAW_FBO ] != hostFBO || bindings[ BINDING_READ_FBO ] != hostFBO )
+		return false;
+	for( const ShadowTextureBinding& binding : s_shadow.textures )
+	{
+		if( binding.textureID != 0 )
+			return false;
+	}
+	for( const ShadowBufferBinding& binding : s_shadow.buffers )
+	{
+		if( binding.bufferID != 0 )
+			return false;
+	}
+#else
+	(void)hostFBO;
+#endif
+	return true;
+}
+
+/**
+ * Sets how often the context is queried to validate that it has been returned in it's default state.
+ *
+ * @param numFrames: The context is queried on every numFrames'th frame, 1 to query it on every frame, 0 to only validate
+ * the shadow state. Calling this overrides the FFGL_STATE_QUERY_INTERVAL environment variable.
+ */
+void FFGLStateValidation::SetQueryInterval( unsigned int numFrames )
+{
+	s_queryInterval = (int)numFrames;
+}
+/**
+ * The number of frames between context queries. This is the interval that was set with SetQueryInterval, or the
+ * FFGL_STATE_QUERY_INTERVAL environment variable if no interval has been set.
+ */
+unsigned int FFGLStateValidation::GetQueryInterval()
+{
+	int queryInterval = s_queryInterval.load();
+	if( queryInterval != NO_QUERY_INTERVAL )
+		return (unsigned int)queryInterval;
+
+	const char* environmentInterval = getenv( "FFGL_STATE_QUERY_INTERVAL" );
+	queryInterval                   = environmentInterval != nullptr ? atoi( environmentInterval ) : (int)DEFAULT_QUERY_INTERVAL;
+	if( queryInterval < 0 )
+		queryInterval = (int)DEFAULT_QUERY_INTERVAL;
+	s_queryInterval = queryInterval;
+	return (unsigned int)queryInterval;
+}
+/**
+ * Counts a frame of any of the plugin's instances, and returns whether or not the context should be queried on it.
+ * The first frame is always queried so that a plugin that doesn't restore the context is caught right away.
+ */
+bool FFGLStateValidation::ShouldQueryContext()
+{
+	unsigned int queryInterval = GetQueryInterval();
+	unsigned int frame         = s_numFrames++;
+	return queryInterval != 0 && frame % queryInterval == 0;
+}
\ No newline at end of file
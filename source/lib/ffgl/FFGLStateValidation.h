@@ -0,0 +1,41 @@
+#pragma once
+#include "FFGL.h"//For OpenGL
+
+/**
+ * The host calls into the plugin with the context in it's default state, and the plugin has to return it in the default state.
+ * Debug builds validate this before and after every InitGL, ProcessOpenGL and DeInitGL call. Querying all of the context's state
+ * stalls the driver hundreds of times per call though, so while processing frames we validate a shadow of the bindings instead,
+ * which doesn't need any gl calls. The context itself is only queried once every so many frames.
+ *
+ * The shadow is kept by the ffglex scoped bindings, which report what they bind and what they restore at the end of their scope,
+ * whether or not an FFGLStateCache is active. When the plugin returns to the host the shadow has to be in the default state: no
+ * program, vao, renderbuffer, textures or buffers bound, GL_TEXTURE0 active and the host's fbo bound for drawing and reading.
+ * State that's changed with direct gl calls isn't in the shadow. On the frames on which the context is queried we compare the
+ * shadow to what the context actually has bound, so that's caught there.
+ */
+class FFGLStateValidation
+{
+public:
+	enum Binding
+	{
+		BINDING_PROGRAM,
+		BINDING_VAO,
+		BINDING_RENDERBUFFER,
+		BINDING_ACTIVE_TEXTURE,
+		BINDING_DRAW_FBO,
+		BINDING_READ_FBO,
+		NUM_BINDINGS
+	};
+
+	static void BeginFrame( GLuint hostFBO );                                           //Resets this thread's shadow to the state the host calls ProcessOpenGL with.
+	static void SetBinding( Binding binding, GLuint value );                            //Called by the scoped bindings when they bind or restore. Only tracked in debug builds.
+	static void SetTextureBinding( GLenum target, GLuint textureID );                   //Called by the scoped texture bindings. Only tracked in debug builds.
+	static void SetBufferBinding( GLenum target, GLuint bufferID );                     //Called by the scoped buffer bindings. Only tracked in debug builds.
+	static void SetIndexedBufferBinding( GLenum target, GLuint index, GLuint bufferID );//Called by the scoped buffer bindings for indexed targets. Only tracked in debug builds.
+	static GLuint GetBinding( Binding binding );                                        //The shadow of a binding on this thread.
+	static bool IsDefaultState( GLuint hostFBO );                                       //Whether or not this thread's shadow is in the default state.
+
+	static void SetQueryInterval( unsigned int numFrames );//Query the context on every numFrames'th frame, 1 to query it on every frame, 0 to never query it.
+	static unsigned int GetQueryInterval();                //The number of frames between context queries.
+	static bool ShouldQueryContext();                      //Counts a frame and returns whether or not the context should be queried on it.
+};
\ No newline at end of file
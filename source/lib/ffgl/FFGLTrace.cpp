@@ -0,0 +1,467 @@
+#include "FFGLTrace.h"
+#include "FFGL.h"
+#include "FFGLLog.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#if defined( FFGL_MACOS )
+#include <pthread.h>
+#elif defined( FFGL_LINUX )
+#include <sys/syscall.h>
+#endif
+#if !defined( FFGL_WINDOWS )
+#include <unistd.h>
+#endif
+
+static const uint32_t TRACE_BUFFER_SIZE        = 8192;//!< The number of events a thread can record before the writer has to catch up. Has to be a power of two.
+static const unsigned int TRACE_WRITE_INTERVAL = 100; //!< How often the writer writes the recorded events to the file, in milliseconds.
+
+struct TraceEvent
+{
+	const char* category;
+	const char* name;
+	const void* instance;
+	uint64_t beginTime;
+	uint64_t duration;
+};
+/**
+ * The events of one thread. Only that thread records into it and only the writer reads from it, so the indices are all the
+ * synchronisation that's needed. The indices keep counting up, they're wrapped into the ring when they're used.
+ */
+struct TraceThreadBuffer
+{
+	uint64_t threadID;
+	std::atomic< uint32_t > writeIndex;//!< The index the thread records the next event at.
+	std::atomic< uint32_t > readIndex; //!< The index of the oldest event the writer hasn't written yet.
+	TraceEvent events[ TRACE_BUFFER_SIZE ];
+};
+struct TraceData
+{
+	~TraceData();
+
+	std::mutex controlMutex;//!< Serialises starting and stopping the trace.
+	std::mutex buffersMutex;//!< Guards threadBuffers, which threads register to when they record their first event.
+	std::vector< std::shared_ptr< TraceThreadBuffer > > threadBuffers;
+	FILE* file                        = nullptr;
+	bool isFirstEvent                 = true;//!< Whether or not the next event is the first of the file, all others are preceded by a comma.
+	uint64_t processID                = 0;
+	unsigned int numEnvironmentTraces = 0;//!< The number of traces that have been started from the environment, so that they get unique file names.
+
+	std::thread writerThread;
+	std::mutex writerMutex;
+	std::condition_variable writerCondition;
+	bool isStopRequested = false;
+};
+
+static std::atomic< bool > s_isEnabled( false );
+static std::atomic< uint64_t > s_numDroppedEvents( 0 );
+static thread_local std::shared_ptr< TraceThreadBuffer > s_threadBuffer;
+
+static TraceData& GetTraceData()
+{
+	static TraceData data;
+	return data;
+}
+static uint64_t GetTraceProcessID()
+{
+#if defined( FFGL_WINDOWS )
+	return (uint64_t)GetCurrentProcessId();
+#else
+	return (uint64_t)getpid();
+#endif
+}
+static uint64_t GetTraceThreadID()
+{
+#if defined( FFGL_WINDOWS )
+	return (uint64_t)GetCurrentThreadId();
+#elif defined( FFGL_MACOS )
+	uint64_t threadID = 0;
+	pthread_threadid_np( nullptr, &threadID );
+	return threadID;
+#else
+	return (uint64_t)syscall( SYS_gettid );
+#endif
+}
+/**
+ * The buffer the calling thread records it's events into. It's created and registered to the writer when the thread records
+ * it's first event, so threads that never record anything don't cost any memory.
+ */
+static TraceThreadBuffer* GetThreadBuffer()
+{
+	if( !s_threadBuffer )
+	{
+		std::shared_ptr< TraceThreadBuffer > threadBuffer = std::make_shared< TraceThreadBuffer >();
+		threadBuffer->threadID                            = GetTraceThreadID();
+		threadBuffer->writeIndex                          = 0;
+		threadBuffer->readIndex                           = 0;
+
+		TraceData& data = GetTraceData();
+		std::lock_guard< std::mutex > lock( data.buffersMutex );
+		data.threadBuffers.push_back( threadBuffer );
+		s_threadBuffer = threadBuffer;
+	}
+	return s_threadBuffer.get();
+}
+
+static void WriteString( FILE* file, const char* string )
+{
+	fputc( '"', file );
+	for( const char* character = string; *character != '\0'; ++character )
+	{
+		if( *character == '"' || *character == '\\' )
+			fputc( '\\', file );
+		if( (unsigned char)*character >= 0x20 )
+			fputc( *character, file );
+	}
+	fputc( '"', file );
+}
+/**
+ * Writes a complete event. Timestamps are written in microseconds, with the nanoseconds as decimals so that we
+ * don't lose any precision converting them to floating point.
+ */
+static void WriteEvent( TraceData& data, uint64_t threadID, const TraceEvent& event )
+{
+	fputs( data.isFirstEvent ? "\n" : ",\n", data.file );
+	data.isFirstEvent = false;
+
+	fputs( "{\"name\":", data.file );
+	WriteString( data.file, event.name );
+	fputs( ",\"cat\":", data.file );
+	WriteString( data.file, event.category );
+	fprintf( data.file, ",\"ph\":\"X\",\"ts\":%llu.%03u,\"dur\":%llu.%03u,\"pid\":%llu,\"tid\":%llu",
+		(unsigned long long)( event.beginTime / 1000 ), (unsigned int)( event.beginTime % 1000 ),
+		(unsigned long long)( event.duration / 1000 ), (unsigned int)( event.duration % 1000 ),
+		(unsigned long long)data.processID, (unsigned long long)threadID );
+	if( event.instance != nullptr )
+		fprintf( data.file, ",\"args\":{\"instance\":\"%p\"}", event.instance );
+	fputs( "}", data.file );
+}
+/**
+ * Writes all events the threads have recorded since the previous call. Only one thread may do this at a time,
+ * which is the writer thread while it's running.
+ */
+static void WriteRecordedEvents( TraceData& data )
+{
+	std::vector< std::shared_ptr< TraceThreadBuffer > > threadBuffers;
+	{
+		std::lock_guard< std::mutex > lock( data.buffersMutex );
+		threadBuffers = data.threadBuffers;
+	}
+
+	for( const std::shared_ptr< TraceThreadBuffer >& threadBuffer : threadBuffers )
+	{
+		uint32_t readIndex  = threadBuffer->readIndex.load( std::memory_order_relaxed );
+		uint32_t writeIndex = threadBuffer->writeIndex.load( std::memory_order_acquire );
+		for( ; readIndex != writeIndex; ++readIndex )
+			WriteEvent( data, threadBuffer->threadID, threadBuffer->events[ readIndex % TRACE_BUFFER_SIZE ] );
+		threadBuffer->readIndex.store( readIndex, std::memory_order_release );
+	}
+	fflush( data.file );
+
+	//The buffers of threads that have exited are only referenced by us, once we've written their events we can let go of them.
+	threadBuffers.clear();
+	std::lock_guard< std::mutex > lock( data.buffersMutex );
+	for( size_t index = 0; index < data.threadBuffers.size(); )
+	{
+		const std::shared_ptr< TraceThreadBuffer >& threadBuffer = data.threadBuffers[ index ];
+		if( threadBuffer.use_count() == 1 && threadBuffer->readIndex.load() == threadBuffer->writeIndex.load() )
+			data.threadBuffers.erase( data.threadBuffers.begin() + index );
+		else
+			++index;
+	}
+}
+static void RunWriter( TraceData* data )
+{
+	std::unique_lock< std::mutex > lock( data->writerMutex );
+	while( !data->isStopRequested )
+	{
+		data->writerCondition.wait_for( lock, std::chrono::milliseconds( TRACE_WRITE_INTERVAL ) );
+		lock.unlock();
+		WriteRecordedEvents( *data );
+		lock.lock();
+	}
+}
+/**
+ * Stops the writer thread and closes the file once all recorded events have been written. The caller needs to hold the control mutex.
+ */
+static void StopWriting( TraceData& data )
+{
+	if( data.file == nullptr )
+		return;
+
+	s_isEnabled = false;
+	{
+		std::lock_guard< std::mutex > lock( data.writerMutex );
+		data.isStopRequested = true;
+	}
+	data.writerCondition.notify_one();
+	data.writerThread.join();
+
+	WriteRecordedEvents( data );
+	fputs( "\n]\n", data.file );
+	fclose( data.file );
+	data.file = nullptr;
+}
+
+TraceData::~TraceData()
+{
+	//Hosts call FF_DEINITIALISE before unloading us, which has already stopped the trace. Joining the writer while the library
+	//is being unloaded could deadlock on Windows, so this is only a fallback for when the host didn't.
+	StopWriting( *this );
+}
+
+/**
+ * Starts recording events and writing them to a file. Recording stops when you call Stop, or when the host deinitialises the plugin.
+ *
+ * @param filePath: The file to write the events to, it's replaced if it exists already.
+ * @return: Whether or not tracing has started. False if the file can't be created, or if tracing has already been started.
+ */
+bool FFGLTrace::Start( const std::string& filePath )
+{
+	TraceData& data = GetTraceData();
+	std::lock_guard< std::mutex > lock( data.controlMutex );
+	if( data.file != nullptr )
+		return false;
+
+	data.file = fopen( filePath.c_str(), "w" );
+	if( data.file == nullptr )
+	{
+		FFGLLog::LogToHost( ( "Failed to create trace file " + filePath ).c_str() );
+		return false;
+	}
+	//The Chrome trace viewer also accepts an array without it's closing bracket, so the file is still usable if we never get to Stop.
+	fputs( "[", data.file );
+	data.isFirstEvent    = true;
+	data.processID       = GetTraceProcessID();
+	data.isStopRequested = false;
+
+	//Threads may have recorded events after the previous trace has been written, those don't belong in this one.
+	{
+		std::lock_guard< std::mutex > buffersLock( data.buffersMutex );
+		for( const std::shared_ptr< TraceThreadBuffer >& threadBuffer : data.threadBuffers )
+			threadBuffer->readIndex = threadBuffer->writeIndex.load();
+	}
+
+	data.writerThread = std::thread( RunWriter, &data );
+	s_isEnabled       = true;
+	return true;
+}
+/**
+ * Starts tracing if the FFGL_TRACE_DIR environment variable points to a directory. The sdk calls this when the host initialises
+ * the plugin, the file is named after the plugin and the host's process so that every plugin that's loaded has it's own trace.
+ *
+ * @param pluginID: The plugin's unique id.
+ * @return: Whether or not tracing has started.
+ */
+bool FFGLTrace::StartFromEnvironment( const std::string& pluginID )
+{
+	const char* environmentDirectory = getenv( "FFGL_TRACE_DIR" );
+	if( environmentDirectory == nullptr || *environmentDirectory == '\0' || IsEnabled() )
+		return false;
+
+	//The id may contain any character, only keep the ones that are safe to use in a file name.
+	std::string fileID;
+	for( char character : pluginID )
+		fileID += isalnum( (unsigned char)character ) ? character : '_';
+
+	TraceData& data = GetTraceData();
+	char fileName[ 64 ];
+	snprintf( fileName, sizeof( fileName ), "ffgl-trace-%s-%llu-%u.json", fileID.c_str(), (unsigned long long)GetTraceProcessID(), data.numEnvironmentTraces++ );
+	return Start( std::string( environmentDirectory ) + "/" + fileName );
+}
+/**
+ * Stops recording events, and closes the file after all events that have been recorded have been written to it.
+ */
+void FFGLTrace::Stop()
+{
+	TraceData& data = GetTraceData();
+	std::lock_guard< std::mutex > lock( data.controlMutex );
+	StopWriting( data );
+}
+bool FFGLTrace::IsEnabled()
+{
+	return s_isEnabled.load( std::memory_order_relaxed );
+}
+
+/**
+ * Records a zone in the calling thread's buffer, without any locking. Usually you'd use an FFGLTraceZone instead.
+ *
+ * @param category: The category of the zone, eg "plugMain" for the host's calls into the plugin.
+ * @param name: The name of the zone. The name and category have to stay valid until tracing is stopped, so use string literals.
+ * @param instance: The plugin instance the zone belongs to, nullptr if it doesn't belong to an instance.
+ * @param beginTime: When the zone began, from GetTime.
+ */
+void FFGLTrace::AddZone( const char* category, const char* name, const void* instance, uint64_t beginTime )
+{
+	if( !IsEnabled() )
+		return;
+
+	uint64_t endTime                = GetTime();
+	TraceThreadBuffer* threadBuffer = GetThreadBuffer();
+	uint32_t writeIndex             = threadBuffer->writeIndex.load( std::memory_order_relaxed );
+	if( writeIndex - threadBuffer->readIndex.load( std::memory_order_acquire ) >= TRACE_BUFFER_SIZE )
+	{
+		s_numDroppedEvents++;
+		return;
+	}
+
+	TraceEvent& event = threadBuffer->events[ writeIndex % TRACE_BUFFER_SIZE ];
+	event.category    = category;
+	event.name        = name;
+	event.instance    = instance;
+	event.beginTime   = beginTime;
+	event.duration    = endTime > beginTime ? endTime - beginTime : 0;
+	threadBuffer->writeIndex.store( writeIndex + 1, std::memory_order_release );
+}
+/**
+ * The current time of the trace clock in nanoseconds. It's a monotonic clock that's shared by all plugins in the process,
+ * so that the traces of several plugins can be viewed side by side.
+ */
+uint64_t FFGLTrace::GetTime()
+{
+	return (uint64_t)std::chrono::duration_cast< std::chrono::nanoseconds >( std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+const char* FFGLTrace::GetFunctionName( uint32_t functionCode )
+{
+	switch( functionCode )
+	{
+	case FF_GET_INFO:
+		return "FF_GET_INFO";
+	case FF_INITIALISE_V2:
+		return "FF_INITIALISE_V2";
+	case FF_DEINITIALISE:
+		return "FF_DEINITIALISE";
+	case FF_GET_NUM_PARAMETERS:
+		return "FF_GET_NUM_PARAMETERS";
+	case FF_GET_PARAMETER_NAME:
+		return "FF_GET_PARAMETER_NAME";
+	case FF_GET_PARAMETER_DEFAULT:
+		return "FF_GET_PARAMETER_DEFAULT";
+	case FF_GET_PARAMETER_DISPLAY:
+		return "FF_GET_PARAMETER_DISPLAY";
+	case FF_SET_PARAMETER:
+		return "FF_SET_PARAMETER";
+	case FF_GET_PARAMETER:
+		return "FF_GET_PARAMETER";
+	case FF_GET_PLUGIN_CAPS:
+		return "FF_GET_PLUGIN_CAPS";
+	case FF_ENABLE_PLUGIN_CAP:
+		return "FF_ENABLE_PLUGIN_CAP";
+	case FF_GET_EXTENDED_INFO:
+		return "FF_GET_EXTENDED_INFO";
+	case FF_GET_PARAMETER_TYPE:
+		return "FF_GET_PARAMETER_TYPE";
+	case FF_GET_INPUT_STATUS:
+		return "FF_GET_INPUT_STATUS";
+	case FF_PROCESS_OPENGL:
+		return "FF_PROCESS_OPENGL";
+	case FF_INSTANTIATE_GL:
+		return "FF_INSTANTIATE_GL";
+	case FF_DEINSTANTIATE_GL:
+		return "FF_DEINSTANTIATE_GL";
+	case FF_SET_TIME:
+		return "FF_SET_TIME";
+	case FF_CONNECT:
+		return "FF_CONNECT";
+	case FF_DISCONNECT:
+		return "FF_DISCONNECT";
+	case FF_RESIZE:
+		return "FF_RESIZE";
+	case FF_GET_NUM_PARAMETER_ELEMENTS:
+		return "FF_GET_NUM_PARAMETER_ELEMENTS";
+	case FF_GET_PARAMETER_ELEMENT_NAME:
+		return "FF_GET_PARAMETER_ELEMENT_NAME";
+	case FF_GET_PARAMETER_ELEMENT_VALUE:
+		return "FF_GET_PARAMETER_ELEMENT_VALUE";
+	case FF_SET_PARAMETER_ELEMENT_VALUE:
+		return "FF_SET_PARAMETER_ELEMENT_VALUE";
+	case FF_GET_PARAMETER_USAGE:
+		return "FF_GET_PARAMETER_USAGE";
+	case FF_GET_PLUGIN_SHORT_NAME:
+		return "FF_GET_PLUGIN_SHORT_NAME";
+	case FF_SET_BEATINFO:
+		return "FF_SET_BEATINFO";
+	case FF_SET_HOSTINFO:
+		return "FF_SET_HOSTINFO";
+	case FF_SET_SAMPLERATE:
+		return "FF_SET_SAMPLERATE";
+	case FF_GET_RANGE:
+		return "FF_GET_RANGE";
+	case FF_GET_PARAM_GROUP:
+		return "FF_GET_PARAM_GROUP";
+	case FF_GET_PARAM_DISPLAY_NAME:
+		return "FF_GET_PARAM_DISPLAY_NAME";
+	case FF_GET_THUMBNAIL:
+		return "FF_GET_THUMBNAIL";
+	case FF_GET_NUM_FILE_PARAMETER_EXTENSIONS:
+		return "FF_GET_NUM_FILE_PARAMETER_EXTENSIONS";
+	case FF_GET_FILE_PARAMETER_EXTENSION:
+		return "FF_GET_FILE_PARAMETER_EXTENSION";
+	case FF_GET_PRAMETER_VISIBILITY:
+		return "FF_GET_PRAMETER_VISIBILITY";
+	case FF_GET_PARAMETER_EVENTS:
+		return "FF_GET_PARAMETER_EVENTS";
+	case FF_GET_NUM_ELEMENT_SEPARATORS:
+		return "FF_GET_NUM_ELEMENT_SEPARATORS";
+	case FF_GET_SEPARATOR_ELEMENT_INDEX:
+		return "FF_GET_SEPARATOR_ELEMENT_INDEX";
+	case FF_SET_PARAMETERS:
+		return "FF_SET_PARAMETERS";
+	case FF_SET_PARAMETER_ELEMENT_VALUES:
+		return "FF_SET_PARAMETER_ELEMENT_VALUES";
+	case FF_GET_INSTANCE_STATS:
+		return "FF_GET_INSTANCE_STATS";
+	default:
+		return "FF_UNKNOWN_FUNCTION";
+	}
+}
+/**
+ * The number of events that didn't fit in their thread's buffer because the writer couldn't keep up. The events of the zones that
+ * ended while the buffer was full are missing from the trace.
+ */
+uint64_t FFGLTrace::GetNumDroppedEvents()
+{
+	return s_numDroppedEvents.load();
+}
+
+/**
+ * Starts a zone if tracing is enabled, the zone ends when we're destructed.
+ *
+ * @param name: The name of the zone. It has to stay valid until tracing is stopped, so use a string literal.
+ * @param instance: The plugin instance the zone belongs to, eg this.
+ */
+FFGLTraceZone::FFGLTraceZone( const char* name, const void* instance ) :
+	category( "zone" ),
+	name( FFGLTrace::IsEnabled() ? name : nullptr ),
+	instance( instance ),
+	beginTime( this->name != nullptr ? FFGLTrace::GetTime() : 0 )
+{
+}
+FFGLTraceZone::FFGLTraceZone( uint32_t functionCode, const void* instance ) :
+	category( "plugMain" ),
+	name( FFGLTrace::IsEnabled() ? FFGLTrace::GetFunctionName( functionCode ) : nullptr ),
+	instance( instance ),
+	beginTime( name != nullptr ? FFGLTrace::GetTime() : 0 )
+{
+}
+FFGLTraceZone::~FFGLTraceZone()
+{
+	EndScope();
+}
+
+void FFGLTraceZone::EndScope()
+{
+	if( name != nullptr )
+	{
+		FFGLTrace::AddZone( category, name, instance, beginTime );
+		name = nullptr;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,54 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+
+/**
+ * The FFGLTrace records how long the host's calls into the plugin take, so that you can see where the host's time goes. Every plugMain
+ * call is recorded per function code, instance and thread, along with the zones you've placed in your plugin:
+ *
+ *	FFGLTraceZone traceZone( "UpdateParticles", this );
+ *
+ * Events are written in the Chrome trace event format, open the file in chrome://tracing or https://ui.perfetto.dev to view it.
+ *
+ * Tracing is off by default. Start it with FFGLTrace::Start, or point the FFGL_TRACE_DIR environment variable to an existing directory
+ * to trace every plugin that's loaded, each into it's own file. While tracing is off a zone costs a single check of an atomic flag,
+ * so it's fine to keep the zones in release builds.
+ *
+ * Events are recorded into a buffer per thread without any locking, and a background thread writes them to the file. When a thread
+ * records events faster than they're written the events that don't fit are dropped, which you can see in GetNumDroppedEvents.
+ */
+class FFGLTrace
+{
+public:
+	static bool Start( const std::string& filePath );             //Start writing events to filePath. Returns false if the file can't be created.
+	static bool StartFromEnvironment( const std::string& pluginID );//Start writing events into the FFGL_TRACE_DIR directory, if that environment variable has been set.
+	static void Stop();                                           //Write the remaining events and close the file.
+	static bool IsEnabled();                                      //Whether or not events are being recorded.
+
+	static void AddZone( const char* category, const char* name, const void* instance, uint64_t beginTime );//Record a zone that began at beginTime and ends now.
+	static uint64_t GetTime();                                                                               //The current time of the trace clock in nanoseconds.
+
+	static const char* GetFunctionName( uint32_t functionCode );//The name of a plugMain function code, eg "FF_PROCESS_OPENGL".
+	static uint64_t GetNumDroppedEvents();                      //The number of events that didn't fit in their thread's buffer.
+};
+
+/**
+ * The FFGLTraceZone records the time between it's construction and destruction. The name and category have to stay valid
+ * until tracing is stopped, so use string literals.
+ */
+class FFGLTraceZone
+{
+public:
+	FFGLTraceZone( const char* name, const void* instance = nullptr );
+	FFGLTraceZone( uint32_t functionCode, const void* instance );//Used by plugMain to record the host's calls.
+	FFGLTraceZone( const FFGLTraceZone& ) = delete;
+	~FFGLTraceZone();
+
+	void EndScope();//Manually end the zone. The first time you call this the zone ends, consecutive calls have no effect.
+
+private:
+	const char* category;
+	const char* name;//!< nullptr if tracing was off when the zone began, in which case it's not recorded.
+	const void* instance;
+	uint64_t beginTime;
+};
\ No newline at end of file
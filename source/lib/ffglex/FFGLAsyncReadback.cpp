@@ -0,0 +1,193 @@
+#include "FFGLAsyncReadback.h"
+#include <assert.h>
+#include <string.h>
+#include "FFGLScopedBufferBinding.h"
+#include "FFGLScopedFBOBinding.h"
+#include "FFGLUtilities.h"
+#include "../ffgl/FFGLInstanceStats.h"
+
+namespace ffglex
+{
+FFGLAsyncReadback::FFGLAsyncReadback() :
+	width( 0 ),
+	height( 0 ),
+	format( 0 ),
+	type( 0 ),
+	frameSize( 0 ),
+	packAlignment( 4 ),
+	nextRequestBuffer( 0 ),
+	nextPollBuffer( 0 ),
+	numRequests( 0 ),
+	numDroppedRequests( 0 )
+{
+}
+FFGLAsyncReadback::~FFGLAsyncReadback()
+{
+	//If this assertion hits you forgot to release this readback.
+	assert( buffers.empty() );
+}
+
+/**
+ * Allocate the pixel pack buffers. This function needs to be called using an active OpenGL context,
+ * for example in your plugin's InitGL function.
+ *
+ * @param width: The width of the region to read in number of pixels.
+ * @param height: The height of the region to read in number of pixels.
+ * @param format: The format to read the pixels in, eg GL_RGBA or GL_RED.
+ * @param type: The type to read the pixels in, eg GL_UNSIGNED_BYTE or GL_FLOAT.
+ * @param numBuffers: The number of requests that can be waiting to be polled, before requests are dropped.
+ * @return: Whether or not initialising succeeded.
+ */
+bool FFGLAsyncReadback::Initialise( GLsizei width, GLsizei height, GLenum format, GLenum type, unsigned int numBuffers )
+{
+	//Cannot initialize if we're already initialized, please Release us first.
+	if( !buffers.empty() )
+		return false;
+
+	GLsizei bytesPerPixel = GetBytesPerPixel( format, type );
+	if( bytesPerPixel == 0 || width <= 0 || height <= 0 || numBuffers == 0 )
+		return false;
+
+	this->width       = width;
+	this->height      = height;
+	this->format      = format;
+	this->type        = type;
+	frameSize         = (GLsizeiptr)bytesPerPixel * width * height;
+	packAlignment     = ( bytesPerPixel * width ) % 4 == 0 ? 4 : 1;
+	nextRequestBuffer = 0;
+	nextPollBuffer    = 0;
+
+	for( unsigned int index = 0; index < numBuffers; ++index )
+	{
+		PixelBuffer buffer;
+		buffer.fence        = nullptr;
+		buffer.requestIndex = 0;
+		glGenBuffers( 1, &buffer.bufferID );
+		if( buffer.bufferID == 0 )
+		{
+			Release();
+			return false;
+		}
+		buffers.push_back( buffer );
+		FFGLInstanceStats::AddGLObjects( 1 );
+
+		ScopedBufferBinding bufferBinding( GL_PIXEL_PACK_BUFFER, buffer.bufferID );
+		glBufferData( GL_PIXEL_PACK_BUFFER, frameSize, NULL, GL_STREAM_READ );
+	}
+
+	return true;
+}
+/**
+ * Release all gl resources, requests that haven't been polled yet are lost. Call this before destruction if you've
+ * previously initialised us, usually from your plugin's DeInitGL.
+ */
+void FFGLAsyncReadback::Release()
+{
+	for( PixelBuffer& buffer : buffers )
+	{
+		if( buffer.fence != nullptr )
+			glDeleteSync( buffer.fence );
+		glDeleteBuffers( 1, &buffer.bufferID );
+	}
+	FFGLInstanceStats::AddGLObjects( -(int)buffers.size() );
+	buffers.clear();
+
+	width  = 0;
+	height = 0;
+}
+
+/**
+ * Queue a copy of the fbo's pixels into the next buffer. This returns right away, the gpu performs the copy once it has
+ * finished rendering what's been queued before. The fbo's read buffer is read, which is the first color attachment for
+ * an FFGLFBO. Resolve a multisampled FFGLFBO before requesting a copy of it.
+ *
+ * @param fboID: The fbo to read from, eg FFGLFBO::GetGLID or the host's fbo.
+ * @param x: The left edge of the region to read.
+ * @param y: The bottom edge of the region to read.
+ * @return: Whether or not the copy has been queued. A request is dropped when all buffers are still waiting to be polled.
+ */
+bool FFGLAsyncReadback::Request( GLuint fboID, GLint x, GLint y )
+{
+	if( buffers.empty() )
+		return false;
+
+	uint64_t requestIndex = numRequests++;
+	PixelBuffer& buffer   = buffers[ nextRequestBuffer ];
+	if( buffer.fence != nullptr )
+	{
+		numDroppedRequests++;
+		return false;
+	}
+
+	//With a pixel pack buffer bound the pixels argument of glReadPixels is an offset into the buffer, so the copy doesn't
+	//have to wait for the gpu. The scoped bindings return the context to the state it was in.
+	ScopedFBOBinding fboBinding( fboID, ScopedFBOBinding::RB_REVERT );
+	ScopedBufferBinding bufferBinding( GL_PIXEL_PACK_BUFFER, buffer.bufferID );
+	if( packAlignment != 4 )
+		glPixelStorei( GL_PACK_ALIGNMENT, packAlignment );
+	glReadPixels( x, y, width, height, format, type, NULL );
+	if( packAlignment != 4 )
+		glPixelStorei( GL_PACK_ALIGNMENT, 4 );//Set it back to the context's default state as required by ffgl.
+
+	buffer.fence        = glFenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE, 0 );
+	buffer.requestIndex = requestIndex;
+	nextRequestBuffer   = ( nextRequestBuffer + 1 ) % buffers.size();
+	return true;
+}
+/**
+ * Copy the pixels of the oldest request into pixels if the gpu has finished copying them. This never waits for the gpu,
+ * call it every frame until it returns false to receive all finished requests in the order they were made.
+ *
+ * @param pixels: Where to copy the pixels to, GetFrameSize bytes.
+ * @param requestIndex: Optionally receives the index of the request the pixels belong to. Every call to Request,
+ * including the dropped ones, gets the next index, starting at 0.
+ * @return: Whether or not pixels has received the pixels of a request.
+ */
+bool FFGLAsyncReadback::Poll( void* pixels, uint64_t* requestIndex )
+{
+	if( buffers.empty() || pixels == nullptr )
+		return false;
+
+	PixelBuffer& buffer = buffers[ nextPollBuffer ];
+	if( buffer.fence == nullptr )
+		return false;
+
+	//Flush so that the fence will eventually be signaled even if the host doesn't flush, but dont wait for it.
+	GLenum result = glClientWaitSync( buffer.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0 );
+	if( result == GL_TIMEOUT_EXPIRED )
+		return false;
+	glDeleteSync( buffer.fence );
+	buffer.fence   = nullptr;
+	nextPollBuffer = ( nextPollBuffer + 1 ) % buffers.size();
+	if( result == GL_WAIT_FAILED )
+		return false;
+
+	ScopedBufferBinding bufferBinding( GL_PIXEL_PACK_BUFFER, buffer.bufferID );
+	const void* mappedPixels = glMapBufferRange( GL_PIXEL_PACK_BUFFER, 0, frameSize, GL_MAP_READ_BIT );
+	if( mappedPixels == nullptr )
+		return false;
+	memcpy( pixels, mappedPixels, (size_t)frameSize );
+	glUnmapBuffer( GL_PIXEL_PACK_BUFFER );
+
+	if( requestIndex != nullptr )
+		*requestIndex = buffer.requestIndex;
+	return true;
+}
+
+/**
+ * The number of bytes Poll copies into pixels. Rows are tightly packed, so this is width * height * the size of a pixel.
+ */
+size_t FFGLAsyncReadback::GetFrameSize() const
+{
+	return (size_t)frameSize;
+}
+/**
+ * The number of requests that were dropped because all buffers were waiting to be polled. If this keeps growing you either
+ * need to poll every frame or initialise the readback with more buffers.
+ */
+uint64_t FFGLAsyncReadback::GetNumDroppedRequests() const
+{
+	return numDroppedRequests;
+}
+
+}//End namespace ffglex
\ No newline at end of file
@@ -0,0 +1,57 @@
+#pragma once
+#include "../ffgl/FFGL.h"//For OpenGL
+#include <stdint.h>
+#include <vector>
+
+namespace ffglex
+{
+/**
+ * The FFGLAsyncReadback copies pixels from the gpu to the cpu without stalling the pipeline like glReadPixels into cpu memory does.
+ * Request queues a copy of an fbo's pixels into one of a ring of pixel pack buffers, and returns right away. The gpu performs the
+ * copy when it gets to it, after which Poll hands you the pixels. That's usually one or two frames later, so call Poll every frame:
+ *
+ *	readback.Request( fbo.GetGLID() );
+ *	while( readback.Poll( pixels.data() ) )
+ *		SendOverNetwork( pixels );
+ *
+ * The buffers are reused as soon as their pixels have been polled. When all of them are still waiting to be polled a request is
+ * dropped, which you can see in GetNumDroppedRequests.
+ */
+class FFGLAsyncReadback
+{
+public:
+	FFGLAsyncReadback();
+	FFGLAsyncReadback( const FFGLAsyncReadback& ) = delete;
+	~FFGLAsyncReadback();
+
+	bool Initialise( GLsizei width, GLsizei height, GLenum format = GL_RGBA, GLenum type = GL_UNSIGNED_BYTE, unsigned int numBuffers = 3 );//Allocate the pixel pack buffers.
+	void Release();                                                                                                                        //Release all gl resources. Call this before destruction if you've previously initialised us.
+
+	bool Request( GLuint fboID, GLint x = 0, GLint y = 0 );     //Queue a copy of the fbo's pixels, starting at x, y. Returns false if the request was dropped.
+	bool Poll( void* pixels, uint64_t* requestIndex = nullptr );//Copy the pixels of the oldest finished request into pixels, returns false if no request has finished yet.
+
+	size_t GetFrameSize() const;           //The number of bytes Poll copies into pixels, rows are tightly packed.
+	uint64_t GetNumDroppedRequests() const;//The number of requests that were dropped because all buffers were waiting to be polled.
+
+private:
+	struct PixelBuffer
+	{
+		GLuint bufferID;
+		GLsync fence;         //!< Signaled once the gpu has copied the pixels into the buffer. nullptr if the buffer is free.
+		uint64_t requestIndex;//!< The index of the request that's using the buffer.
+	};
+
+	GLsizei width;
+	GLsizei height;
+	GLenum format;
+	GLenum type;
+	GLsizeiptr frameSize;              //!< The number of bytes of a full frame.
+	GLint packAlignment;               //!< The row alignment of the pixels we're reading.
+	std::vector< PixelBuffer > buffers;//!< The ring of pixel pack buffers, requests are queued in order.
+	size_t nextRequestBuffer;          //!< The buffer the next request copies into.
+	size_t nextPollBuffer;             //!< The buffer of the oldest request that hasn't been polled yet.
+	uint64_t numRequests;
+	uint64_t numDroppedRequests;
+};
+
+}//End namespace ffglex
\ No newline at end of file
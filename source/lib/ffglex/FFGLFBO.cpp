@@ -1,47 +1,129 @@
 #include "FFGLFBO.h"
+#include <algorithm>
 #include "FFGLScopedFBOBinding.h"
 #include "FFGLScopedRenderBufferBinding.h"
 #include "FFGLScopedTextureBinding.h"
+#include "FFGLStateCache.h"
+#include "../ffgl/FFGLInstanceStats.h"
 
 namespace ffglex
 {
+/**
+ * The format and type that go with an internal format when creating a texture with glTexImage2D. We're not uploading any
+ * data, but the driver still rejects combinations that aren't valid for the internal format.
+ */
+static void GetPixelFormat( GLint internalColorFormat, GLenum& format, GLenum& type )
+{
+	switch( internalColorFormat )
+	{
+	case GL_R8:
+		format = GL_RED;
+		type   = GL_UNSIGNED_BYTE;
+		break;
+	case GL_RG8:
+		format = GL_RG;
+		type   = GL_UNSIGNED_BYTE;
+		break;
+	case GL_RGBA8:
+	case GL_SRGB8_ALPHA8:
+		format = GL_RGBA;
+		type   = GL_UNSIGNED_BYTE;
+		break;
+	case GL_R16F:
+		format = GL_RED;
+		type   = GL_HALF_FLOAT;
+		break;
+	case GL_RG16F:
+		format = GL_RG;
+		type   = GL_HALF_FLOAT;
+		break;
+	case GL_RGBA16F:
+		format = GL_RGBA;
+		type   = GL_HALF_FLOAT;
+		break;
+	case GL_R11F_G11F_B10F:
+		format = GL_RGB;
+		type   = GL_UNSIGNED_INT_10F_11F_11F_REV;
+		break;
+	case GL_RGB10_A2:
+		format = GL_RGBA;
+		type   = GL_UNSIGNED_INT_2_10_10_10_REV;
+		break;
+	case GL_R32F:
+		format = GL_RED;
+		type   = GL_FLOAT;
+		break;
+	case GL_RG32F:
+		format = GL_RG;
+		type   = GL_FLOAT;
+		break;
+	default:
+		format = GL_RGBA;
+		type   = GL_FLOAT;
+		break;
+	}
+}
+
+FFGLFBODescriptor::FFGLFBODescriptor( GLsizei width, GLsizei height, GLint internalColorFormat ) :
+	width( width ),
+	height( height ),
+	colorFormats( 1, internalColorFormat ),
+	depthBuffer( DB_NONE ),
+	sharedDepthBufferID( 0 ),
+	numSamples( 1 )
+{
+}
+
 FFGLFBO::FFGLFBO() :
 	width( 0 ),
 	height( 0 ),
 	internalColorFormat( 0 ),
 	fboID( 0 ),
 	depthBufferID( 0 ),
-	colorTextureID( 0 )
+	colorTextureID( 0 ),
+	descriptor( 0, 0 ),
+	resolveFboID( 0 )
 {
 }
 
-bool FFGLFBO::Initialise( GLsizei width, GLsizei height, GLint internalColorFormat )
+bool FFGLFBO::Initialise( GLsizei width, GLsizei height, GLint internalColorFormat, bool withDepthBuffer )
+{
+	FFGLFBODescriptor descriptor( width, height, internalColorFormat );
+	descriptor.depthBuffer = withDepthBuffer ? FFGLFBODescriptor::DB_OWN : FFGLFBODescriptor::DB_NONE;
+	return Initialise( descriptor );
+}
+bool FFGLFBO::Initialise( const FFGLFBODescriptor& descriptor )
 {
 	//Cannot initialize if we're already initialized, please Release us first.
 	if( fboID != 0 )
 		return false;
 
-	this->width               = width;
-	this->height              = height;
-	this->internalColorFormat = internalColorFormat;
+	//Every color attachment is also a draw buffer, so we're limited by whichever of the two maximums is the smallest.
+	GLint maxColorAttachments = 0;
+	GLint maxDrawBuffers      = 0;
+	glGetIntegerv( GL_MAX_COLOR_ATTACHMENTS, &maxColorAttachments );
+	glGetIntegerv( GL_MAX_DRAW_BUFFERS, &maxDrawBuffers );
+	if( descriptor.colorFormats.empty() || (GLint)descriptor.colorFormats.size() > std::min( maxColorAttachments, maxDrawBuffers ) )
+		return false;
+	if( descriptor.depthBuffer == FFGLFBODescriptor::DB_SHARED && descriptor.sharedDepthBufferID == 0 )
+		return false;
+
+	this->descriptor          = descriptor;
+	this->width               = descriptor.width;
+	this->height              = descriptor.height;
+	this->internalColorFormat = descriptor.colorFormats[ 0 ];
 
 	//If any of the generation functions fail we'll release the resources that did successfully initialize so that
 	//we wont end up in a partially initialized state.
-	if( !GenerateFBO() || !GenerateDepthBuffer() || !GenerateColorTexture() )
+	if( !GenerateFBO() || !GenerateDepthBuffer() || !GenerateColorTextures() || !GenerateColorRenderbuffers() )
 	{
 		Release();
 		return false;
 	}
 
-	//If we got to this point generating the depth buffer and color textures has succeeded so we can now attach them to the fbo.
-	//We use a reverting binding behaviour so that the bound fboIDs may be reverted back to the host's fbo.
-	ScopedFBOBinding scopedFBO( fboID, ScopedFBOBinding::RB_REVERT );
-	glFramebufferRenderbuffer( GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthBufferID );
-	glFramebufferTexture2D( GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTextureID, 0 );
-
 	//If the framebuffer status is not complete for some reason we'll release all the resources we've initialized so that
 	//they dont keep dangling around. The caller should not have to call Release if Initialise failed.
-	if( glCheckFramebufferStatus( GL_FRAMEBUFFER ) != GL_FRAMEBUFFER_COMPLETE )
+	if( !AttachBuffers() )
 	{
 		Release();
 		return false;
@@ -57,26 +139,83 @@ void FFGLFBO::Release()
 	if( fboID != 0 )
 	{
 		glDeleteFramebuffers( 1, &fboID );
+		FFGLInstanceStats::AddGLObjects( -1 );
 		fboID = 0;
 	}
 
+	if( resolveFboID != 0 )
+	{
+		glDeleteFramebuffers( 1, &resolveFboID );
+		FFGLInstanceStats::AddGLObjects( -1 );
+		resolveFboID = 0;
+	}
+
 	if( depthBufferID != 0 )
 	{
 		glDeleteRenderbuffers( 1, &depthBufferID );
+		FFGLInstanceStats::AddGLObjects( -1 );
 		depthBufferID = 0;
 	}
 
-	if( depthBufferID != 0 )
+	if( !colorTextureIDs.empty() )
 	{
-		glDeleteTextures( 1, &depthBufferID );
-		depthBufferID = 0;
+		glDeleteTextures( (GLsizei)colorTextureIDs.size(), colorTextureIDs.data() );
+		FFGLInstanceStats::AddGLObjects( -(int)colorTextureIDs.size() );
+		colorTextureIDs.clear();
+		colorTextureID = 0;
 	}
+
+	if( !colorRenderbufferIDs.empty() )
+	{
+		glDeleteRenderbuffers( (GLsizei)colorRenderbufferIDs.size(), colorRenderbufferIDs.data() );
+		FFGLInstanceStats::AddGLObjects( -(int)colorRenderbufferIDs.size() );
+		colorRenderbufferIDs.clear();
+	}
+
+	descriptor = FFGLFBODescriptor( 0, 0 );
 }
 
 void FFGLFBO::ResizeViewPort()
 {
 	glViewport( 0, 0, width, height );
 }
+void FFGLFBO::Resolve()
+{
+	if( !IsMultisampled() )
+		return;
+
+	//Bind our textures as the draw target and our multisampled renderbuffers as the read target. The scoped binding reverts
+	//both of them to the fbos that were bound before.
+	ScopedFBOBinding scopedResolveFBO( resolveFboID, ScopedFBOBinding::RB_REVERT );
+	FFGLStateCache* stateCache = FFGLStateCache::GetActive();
+	if( stateCache != nullptr )
+		stateCache->BindFramebuffer( GL_READ_FRAMEBUFFER, fboID );
+	else
+		glBindFramebuffer( GL_READ_FRAMEBUFFER, fboID );
+
+	if( colorTextureIDs.size() == 1 )
+	{
+		glBlitFramebuffer( 0, 0, width, height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_NEAREST );
+		return;
+	}
+
+	//A blit copies the read buffer into all draw buffers, so with multiple attachments we have to resolve them one at a time.
+	std::vector< GLenum > drawBuffers( colorTextureIDs.size(), GL_NONE );
+	for( size_t attachment = 0; attachment < drawBuffers.size(); ++attachment )
+	{
+		drawBuffers[ attachment ] = GL_COLOR_ATTACHMENT0 + (GLenum)attachment;
+		glReadBuffer( GL_COLOR_ATTACHMENT0 + (GLenum)attachment );
+		glDrawBuffers( (GLsizei)drawBuffers.size(), drawBuffers.data() );
+		glBlitFramebuffer( 0, 0, width, height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_NEAREST );
+		drawBuffers[ attachment ] = GL_NONE;
+	}
+
+	//The read and draw buffers are part of the fbos' state, return them to how they've been set up by AttachBuffers.
+	for( size_t attachment = 0; attachment < drawBuffers.size(); ++attachment )
+		drawBuffers[ attachment ] = GL_COLOR_ATTACHMENT0 + (GLenum)attachment;
+	glReadBuffer( GL_COLOR_ATTACHMENT0 );
+	glDrawBuffers( (GLsizei)drawBuffers.size(), drawBuffers.data() );
+}
 
 GLuint FFGLFBO::GetWidth() const
 {
@@ -86,18 +225,40 @@ GLuint FFGLFBO::GetHeight() const
 {
 	return height;
 }
+GLint FFGLFBO::GetInternalColorFormat() const
+{
+	return internalColorFormat;
+}
+bool FFGLFBO::HasDepthBuffer() const
+{
+	return GetDepthBufferID() != 0;
+}
+GLuint FFGLFBO::GetDepthBufferID() const
+{
+	if( fboID == 0 )
+		return 0;
+	return descriptor.depthBuffer == FFGLFBODescriptor::DB_SHARED ? descriptor.sharedDepthBufferID : depthBufferID;
+}
+size_t FFGLFBO::GetNumColorAttachments() const
+{
+	return colorTextureIDs.size();
+}
+bool FFGLFBO::IsMultisampled() const
+{
+	return descriptor.numSamples > 1;
+}
 GLuint FFGLFBO::GetGLID() const
 {
 	return fboID;
 }
-FFGLTextureStruct FFGLFBO::GetTextureInfo() const
+FFGLTextureStruct FFGLFBO::GetTextureInfo( size_t attachment ) const
 {
 	FFGLTextureStruct t;
 
 	t.Width = t.HardwareWidth = width;
 	t.Height = t.HardwareHeight = height;
 
-	t.Handle = colorTextureID;
+	t.Handle = attachment < colorTextureIDs.size() ? colorTextureIDs[ attachment ] : 0;
 
 	return t;
 }
@@ -105,37 +266,120 @@ FFGLTextureStruct FFGLFBO::GetTextureInfo() const
 bool FFGLFBO::GenerateFBO()
 {
 	glGenFramebuffers( 1, &fboID );
-	return fboID != 0;
+	if( fboID == 0 )
+		return false;
+	FFGLInstanceStats::AddGLObjects( 1 );
+
+	//When we're multisampled we're rendering into renderbuffers, the textures are attached to a separate fbo that we resolve into.
+	if( !IsMultisampled() )
+		return true;
+	glGenFramebuffers( 1, &resolveFboID );
+	if( resolveFboID == 0 )
+		return false;
+	FFGLInstanceStats::AddGLObjects( 1 );
+	return true;
 }
 bool FFGLFBO::GenerateDepthBuffer()
 {
+	if( descriptor.depthBuffer != FFGLFBODescriptor::DB_OWN )
+		return true;
+
 	glGenRenderbuffers( 1, &depthBufferID );
 	if( depthBufferID == 0 )
 		return false;
+	FFGLInstanceStats::AddGLObjects( 1 );
 
 	ScopedRenderBufferBinding scopedBinding( depthBufferID );
-	glRenderbufferStorage( GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height );
+	if( IsMultisampled() )
+		glRenderbufferStorageMultisample( GL_RENDERBUFFER, descriptor.numSamples, GL_DEPTH_COMPONENT24, width, height );
+	else
+		glRenderbufferStorage( GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height );
 	return true;
 }
-bool FFGLFBO::GenerateColorTexture()
+bool FFGLFBO::GenerateColorTextures()
 {
-	glGenTextures( 1, &colorTextureID );
-	if( colorTextureID == 0 )
-		return false;
+	for( GLint colorFormat : descriptor.colorFormats )
+	{
+		GLuint textureID = 0;
+		glGenTextures( 1, &textureID );
+		if( textureID == 0 )
+			return false;
+		colorTextureIDs.push_back( textureID );
+		FFGLInstanceStats::AddGLObjects( 1 );
+
+		//Temporarily bind the texture so that we may initialize it's size.
+		Scoped2DTextureBinding textureBinding( textureID );
 
-	//Temporarily bind the texture so that we may initialize it's size.
-	Scoped2DTextureBinding textureBinding( colorTextureID );
+		//Create the texture with no mipmap levels and no borders. The data format and data type dont really matter as we're not uploading any data,
+		//but they do need to be compatible with the internal format.
+		GLenum format;
+		GLenum type;
+		GetPixelFormat( colorFormat, format, type );
+		glTexImage2D( GL_TEXTURE_2D, 0, colorFormat, width, height, 0, format, type, NULL );
 
-	//Create the texture with no mipmap levels and no borders. The data format and data type dont really matter as we're not uploading any data.
-	glTexImage2D( GL_TEXTURE_2D, 0, internalColorFormat, width, height, 0, GL_RGBA, internalColorFormat == GL_RGBA8 ? GL_UNSIGNED_BYTE : GL_FLOAT, NULL );
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
 
-	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
-	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+	}
 
-	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
-	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+	colorTextureID = colorTextureIDs[ 0 ];
+	return true;
+}
+bool FFGLFBO::GenerateColorRenderbuffers()
+{
+	if( !IsMultisampled() )
+		return true;
 
+	for( GLint colorFormat : descriptor.colorFormats )
+	{
+		GLuint renderbufferID = 0;
+		glGenRenderbuffers( 1, &renderbufferID );
+		if( renderbufferID == 0 )
+			return false;
+		colorRenderbufferIDs.push_back( renderbufferID );
+		FFGLInstanceStats::AddGLObjects( 1 );
+
+		ScopedRenderBufferBinding scopedBinding( renderbufferID );
+		glRenderbufferStorageMultisample( GL_RENDERBUFFER, descriptor.numSamples, colorFormat, width, height );
+	}
 	return true;
 }
+bool FFGLFBO::AttachBuffers()
+{
+	//Color attachment i receives the fragment shader's output location i.
+	std::vector< GLenum > drawBuffers;
+	for( size_t attachment = 0; attachment < colorTextureIDs.size(); ++attachment )
+		drawBuffers.push_back( GL_COLOR_ATTACHMENT0 + (GLenum)attachment );
+
+	//We use a reverting binding behaviour so that the bound fboIDs may be reverted back to the host's fbo.
+	ScopedFBOBinding scopedFBO( fboID, ScopedFBOBinding::RB_REVERT );
+	GLuint depthID = GetDepthBufferID();
+	if( depthID != 0 )
+		glFramebufferRenderbuffer( GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthID );
+	for( size_t attachment = 0; attachment < drawBuffers.size(); ++attachment )
+	{
+		if( IsMultisampled() )
+			glFramebufferRenderbuffer( GL_FRAMEBUFFER, drawBuffers[ attachment ], GL_RENDERBUFFER, colorRenderbufferIDs[ attachment ] );
+		else
+			glFramebufferTexture2D( GL_FRAMEBUFFER, drawBuffers[ attachment ], GL_TEXTURE_2D, colorTextureIDs[ attachment ], 0 );
+	}
+	if( drawBuffers.size() > 1 )
+		glDrawBuffers( (GLsizei)drawBuffers.size(), drawBuffers.data() );
+	if( glCheckFramebufferStatus( GL_FRAMEBUFFER ) != GL_FRAMEBUFFER_COMPLETE )
+		return false;
+	scopedFBO.EndScope();
+
+	if( !IsMultisampled() )
+		return true;
+
+	ScopedFBOBinding scopedResolveFBO( resolveFboID, ScopedFBOBinding::RB_REVERT );
+	for( size_t attachment = 0; attachment < drawBuffers.size(); ++attachment )
+		glFramebufferTexture2D( GL_FRAMEBUFFER, drawBuffers[ attachment ], GL_TEXTURE_2D, colorTextureIDs[ attachment ], 0 );
+	if( drawBuffers.size() > 1 )
+		glDrawBuffers( (GLsizei)drawBuffers.size(), drawBuffers.data() );
+	return glCheckFramebufferStatus( GL_FRAMEBUFFER ) == GL_FRAMEBUFFER_COMPLETE;
+}
 
-}//End namespace ffglex
+}//End namespace ffglex
\ No newline at end of file
@@ -48,10 +48,39 @@
 
 #ifndef FFGLFBO_STANDARD
 #define FFGLFBO_STANDARD
+#include <vector>
 #include "../ffgl/FFGL.h"
 
 namespace ffglex
 {
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// \class		FFGLFBODescriptor
+/// \brief		FFGLFBODescriptor describes the attachments an FFGLFBO should create.
+///
+/// By default it describes a single GL_RGBA8 color attachment without a depth buffer, which is all most 2D effects need.
+/// Compact formats like GL_R8, GL_RG8, GL_RGBA16F, GL_R11F_G11F_B10F and GL_RGB10_A2 save memory and bandwidth in
+/// intermediate passes. When numSamples is larger than 1 the fbo renders into multisampled renderbuffers, of which the
+/// color is resolved into the fbo's textures by FFGLFBO::Resolve.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+struct FFGLFBODescriptor
+{
+	enum DepthBuffer
+	{
+		DB_NONE, //Dont attach a depth buffer.
+		DB_OWN,  //Create a GL_DEPTH_COMPONENT24 renderbuffer for this fbo.
+		DB_SHARED//Attach sharedDepthBufferID, the depth buffer of another fbo with the same size and number of samples.
+	};
+
+	FFGLFBODescriptor( GLsizei width, GLsizei height, GLint internalColorFormat = GL_RGBA8 );
+
+	GLsizei width;                    //!< Width of the fbo in number of pixels.
+	GLsizei height;                   //!< Height of the fbo in number of pixels.
+	std::vector< GLint > colorFormats;//!< The internal format of each color attachment, at most GL_MAX_COLOR_ATTACHMENTS. Attachment i is bound to the fragment shader's output location i.
+	DepthBuffer depthBuffer;          //!< Which depth buffer to attach, DB_NONE by default.
+	GLuint sharedDepthBufferID;       //!< The renderbuffer to attach when depthBuffer is DB_SHARED, see FFGLFBO::GetDepthBufferID.
+	GLsizei numSamples;               //!< The number of samples per pixel, 1 to render directly into the textures.
+};
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// \class		FFGLFBO
 /// \brief		FFGLFBO can be used to capture the output of your OpenGL draw commands into a texture.
@@ -63,6 +92,9 @@ namespace ffglex
 /// To cause your draw commands to end up in this framebuffer you need to bind it. For that purpose you need to use the
 /// ScopedFBOBinding class in combination with this class's GetGLID. Then after you're done rendering you need to unbind the fbo
 /// (end the scoped fbo binding's scope). You can then get the information of the texture to which you've rendered by calling GetTextureInfo
+///
+/// Use an FFGLFBODescriptor to leave out the depth buffer, share it with another fbo, render into multiple color attachments
+/// or to render with multisampling. A multisampled fbo has to be resolved with Resolve before sampling it's textures.
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 class FFGLFBO
 {
@@ -76,34 +108,61 @@ public:
 	/// \param height				The height the framebuffer should have in number of pixels.
 	/// \param internalColorFormat	The OpenGL texture format to which you want to render. See glTexImage2D's internalFormat for possible formats. You cannot specify
 	///								compressed formats here.
-	bool Initialise( GLsizei width, GLsizei height, GLint internalColorFormat = GL_RGBA8 );
+	/// \param withDepthBuffer		Whether or not to attach a depth buffer. Passes that dont use depth testing dont need one.
+	bool Initialise( GLsizei width, GLsizei height, GLint internalColorFormat = GL_RGBA8, bool withDepthBuffer = true );
+	/// Makes the FBO intialise the attachments that are described by the descriptor.
+	///
+	/// \param descriptor			The size, attachments and number of samples of the framebuffer.
+	bool Initialise( const FFGLFBODescriptor& descriptor );
 	/// Releases the OpenGL resources. Call this when you're done with the FBO, usually from your plugin's DeInitGL function.
 	void Release();
 
 	void ResizeViewPort();
+	/// Resolves the multisampled color attachments into the textures. Call this after rendering into a multisampled fbo
+	/// and before sampling it's textures. Has no effect if the fbo isn't multisampled.
+	void Resolve();
 
 	/// Get the width of the framebuffer in number of pixels.
 	GLuint GetWidth() const;
 	/// Get the height of the framebuffer in number of pixels.
 	GLuint GetHeight() const;
+	/// Get the internal format of the framebuffer's first texture.
+	GLint GetInternalColorFormat() const;
+	/// Get whether or not the framebuffer has a depth buffer attached.
+	bool HasDepthBuffer() const;
+	/// Get the OpenGL handle for the depth buffer, which you can share with fbos of the same size and number of samples. 0 if there's none.
+	GLuint GetDepthBufferID() const;
+	/// Get the number of color attachments.
+	size_t GetNumColorAttachments() const;
+	/// Get whether or not the framebuffer renders with multisampling, in which case you need to call Resolve before sampling it's textures.
+	bool IsMultisampled() const;
 	/// Get the OpenGL handle for the framebuffer. Pass this value into the ScopedFBOBinding to bind this FBO.
 	GLuint GetGLID() const;
-	/// Get the TextureStruct describing this FBO's texture. If you want to apply this fbo's texture to some surface you
+	/// Get the TextureStruct describing one of this FBO's textures. If you want to apply this fbo's texture to some surface you
 	/// need the information returned from this function.
-	FFGLTextureStruct GetTextureInfo() const;
+	///
+	/// \param attachment			The index of the color attachment.
+	FFGLTextureStruct GetTextureInfo( size_t attachment = 0 ) const;
 
 protected:
 	bool GenerateFBO();
 	bool GenerateDepthBuffer();
-	bool GenerateColorTexture();
+	bool GenerateColorTextures();
+	bool GenerateColorRenderbuffers();
+	bool AttachBuffers();
 
 	GLsizei width;            //!< Width of the fbo in number of pixels. 0 if we're not initialized.
 	GLsizei height;           //!< Height of the fbo in number of pixels. 0 if we're not initialized.
-	GLint internalColorFormat;//!< The internal format of our texture.
+	GLint internalColorFormat;//!< The internal format of our first texture.
 
 	GLuint fboID;         //!< OpenGL's id for our FBO. 0 if we're not initialized.
-	GLuint depthBufferID; //!< OpenGL's id for our renderbuffer we use to store depth information. 0 if we're not initialized.
-	GLuint colorTextureID;//!< OpenGL's id for our texture we use to store color information. 0 if we're not initialized.
+	GLuint depthBufferID; //!< OpenGL's id for our renderbuffer we use to store depth information. 0 if we're not initialized or dont have a depth buffer.
+	GLuint colorTextureID;//!< OpenGL's id for our first texture we use to store color information. 0 if we're not initialized.
+
+	FFGLFBODescriptor descriptor;              //!< The attachments we've been initialized with.
+	GLuint resolveFboID;                       //!< OpenGL's id for the FBO our textures are attached to when we're multisampled. 0 if we're not.
+	std::vector< GLuint > colorTextureIDs;     //!< OpenGL's ids for the textures of all color attachments.
+	std::vector< GLuint > colorRenderbufferIDs;//!< OpenGL's ids for the multisampled renderbuffers of all color attachments, empty if we're not multisampled.
 };
 
 }//End namespace ffglex
@@ -0,0 +1,131 @@
+#include "FFGLFullScreenPass.h"
+#include <assert.h>
+#include <mutex>
+#include <vector>
+#include "FFGLScopedVAOBinding.h"
+#include "FFGLUtilities.h"
+
+namespace ffglex
+{
+/**
+ * The empty vaos that are shared by all passes, one per context. Vaos aren't shared between contexts so we need a
+ * separate one for each context that passes are drawn on. Passes on a context we can't identify own their vao instead.
+ */
+struct SharedVAO
+{
+	void* context;
+	GLuint vaoID;
+	unsigned int refCount;
+};
+struct SharedVAOData
+{
+	std::mutex mutex;
+	std::vector< SharedVAO > vaos;
+};
+static SharedVAOData& GetSharedVAOData()
+{
+	static SharedVAOData data;
+	return data;
+}
+
+FFGLFullScreenPass::FFGLFullScreenPass() :
+	vaoID( 0 ),
+	context( nullptr )
+{
+}
+FFGLFullScreenPass::~FFGLFullScreenPass()
+{
+	//If this assertion hits you forgot to release this pass.
+	assert( vaoID == 0 );
+}
+
+/**
+ * Acquire the current context's empty vao that's shared by all passes, creating it if we're the first pass on this context.
+ * This function needs to be called using an active OpenGL context, for example in your plugin's InitGL function.
+ *
+ * @return: Whether or not initialising this pass succeeded.
+ */
+bool FFGLFullScreenPass::Initialise()
+{
+	if( vaoID != 0 )
+		return true;
+
+	//A core profile context doesn't allow drawing without a vao bound, even when there aren't any vertex attributes.
+	//We can't share the vao if we can't tell the context apart from others, in which case this pass gets one of it's own.
+	context = GetCurrentGLContext();
+	if( context == nullptr )
+	{
+		glGenVertexArrays( 1, &vaoID );
+		return vaoID != 0;
+	}
+
+	SharedVAOData& data = GetSharedVAOData();
+	std::lock_guard< std::mutex > lock( data.mutex );
+	for( SharedVAO& vao : data.vaos )
+	{
+		if( vao.context == context )
+		{
+			vao.refCount++;
+			vaoID = vao.vaoID;
+			return true;
+		}
+	}
+
+	SharedVAO vao;
+	glGenVertexArrays( 1, &vao.vaoID );
+	if( vao.vaoID == 0 )
+		return false;
+	vao.context  = context;
+	vao.refCount = 1;
+	data.vaos.push_back( vao );
+	vaoID = vao.vaoID;
+	return true;
+}
+/**
+ * Draw the triangle. Your vertex shader needs to generate it's corners from gl_VertexID, which results in your fragment shader
+ * being applied to the whole viewport. You need to have successfully initialised this pass before rendering it.
+ */
+void FFGLFullScreenPass::Draw()
+{
+	if( vaoID == 0 )
+		return;
+
+	//Scoped binding to make sure we dont keep the vao bind after we're done rendering.
+	ScopedVAOBinding vaoBinding( vaoID );
+	glDrawArrays( GL_TRIANGLES, 0, 3 );
+}
+/**
+ * Release our reference to the shared vao, when we're the last pass on this context the vao is deleted. Call this before destruction
+ * if you've previously initialised us, with the same context current that we've been initialised on.
+ */
+void FFGLFullScreenPass::Release()
+{
+	if( vaoID == 0 )
+		return;
+	if( context == nullptr )
+	{
+		glDeleteVertexArrays( 1, &vaoID );
+		vaoID = 0;
+		return;
+	}
+
+	SharedVAOData& data = GetSharedVAOData();
+	std::lock_guard< std::mutex > lock( data.mutex );
+	for( size_t index = 0; index < data.vaos.size(); ++index )
+	{
+		SharedVAO& vao = data.vaos[ index ];
+		if( vao.context != context || vao.vaoID != vaoID )
+			continue;
+
+		if( --vao.refCount == 0 )
+		{
+			glDeleteVertexArrays( 1, &vao.vaoID );
+			data.vaos.erase( data.vaos.begin() + index );
+		}
+		break;
+	}
+	vaoID   = 0;
+	context = nullptr;
+}
+
+}//End namespace ffglex
\ No newline at end of file
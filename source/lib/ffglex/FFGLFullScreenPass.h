@@ -0,0 +1,35 @@
+#pragma once
+#include "../ffgl/FFGL.h"//For OpenGL
+
+namespace ffglex
+{
+/**
+ * The FFGLFullScreenPass is a utility that helps you run your fragment shader over the whole viewport. Instead of sourcing
+ * a quad's vertices from a buffer it draws a single triangle that's large enough to cover the viewport, of which the
+ * vertex shader generates the corners from gl_VertexID:
+ *
+ *	vec2 position = vec2( ( gl_VertexID & 1 ) * 4 - 1, ( gl_VertexID & 2 ) * 2 - 1 );
+ *	gl_Position   = vec4( position, 0.0, 1.0 );
+ *	uv            = position * 0.5 + 0.5;//Multiply this by your maxUV to sample an input texture.
+ *
+ * This doesn't need any vertex data, so all passes on a context share a single empty vao. Using a single triangle also
+ * avoids shading the pixels along the quad's diagonal twice.
+ */
+class FFGLFullScreenPass
+{
+public:
+	FFGLFullScreenPass();
+	FFGLFullScreenPass( const FFGLFullScreenPass& ) = delete;
+	FFGLFullScreenPass( FFGLFullScreenPass&& )      = delete;
+	~FFGLFullScreenPass();
+
+	bool Initialise();//Acquire the current context's empty vao that's shared by all passes.
+	void Draw();      //Draw the triangle. Your vertex shader needs to generate it's corners from gl_VertexID.
+	void Release();   //Release our reference to the shared vao. Call this before destruction if you've previously initialised us.
+
+private:
+	GLuint vaoID;
+	void* context;
+};
+
+}//End namespace ffglex
\ No newline at end of file
@@ -0,0 +1,10 @@
+#pragma once
+#include "../ffgl/FFGLGpuTimer.h"
+
+namespace ffglex
+{
+//The gpu timer is part of the ffgl library so that the sdk can measure every instance with it, these keep ffglex::FFGLGpuTimer working.
+using ::FFGLGpuTimer;
+using ::ScopedGpuZone;
+
+}//End namespace ffglex
\ No newline at end of file
@@ -0,0 +1,259 @@
+#include "FFGLProgramCache.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <functional>
+#include <random>
+#include "../ffgl/FFGLLog.h"
+#include "../ffgl/FFGLInstanceStats.h"
+
+namespace ffglex
+{
+static const char CACHE_FILE_MAGIC[ 8 ] = { 'F', 'F', 'G', 'L', 'P', 'B', '0', '1' };
+
+struct ProgramCacheData
+{
+	std::mutex mutex;
+	std::string directory;
+	bool hasDirectory = false;//!< Whether SetDirectory has been called, until then we're using the environment's directory.
+	std::atomic< unsigned int > numHits{ 0 };
+	std::atomic< unsigned int > numMisses{ 0 };
+};
+static ProgramCacheData& GetCacheData()
+{
+	static ProgramCacheData data;
+	return data;
+}
+
+/**
+ * A binary can only be loaded by the driver that has created it, so next to the sources the key contains everything
+ * that identifies the driver.
+ */
+static std::string GetCacheKey( const std::string& sources )
+{
+	std::string key;
+	const GLubyte* strings[] = { glGetString( GL_VENDOR ), glGetString( GL_RENDERER ), glGetString( GL_VERSION ) };
+	for( const GLubyte* string : strings )
+	{
+		if( string != nullptr )
+			key += (const char*)string;
+		key += '\0';
+	}
+	key += sources;
+	return key;
+}
+static std::string GetCacheFilePath( const std::string& directory, const std::string& key )
+{
+	char fileName[ 32 ];
+	snprintf( fileName, sizeof( fileName ), "%016llx.ffglprogram", (unsigned long long)std::hash< std::string >()( key ) );
+	return directory + "/" + fileName;
+}
+/**
+ * Every shader looks up it's program, so this is logged at debug level. The counters are available through GetNumHits and GetNumMisses.
+ */
+static void LogCacheResult( const char* result )
+{
+	ProgramCacheData& data = GetCacheData();
+	std::string message    = std::string( "Program cache " ) + result + " (" + std::to_string( data.numHits.load() ) + " hits, " + std::to_string( data.numMisses.load() ) + " misses)";
+	FFGLLog::LogToHost( FFGLLog::LL_DEBUG, message );
+}
+static bool ReadValue( FILE* file, void* value, size_t size )
+{
+	return fread( value, 1, size, file ) == size;
+}
+/**
+ * The number of bytes between the file's position and it's end, 0 if we can't tell.
+ */
+static uint64_t GetNumRemainingBytes( FILE* file )
+{
+	long position = ftell( file );
+	if( position < 0 || fseek( file, 0, SEEK_END ) != 0 )
+		return 0;
+	long end = ftell( file );
+	if( fseek( file, position, SEEK_SET ) != 0 || end < position )
+		return 0;
+	return (uint64_t)( end - position );
+}
+
+/**
+ * Sets the directory to store binaries in. The directory has to exist already.
+ *
+ * @param directory: The cache directory, pass an empty string to disable the cache. Calling this overrides the
+ * FFGL_PROGRAM_CACHE_DIR environment variable.
+ */
+void FFGLProgramCache::SetDirectory( const std::string& directory )
+{
+	ProgramCacheData& data = GetCacheData();
+	std::lock_guard< std::mutex > lock( data.mutex );
+	data.directory    = directory;
+	data.hasDirectory = true;
+}
+/**
+ * The directory binaries are stored in. This is the directory that was set with SetDirectory, or the FFGL_PROGRAM_CACHE_DIR
+ * environment variable if no directory has been set. Empty if the cache is disabled.
+ */
+std::string FFGLProgramCache::GetDirectory()
+{
+	ProgramCacheData& data = GetCacheData();
+	std::lock_guard< std::mutex > lock( data.mutex );
+	if( data.hasDirectory )
+		return data.directory;
+
+	const char* environmentDirectory = getenv( "FFGL_PROGRAM_CACHE_DIR" );
+	return environmentDirectory != nullptr ? environmentDirectory : "";
+}
+/**
+ * Whether or not the cache has a directory and the current context's driver supports program binaries.
+ */
+bool FFGLProgramCache::IsEnabled()
+{
+	if( GetDirectory().empty() )
+		return false;
+
+	GLint numBinaryFormats = 0;
+	glGetIntegerv( GL_NUM_PROGRAM_BINARY_FORMATS, &numBinaryFormats );
+	return numBinaryFormats > 0;
+}
+
+/**
+ * Creates a linked program from a cached binary.
+ *
+ * @param sources: Everything the program is compiled and linked from, the same as what's passed to Store.
+ * @return: The linked program. 0 when the cache is disabled, when there's no binary for these sources or when
+ * the driver has rejected the binary. In that case the program needs to be compiled from source.
+ */
+GLuint FFGLProgramCache::Load( const std::string& sources )
+{
+	if( !IsEnabled() )
+		return 0;
+
+	ProgramCacheData& data = GetCacheData();
+	std::string key        = GetCacheKey( sources );
+	FILE* file             = fopen( GetCacheFilePath( GetDirectory(), key ).c_str(), "rb" );
+	if( file == nullptr )
+	{
+		data.numMisses++;
+		LogCacheResult( "miss" );
+		return 0;
+	}
+
+	//The file starts with the full key so that we can detect hash collisions, followed by the driver's binary.
+	char magic[ sizeof( CACHE_FILE_MAGIC ) ];
+	uint64_t keyLength    = 0;
+	uint32_t binaryFormat = 0;
+	uint64_t binaryLength = 0;
+	std::string fileKey;
+	std::vector< char > binary;
+	bool isValid = ReadValue( file, magic, sizeof( magic ) ) && memcmp( magic, CACHE_FILE_MAGIC, sizeof( magic ) ) == 0;
+	isValid      = isValid && ReadValue( file, &keyLength, sizeof( keyLength ) ) && keyLength == key.size();
+	if( isValid )
+	{
+		fileKey.resize( (size_t)keyLength );
+		isValid = ReadValue( file, &fileKey[ 0 ], fileKey.size() ) && fileKey == key;
+	}
+	isValid = isValid && ReadValue( file, &binaryFormat, sizeof( binaryFormat ) ) && ReadValue( file, &binaryLength, sizeof( binaryLength ) );
+	//The binary takes up the rest of the file, a length that doesn't match means the entry is corrupt or truncated.
+	isValid = isValid && binaryLength == GetNumRemainingBytes( file );
+	if( isValid && binaryLength > 0 )
+	{
+		binary.resize( (size_t)binaryLength );
+		isValid = ReadValue( file, binary.data(), binary.size() );
+	}
+	fclose( file );
+
+	GLuint programID = 0;
+	if( isValid && !binary.empty() )
+	{
+		programID = glCreateProgram();
+		FFGLInstanceStats::AddGLObjects( 1 );
+		glProgramBinary( programID, (GLenum)binaryFormat, binary.data(), (GLsizei)binary.size() );
+		GLint linkStatus = 0;
+		glGetProgramiv( programID, GL_LINK_STATUS, &linkStatus );
+		if( linkStatus != GL_TRUE )
+		{
+			glDeleteProgram( programID );
+			FFGLInstanceStats::AddGLObjects( -1 );
+			programID = 0;
+		}
+	}
+
+	if( programID == 0 )
+	{
+		//The entry is corrupt or the driver doesn't accept it's binary anymore, compiling the program will replace it.
+		data.numMisses++;
+		LogCacheResult( "rejected a binary" );
+		return 0;
+	}
+
+	data.numHits++;
+	LogCacheResult( "hit" );
+	return programID;
+}
+/**
+ * Writes a program's binary into the cache. The program needs to have been linked with the GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+ * set, otherwise some drivers won't give us the binary.
+ *
+ * @param sources: Everything the program was compiled and linked from.
+ * @param programID: The linked program.
+ */
+void FFGLProgramCache::Store( const std::string& sources, GLuint programID )
+{
+	if( !IsEnabled() )
+		return;
+
+	GLint binaryLength = 0;
+	glGetProgramiv( programID, GL_PROGRAM_BINARY_LENGTH, &binaryLength );
+	if( binaryLength <= 0 )
+		return;
+	std::vector< char > binary( (size_t)binaryLength );
+	GLenum binaryFormat = 0;
+	glGetProgramBinary( programID, binaryLength, &binaryLength, &binaryFormat, binary.data() );
+	if( binaryLength <= 0 )
+		return;
+
+	//Multiple hosts may be loading the same plugin at the same time, write to a temporary file first so that they'll
+	//never see a partially written entry.
+	std::string key      = GetCacheKey( sources );
+	std::string path     = GetCacheFilePath( GetDirectory(), key );
+	std::string tempPath = path + "." + std::to_string( std::random_device()() ) + ".tmp";
+	FILE* file           = fopen( tempPath.c_str(), "wb" );
+	if( file == nullptr )
+		return;
+
+	uint64_t keyLength        = key.size();
+	uint32_t fileBinaryFormat = binaryFormat;
+	uint64_t fileBinaryLength = (uint64_t)binaryLength;
+	bool isWritten            = fwrite( CACHE_FILE_MAGIC, 1, sizeof( CACHE_FILE_MAGIC ), file ) == sizeof( CACHE_FILE_MAGIC );
+	isWritten                 = isWritten && fwrite( &keyLength, 1, sizeof( keyLength ), file ) == sizeof( keyLength );
+	isWritten                 = isWritten && fwrite( key.data(), 1, key.size(), file ) == key.size();
+	isWritten                 = isWritten && fwrite( &fileBinaryFormat, 1, sizeof( fileBinaryFormat ), file ) == sizeof( fileBinaryFormat );
+	isWritten                 = isWritten && fwrite( &fileBinaryLength, 1, sizeof( fileBinaryLength ), file ) == sizeof( fileBinaryLength );
+	isWritten                 = isWritten && fwrite( binary.data(), 1, (size_t)binaryLength, file ) == (size_t)binaryLength;
+	isWritten                 = fclose( file ) == 0 && isWritten;
+
+	//Windows doesn't allow renaming onto an existing file, which we'll have when we're replacing a rejected binary.
+	remove( path.c_str() );
+	if( !isWritten || rename( tempPath.c_str(), path.c_str() ) != 0 )
+		remove( tempPath.c_str() );
+}
+
+/**
+ * The number of programs that have been loaded from the cache.
+ */
+unsigned int FFGLProgramCache::GetNumHits()
+{
+	return GetCacheData().numHits.load();
+}
+/**
+ * The number of programs that had to be compiled because they weren't in the cache or their binary was rejected.
+ */
+unsigned int FFGLProgramCache::GetNumMisses()
+{
+	return GetCacheData().numMisses.load();
+}
+
+}//End namespace ffglex
\ No newline at end of file
@@ -0,0 +1,30 @@
+#pragma once
+#include "../ffgl/FFGL.h"//For OpenGL
+#include <string>
+
+namespace ffglex
+{
+/**
+ * The FFGLProgramCache stores linked program binaries on disk so that next time the plugin is loaded FFGLShader can
+ * skip compiling and linking. Binaries are only valid for the driver that produced them, so they're keyed by the program's
+ * sources together with the renderer and driver version. When the driver rejects a binary anyway (eg after an update that
+ * didn't change the version string) the shader is just compiled from source again and the cache entry is replaced.
+ *
+ * The cache is disabled until it has a directory. Plugins can set one with SetDirectory, hosts can enable it for all
+ * plugins by pointing the FFGL_PROGRAM_CACHE_DIR environment variable to an existing directory.
+ */
+class FFGLProgramCache final
+{
+public:
+	static void SetDirectory( const std::string& directory );//Sets the directory to store binaries in, pass an empty string to disable the cache.
+	static std::string GetDirectory();                       //The directory binaries are stored in, empty if the cache is disabled.
+	static bool IsEnabled();                                 //Whether or not the cache has a directory and the driver supports program binaries.
+
+	static GLuint Load( const std::string& sources );               //Creates a linked program from a cached binary. Returns 0 when there's no usable binary for these sources.
+	static void Store( const std::string& sources, GLuint programID );//Writes the binary of a program that was linked with GL_PROGRAM_BINARY_RETRIEVABLE_HINT into the cache.
+
+	static unsigned int GetNumHits();  //The number of programs that have been loaded from the cache.
+	static unsigned int GetNumMisses();//The number of programs that had to be compiled because they weren't in the cache or their binary was rejected.
+};
+
+}//End namespace ffglex
\ No newline at end of file
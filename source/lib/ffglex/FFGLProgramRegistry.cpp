@@ -0,0 +1,120 @@
+#include "FFGLProgramRegistry.h"
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <functional>
+#include "FFGLUtilities.h"
+#include "../ffgl/FFGLInstanceStats.h"
+
+namespace ffglex
+{
+/**
+ * All of the library's shared programs. This is a function local static so that it's constructed before any plugin's
+ * static data could try to compile a shader.
+ */
+struct ProgramRegistryData
+{
+	std::mutex mutex;
+	std::vector< std::unique_ptr< SharedProgram > > programs;
+};
+static ProgramRegistryData& GetRegistryData()
+{
+	static ProgramRegistryData data;
+	return data;
+}
+
+/**
+ * Finds a program that was linked from the same sources on the current context and adds a reference to it.
+ *
+ * @param sources: Everything the program needs to be compiled and linked from, eg the glsl of each stage.
+ * @return: The shared program, release it with Release when you no longer use it. nullptr if no such program has been registered yet,
+ * in which case you need to compile it yourself and register it with Add.
+ */
+SharedProgram* FFGLProgramRegistry::Acquire( const std::string& sources )
+{
+	//Programs can only be used on the context they were linked on, or contexts sharing with it. We don't know which contexts
+	//share objects so the registry only hands out programs that were linked on the context that's current right now.
+	void* context = GetCurrentGLContext();
+	if( context == nullptr )
+		return nullptr;//We can't tell this context apart from others, so every user links it's own program.
+	size_t sourceHash = std::hash< std::string >()( sources );
+
+	ProgramRegistryData& data = GetRegistryData();
+	std::lock_guard< std::mutex > lock( data.mutex );
+	for( const std::unique_ptr< SharedProgram >& program : data.programs )
+	{
+		if( program->context == context && program->sourceHash == sourceHash && program->sources == sources )
+		{
+			program->refCount++;
+			return program.get();
+		}
+	}
+	return nullptr;
+}
+/**
+ * Registers a newly linked program so that next users compiling the same sources can acquire it.
+ *
+ * @param sources: Everything the program was compiled and linked from, this has to be the same as what was passed to Acquire.
+ * @param programID: The linked program. The registry takes ownership, the caller should release it instead of deleting it.
+ * @param isLinking: Whether or not the program was linked async and the driver may still be busy with it. Registering it
+ * right away lets users that compile the same sources in the meantime share the link instead of starting their own.
+ * @return: The shared program with a single reference owned by the caller.
+ */
+SharedProgram* FFGLProgramRegistry::Add( const std::string& sources, GLuint programID, bool isLinking )
+{
+	std::unique_ptr< SharedProgram > program( new SharedProgram() );
+	program->programID    = programID;
+	program->context      = GetCurrentGLContext();
+	program->sourceHash   = std::hash< std::string >()( sources );
+	program->sources      = sources;
+	program->refCount     = 1;
+	program->uniformOwner = nullptr;
+	program->creatorStats = FFGLInstanceStats::GetActive();
+	program->isLinking    = isLinking;
+
+	ProgramRegistryData& data = GetRegistryData();
+	std::lock_guard< std::mutex > lock( data.mutex );
+	data.programs.push_back( std::move( program ) );
+	return data.programs.back().get();
+}
+/**
+ * Removes a reference to a shared program. When this was the last reference the program is deleted, so this needs to
+ * be called with the program's context current.
+ */
+void FFGLProgramRegistry::Release( SharedProgram* program )
+{
+	if( program == nullptr )
+		return;
+
+	ProgramRegistryData& data = GetRegistryData();
+	std::lock_guard< std::mutex > lock( data.mutex );
+	//The program is reported to the instance that linked it, until that instance releases it.
+	if( program->creatorStats != nullptr && program->creatorStats == FFGLInstanceStats::GetActive() )
+	{
+		FFGLInstanceStats::AddGLObjects( -1 );
+		program->creatorStats = nullptr;
+	}
+	if( --program->refCount != 0 )
+		return;
+
+	glDeleteProgram( program->programID );
+	for( size_t index = 0; index < data.programs.size(); ++index )
+	{
+		if( data.programs[ index ].get() == program )
+		{
+			data.programs.erase( data.programs.begin() + index );
+			break;
+		}
+	}
+}
+/**
+ * The number of programs that are currently registered, for all contexts.
+ */
+size_t FFGLProgramRegistry::GetNumPrograms()
+{
+	ProgramRegistryData& data = GetRegistryData();
+	std::lock_guard< std::mutex > lock( data.mutex );
+	return data.programs.size();
+}
+
+}//End namespace ffglex
\ No newline at end of file
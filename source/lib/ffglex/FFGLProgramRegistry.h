@@ -0,0 +1,42 @@
+#pragma once
+#include "../ffgl/FFGL.h"//For OpenGL
+#include <string>
+
+class FFGLInstanceStats;
+
+namespace ffglex
+{
+/**
+ * A linked shader program that's shared by all users that compiled it from the same sources on the same context.
+ */
+struct SharedProgram
+{
+	GLuint programID;               //!< The ID OpenGL gave the linked program.
+	void* context;                  //!< The OpenGL context the program was linked on, nullptr if it's unknown in which case the program isn't shared.
+	size_t sourceHash;              //!< Hash of sources, used to quickly skip programs that were compiled from other sources.
+	std::string sources;            //!< Everything the program was compiled and linked from, compared in full so that hash collisions can't hand out the wrong program.
+	unsigned int refCount;          //!< The number of users that have acquired the program and not yet released it.
+	const void* uniformOwner;       //!< The user that has most recently set the program's uniforms. Uniform values are program state so users need to set all of theirs again after someone else did.
+	FFGLInstanceStats* creatorStats;//!< The stats of the instance that linked the program, which the program is reported to until that instance releases it. Only compared, never dereferenced.
+	bool isLinking;                 //!< Whether or not the driver may still be compiling and linking the program, users have to check it's link status before using it.
+};
+
+/**
+ * The FFGLProgramRegistry shares linked shader programs within a plugin library. Hosts typically create lots of instances
+ * of the same plugin, eg when loading a composition that uses an effect on each layer. Without sharing each of those instances
+ * would make the driver compile and link the same glsl again, with the registry only the first one pays for that.
+ * Programs are refcounted and deleted when their last user releases them.
+ *
+ * FFGLShader uses this automatically, you'd only use this directly if you're creating shader programs yourself.
+ * The registry is threadsafe, but like any other OpenGL object a program should only be used on the context it was linked on.
+ */
+class FFGLProgramRegistry final
+{
+public:
+	static SharedProgram* Acquire( const std::string& sources );                                      //Finds a program that was linked from the same sources on the current context and adds a reference to it. Returns nullptr if there isn't one.
+	static SharedProgram* Add( const std::string& sources, GLuint programID, bool isLinking = false );//Registers a newly linked program with a single reference, owned by the caller.
+	static void Release( SharedProgram* program );                                                    //Removes a reference, deletes the program when it was the last one.
+	static size_t GetNumPrograms();                                                                   //The number of programs that are currently registered, for all contexts.
+};
+
+}//End namespace ffglex
\ No newline at end of file
@@ -0,0 +1,303 @@
+#include "FFGLRenderTargetPool.h"
+#include <assert.h>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "FFGLUtilities.h"
+#include "../ffgl/FFGLInstanceStats.h"
+
+namespace ffglex
+{
+static const std::chrono::seconds MAX_IDLE_TIME( 2 );//!< Free targets that haven't been acquired for this long are deleted.
+
+/**
+ * Fbos aren't shared between contexts, so every target belongs to the context it has been created on
+ * and is only handed out to acquires on that context. Targets of a context we can't identify are never
+ * handed out again, they're deleted as soon as they're released.
+ */
+struct PooledTarget
+{
+	void* context;
+	std::unique_ptr< FFGLFBO > renderTarget;
+	uint64_t numBytes;
+	bool isInUse;
+	std::chrono::steady_clock::time_point releaseTime;
+};
+/**
+ * The number of plugin instances that have retained a context, see FFGLRenderTargetPool::RetainContext.
+ */
+struct PoolContext
+{
+	void* context;
+	unsigned int numUsers;
+};
+struct RenderTargetPoolData
+{
+	std::mutex mutex;
+	std::vector< PooledTarget > targets;
+	std::vector< PoolContext > contexts;
+	uint64_t numAllocations = 0;
+	uint64_t numReuses      = 0;
+};
+static RenderTargetPoolData& GetPoolData()
+{
+	static RenderTargetPoolData data;
+	return data;
+}
+
+/**
+ * An estimate of a target's video memory, drivers may pad or compress it.
+ */
+static uint64_t GetNumBytes( GLsizei width, GLsizei height, GLint internalColorFormat, bool withDepthBuffer )
+{
+	uint64_t numBytesPerPixel;
+	switch( internalColorFormat )
+	{
+	case GL_R8:
+		numBytesPerPixel = 1;
+		break;
+	case GL_RG8:
+	case GL_R16F:
+		numBytesPerPixel = 2;
+		break;
+	case GL_RGBA16F:
+	case GL_RG32F:
+		numBytesPerPixel = 8;
+		break;
+	case GL_RGBA32F:
+		numBytesPerPixel = 16;
+		break;
+	default:
+		numBytesPerPixel = 4;
+		break;
+	}
+	if( withDepthBuffer )
+		numBytesPerPixel += 4;
+	return numBytesPerPixel * (uint64_t)width * (uint64_t)height;
+}
+/**
+ * Deletes the free targets of the context that have been idle for longer than maxIdleTime. The pool's mutex needs to be locked.
+ */
+static void DeleteIdleTargets( RenderTargetPoolData& data, void* context, std::chrono::steady_clock::duration maxIdleTime )
+{
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	for( size_t index = 0; index < data.targets.size(); )
+	{
+		PooledTarget& target = data.targets[ index ];
+		if( target.context == context && !target.isInUse && now - target.releaseTime >= maxIdleTime )
+		{
+			ScopedInstanceStats noInstanceStats( nullptr );
+			target.renderTarget->Release();
+			data.targets.erase( data.targets.begin() + index );
+		}
+		else
+		{
+			++index;
+		}
+	}
+}
+
+/**
+ * Acquire a target from the current context's pool. This function needs to be called using an active OpenGL context,
+ * for example in your plugin's ProcessOpenGL function.
+ *
+ * @param width: The width of the target in number of pixels.
+ * @param height: The height of the target in number of pixels.
+ * @param internalColorFormat: The format of the target's texture, see FFGLFBO::Initialise.
+ * @param withDepthBuffer: Whether or not the target needs a depth buffer.
+ * @return: A target that's yours until you release it, it's contents are undefined. nullptr if creating the target failed.
+ */
+FFGLFBO* FFGLRenderTargetPool::Acquire( GLsizei width, GLsizei height, GLint internalColorFormat, bool withDepthBuffer )
+{
+	void* context              = GetCurrentGLContext();
+	RenderTargetPoolData& data = GetPoolData();
+	std::lock_guard< std::mutex > lock( data.mutex );
+	DeleteIdleTargets( data, context, MAX_IDLE_TIME );
+
+	for( PooledTarget& target : data.targets )
+	{
+		FFGLFBO& renderTarget = *target.renderTarget;
+		if( context == nullptr || target.context != context || target.isInUse )
+			continue;
+		if( (GLsizei)renderTarget.GetWidth() != width || (GLsizei)renderTarget.GetHeight() != height )
+			continue;
+		if( renderTarget.GetInternalColorFormat() != internalColorFormat || renderTarget.HasDepthBuffer() != withDepthBuffer )
+			continue;
+
+		target.isInUse = true;
+		data.numReuses++;
+		return target.renderTarget.get();
+	}
+
+	PooledTarget target;
+	target.context      = context;
+	target.renderTarget = std::unique_ptr< FFGLFBO >( new FFGLFBO() );
+	target.numBytes     = GetNumBytes( width, height, internalColorFormat, withDepthBuffer );
+	target.isInUse      = true;
+	//The targets are shared by all instances on the context, so they're not reported to the instance that happens to create them.
+	ScopedInstanceStats noInstanceStats( nullptr );
+	if( !target.renderTarget->Initialise( width, height, internalColorFormat, withDepthBuffer ) )
+		return nullptr;
+	data.targets.push_back( std::move( target ) );
+	data.numAllocations++;
+	return data.targets.back().renderTarget.get();
+}
+/**
+ * Return a target to the pool so that it can be handed out again. You may no longer use the target after releasing it.
+ * Release it with the context current that you've acquired it on, the pool deletes targets of contexts it can't identify.
+ *
+ * @param renderTarget: The target that you've acquired from the pool. Releasing nullptr has no effect.
+ */
+void FFGLRenderTargetPool::Release( FFGLFBO* renderTarget )
+{
+	if( renderTarget == nullptr )
+		return;
+
+	RenderTargetPoolData& data = GetPoolData();
+	std::lock_guard< std::mutex > lock( data.mutex );
+	for( size_t index = 0; index < data.targets.size(); ++index )
+	{
+		PooledTarget& target = data.targets[ index ];
+		if( target.renderTarget.get() == renderTarget )
+		{
+			//If this assertion hits you've released this target twice.
+			assert( target.isInUse );
+			target.isInUse     = false;
+			target.releaseTime = std::chrono::steady_clock::now();
+			//We can't tell which context this target belongs to, so it can't be handed out again.
+			if( target.context == nullptr )
+			{
+				ScopedInstanceStats noInstanceStats( nullptr );
+				target.renderTarget->Release();
+				data.targets.erase( data.targets.begin() + index );
+			}
+			return;
+		}
+	}
+
+	//If this assertion hits you're releasing a target that wasn't acquired from the pool.
+	assert( false );
+}
+/**
+ * Delete the current context's targets that aren't in use. Call this from your plugin's DeInitGL so that the pool doesn't
+ * keep targets alive after the last plugin that has used them is gone.
+ */
+void FFGLRenderTargetPool::ReleaseUnused()
+{
+	RenderTargetPoolData& data = GetPoolData();
+	std::lock_guard< std::mutex > lock( data.mutex );
+	DeleteIdleTargets( data, GetCurrentGLContext(), std::chrono::steady_clock::duration::zero() );
+}
+/**
+ * Register a user of the current context's pool. Call this from your plugin's InitGL, and balance it with a call to
+ * ReleaseContext from DeInitGL.
+ */
+void FFGLRenderTargetPool::RetainContext()
+{
+	void* context = GetCurrentGLContext();
+	if( context == nullptr )
+		return;
+
+	RenderTargetPoolData& data = GetPoolData();
+	std::lock_guard< std::mutex > lock( data.mutex );
+	for( PoolContext& poolContext : data.contexts )
+	{
+		if( poolContext.context == context )
+		{
+			poolContext.numUsers++;
+			return;
+		}
+	}
+	PoolContext poolContext;
+	poolContext.context  = context;
+	poolContext.numUsers = 1;
+	data.contexts.push_back( poolContext );
+}
+/**
+ * Unregister a user of the current context's pool. When this was the last user the context is about to be destroyed
+ * as far as the pool can tell, so all of it's targets are deleted. Otherwise a new context that happens to get the same
+ * handle would be handed fbo and texture ids that belong to the dead context.
+ */
+void FFGLRenderTargetPool::ReleaseContext()
+{
+	void* context = GetCurrentGLContext();
+	if( context == nullptr )
+		return;
+
+	RenderTargetPoolData& data = GetPoolData();
+	std::lock_guard< std::mutex > lock( data.mutex );
+	for( size_t index = 0; index < data.contexts.size(); ++index )
+	{
+		PoolContext& poolContext = data.contexts[ index ];
+		if( poolContext.context != context )
+			continue;
+		if( --poolContext.numUsers != 0 )
+			return;
+		data.contexts.erase( data.contexts.begin() + index );
+
+		DeleteIdleTargets( data, context, std::chrono::steady_clock::duration::zero() );
+		for( PooledTarget& target : data.targets )
+		{
+			//If this assertion hits a target is still in use after the last user of it's context is gone.
+			assert( target.context != context );
+			//Forget which context it belongs to so that it's deleted when it's released instead of being handed out again.
+			if( target.context == context )
+				target.context = nullptr;
+		}
+		return;
+	}
+
+	//If this assertion hits you're releasing a context that you haven't retained.
+	assert( false );
+}
+
+/**
+ * The pool's occupancy and video memory usage, summed over all contexts.
+ */
+FFGLRenderTargetPool::Stats FFGLRenderTargetPool::GetStats()
+{
+	RenderTargetPoolData& data = GetPoolData();
+	std::lock_guard< std::mutex > lock( data.mutex );
+	Stats stats;
+	stats.numTargets      = (unsigned int)data.targets.size();
+	stats.numTargetsInUse = 0;
+	stats.numBytes        = 0;
+	stats.numBytesInUse   = 0;
+	stats.numAllocations  = data.numAllocations;
+	stats.numReuses       = data.numReuses;
+	for( const PooledTarget& target : data.targets )
+	{
+		stats.numBytes += target.numBytes;
+		if( target.isInUse )
+		{
+			stats.numTargetsInUse++;
+			stats.numBytesInUse += target.numBytes;
+		}
+	}
+	return stats;
+}
+
+ScopedRenderTarget::ScopedRenderTarget( GLsizei width, GLsizei height, GLint internalColorFormat, bool withDepthBuffer ) :
+	renderTarget( FFGLRenderTargetPool::Acquire( width, height, internalColorFormat, withDepthBuffer ) )
+{
+}
+ScopedRenderTarget::~ScopedRenderTarget()
+{
+	EndScope();
+}
+
+FFGLFBO* ScopedRenderTarget::Get() const
+{
+	return renderTarget;
+}
+void ScopedRenderTarget::EndScope()
+{
+	if( renderTarget != nullptr )
+	{
+		FFGLRenderTargetPool::Release( renderTarget );
+		renderTarget = nullptr;
+	}
+}
+
+}//End namespace ffglex
\ No newline at end of file
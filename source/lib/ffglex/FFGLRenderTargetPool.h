@@ -0,0 +1,62 @@
+#pragma once
+#include "../ffgl/FFGL.h"//For OpenGL
+#include <stdint.h>
+#include "FFGLFBO.h"
+
+namespace ffglex
+{
+/**
+ * The FFGLRenderTargetPool hands out fbos for intermediate passes, so that plugins dont have to allocate their own fbos
+ * that sit idle while other plugins are rendering. Targets are keyed by their size, color format and whether or not they
+ * have a depth buffer. A target that's released back into the pool is handed out again to the next acquire with the same key,
+ * from any instance of any plugin on the same context.
+ *
+ * Acquire a target at the start of your pass and release it as soon as you've consumed it's texture, preferably within the
+ * same frame. Use the ScopedRenderTarget to do that automatically. The contents of a target are undefined after acquiring it,
+ * so clear it or overwrite all of it's pixels. Targets that haven't been acquired for a few seconds are deleted by the next acquire.
+ *
+ * The pool identifies contexts by their native handle, which the driver may hand out again for a context that's created after
+ * the old one has been destroyed. Retain the context from your plugin's InitGL and release it from DeInitGL, once the last
+ * user of a context is gone all of it's targets are deleted so that a new context never gets handed the old one's objects.
+ */
+class FFGLRenderTargetPool
+{
+public:
+	struct Stats
+	{
+		unsigned int numTargets;     //!< The number of targets in the pool, on all contexts.
+		unsigned int numTargetsInUse;//!< The number of targets that have been acquired and not yet released.
+		uint64_t numBytes;           //!< An estimate of the video memory used by all targets.
+		uint64_t numBytesInUse;      //!< An estimate of the video memory used by the targets that are in use.
+		uint64_t numAllocations;     //!< The number of targets that had to be created because there was no free one with the requested key.
+		uint64_t numReuses;          //!< The number of acquires that have been served with a target from the pool.
+	};
+
+	static FFGLFBO* Acquire( GLsizei width, GLsizei height, GLint internalColorFormat = GL_RGBA8, bool withDepthBuffer = false );//Acquire a target from the current context's pool, creating one if there's no free one. nullptr if creating it failed.
+	static void Release( FFGLFBO* renderTarget );                                                                                //Return a target to the pool so that it can be handed out again.
+	static void ReleaseUnused();                                                                                                 //Delete the current context's targets that aren't in use, eg from your plugin's DeInitGL.
+	static void RetainContext();                                                                                                 //Register a user of the current context's pool, eg from your plugin's InitGL.
+	static void ReleaseContext();                                                                                                //Unregister a user of the current context's pool, deletes all of it's targets when it was the last one.
+
+	static Stats GetStats();//The pool's occupancy and video memory usage.
+};
+
+/**
+ * The ScopedRenderTarget acquires a target from the FFGLRenderTargetPool on construction, and releases it back into the
+ * pool on destruction. Bind it with a ScopedFBOBinding to render into it, and sample it's texture before the scope ends.
+ */
+class ScopedRenderTarget
+{
+public:
+	ScopedRenderTarget( GLsizei width, GLsizei height, GLint internalColorFormat = GL_RGBA8, bool withDepthBuffer = false );
+	ScopedRenderTarget( const ScopedRenderTarget& ) = delete;
+	~ScopedRenderTarget();
+
+	FFGLFBO* Get() const;//The acquired target, nullptr if acquiring it failed or if our scope has ended.
+	void EndScope();     //Manually end the RAII scope. The first time you call this the target will be released, consecutive calls have no effect.
+
+private:
+	FFGLFBO* renderTarget;
+};
+
+}//End namespace ffglex
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "FFGLScopedBufferBinding.h"
+#include "../ffgl/FFGLStateValidation.h"
 
 namespace ffglex
 {
@@ -11,9 +12,40 @@ namespace ffglex
  */
 ScopedBufferBinding::ScopedBufferBinding( GLenum target, GLuint newBinding ) :
 	target( target ),
-	isBound( true )
+	index( 0 ),
+	isIndexed( false ),
+	isBound( true ),
+	stateCache( FFGLStateCache::GetActive() ),
+	previousBinding( 0 )
 {
-	glBindBuffer( target, newBinding );
+	if( stateCache != nullptr )
+		previousBinding = stateCache->BindBuffer( target, newBinding );
+	else
+		glBindBuffer( target, newBinding );
+	FFGLStateValidation::SetBufferBinding( target, newBinding );
+}
+/**
+ * Constructs this RAII binding which automatically binds your buffer to the requested index of an indexed target.
+ * Besides the indexed binding this also binds the buffer to the generic binding point of the target.
+ *
+ * @param target: The indexed buffer target to which you want to bind your buffer. See glBindBufferBase
+ * for possible values of this argument.
+ * @param index: The index of the binding point within the target.
+ * @param newBinding: The id of the buffer object you want to bind.
+ */
+ScopedBufferBinding::ScopedBufferBinding( GLenum target, GLuint index, GLuint newBinding ) :
+	target( target ),
+	index( index ),
+	isIndexed( true ),
+	isBound( true ),
+	stateCache( FFGLStateCache::GetActive() ),
+	previousBinding( 0 )
+{
+	if( stateCache != nullptr )
+		previousBinding = stateCache->BindBufferBase( target, index, newBinding );
+	else
+		glBindBufferBase( target, index, newBinding );
+	FFGLStateValidation::SetIndexedBufferBinding( target, index, newBinding );
 }
 /**
  * The destructor automatically unbinds the buffer if our scope wasn't ended manually.
@@ -30,7 +62,18 @@ void ScopedBufferBinding::EndScope()
 {
 	if( isBound )
 	{
-		glBindBuffer( target, 0 );
+		if( stateCache != nullptr && isIndexed )
+			stateCache->BindBufferBase( target, index, previousBinding );
+		else if( stateCache != nullptr )
+			stateCache->BindBuffer( target, previousBinding );
+		else if( isIndexed )
+			glBindBufferBase( target, index, previousBinding );
+		else
+			glBindBuffer( target, previousBinding );
+		if( isIndexed )
+			FFGLStateValidation::SetIndexedBufferBinding( target, index, previousBinding );
+		else
+			FFGLStateValidation::SetBufferBinding( target, previousBinding );
 		isBound = false;
 	}
 }
@@ -49,5 +92,9 @@ ScopedUBOBinding::ScopedUBOBinding( GLuint uboID ) :
 	ScopedBufferBinding( GL_UNIFORM_BUFFER, uboID )
 {
 }
+ScopedUBOBinding::ScopedUBOBinding( GLuint uboID, GLuint bindingIndex ) :
+	ScopedBufferBinding( GL_UNIFORM_BUFFER, bindingIndex, uboID )
+{
+}
 
 }//End namespace ffglex
\ No newline at end of file
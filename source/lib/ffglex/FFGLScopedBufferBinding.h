@@ -1,5 +1,6 @@
 #pragma once
 #include "../ffgl/FFGL.h"//For OpenGL
+#include "FFGLStateCache.h"
 
 namespace ffglex
 {
@@ -11,18 +12,27 @@ namespace ffglex
  * If you have know the type of your buffer and know where you want to bind it you can use the
  * ScopedVBOBinding, ScopedIBOBinding and ScopedUBOBinding classes to bind vertex buffers,
  * element array buffers and uniform buffers respectively.
+ *
+ * Buffers that are bound to an indexed target (eg uniform buffers that need to be bound to a uniform block binding point)
+ * are bound with glBindBufferBase, in which case both the indexed and the generic binding are unbound again at the end of the scope.
+ * When an FFGLStateCache is active the previous binding is restored instead of unbinding, and binds that wouldn't change anything are skipped.
  */
 class ScopedBufferBinding
 {
 public:
-	ScopedBufferBinding( GLenum target, GLuint newBinding );//Constructs this RAII binding which automatically binds your buffer to the requested target.
-	virtual ~ScopedBufferBinding();                         //The destructor automatically unbinds the buffer if our scope wasn't ended manually.
+	ScopedBufferBinding( GLenum target, GLuint newBinding );              //Constructs this RAII binding which automatically binds your buffer to the requested target.
+	ScopedBufferBinding( GLenum target, GLuint index, GLuint newBinding );//Constructs this RAII binding which automatically binds your buffer to the requested index of an indexed target.
+	virtual ~ScopedBufferBinding();                                       //The destructor automatically unbinds the buffer if our scope wasn't ended manually.
 
 	void EndScope();//Manually end the RAII scope. The first time you call this the buffer will be unbound, consecutive calls have no effect.
 
 private:
-	GLenum target;//!< The target to which the buffer object is bound.
-	bool isBound; //!< Whether or not the buffer is currently bound. Maintained to provide the EndScope function without unbinding the buffer again in our destructor.
+	GLenum target;             //!< The target to which the buffer object is bound.
+	GLuint index;              //!< The binding point index within the target when the buffer is bound to an indexed target.
+	bool isIndexed;            //!< Whether or not the buffer was bound to an indexed target, in which case we unbind it with glBindBufferBase.
+	bool isBound;              //!< Whether or not the buffer is currently bound. Maintained to provide the EndScope function without unbinding the buffer again in our destructor.
+	FFGLStateCache* stateCache;//!< The state cache that was active when we were bound, nullptr if there wasn't one.
+	GLuint previousBinding;    //!< The buffer to restore at the end of our scope. Without a state cache we assume the default state, so that's 0.
 };
 
 /**
@@ -42,12 +52,14 @@ public:
 	ScopedIBOBinding( GLuint iboID );
 };
 /**
- * This scoped buffer binding binds the provided buffer id as being an uniform buffer object.
+ * This scoped buffer binding binds the provided buffer id as being an uniform buffer object. Pass a binding
+ * point index to also make the buffer available to the uniform blocks that are bound to that binding point.
  */
 class ScopedUBOBinding : public ScopedBufferBinding
 {
 public:
 	ScopedUBOBinding( GLuint uboID );
+	ScopedUBOBinding( GLuint uboID, GLuint bindingIndex );
 };
 
 }//End namespace ffglex
\ No newline at end of file
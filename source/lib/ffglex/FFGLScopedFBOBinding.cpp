@@ -1,4 +1,5 @@
 #include "FFGLScopedFBOBinding.h"
+#include "../ffgl/FFGLStateValidation.h"
 
 namespace ffglex
 {
@@ -6,17 +7,32 @@ ScopedFBOBinding::ScopedFBOBinding( GLuint fboID, RestoreBehaviour restoreBehavi
 	isBound( true ),
 	restoreBehaviour( restoreBehaviour ),
 	previousDrawFboID( 0 ),
-	previosReadFboID( 0 )
+	previosReadFboID( 0 ),
+	stateCache( FFGLStateCache::GetActive() )
 {
 	//If we have to revert to the currently bound fbo we need to get their id's. If we dont get these id's we'll automatically
-	//get the clearing behaviour as we've initialized the fboIDs to 0.
+	//get the clearing behaviour as we've initialized the fboIDs to 0. Querying them stalls the driver, so we're only doing that
+	//when there's no state cache that knows which fbos are bound.
 	if( restoreBehaviour == RB_REVERT )
 	{
-		glGetIntegerv( GL_DRAW_FRAMEBUFFER_BINDING, &previousDrawFboID );
-		glGetIntegerv( GL_READ_FRAMEBUFFER_BINDING, &previosReadFboID );
+		if( stateCache != nullptr )
+		{
+			previousDrawFboID = (GLint)stateCache->GetBoundFramebuffer( GL_DRAW_FRAMEBUFFER );
+			previosReadFboID  = (GLint)stateCache->GetBoundFramebuffer( GL_READ_FRAMEBUFFER );
+		}
+		else
+		{
+			glGetIntegerv( GL_DRAW_FRAMEBUFFER_BINDING, &previousDrawFboID );
+			glGetIntegerv( GL_READ_FRAMEBUFFER_BINDING, &previosReadFboID );
+		}
 	}
 
-	glBindFramebuffer( GL_FRAMEBUFFER, fboID );
+	if( stateCache != nullptr )
+		stateCache->BindFramebuffer( GL_FRAMEBUFFER, fboID );
+	else
+		glBindFramebuffer( GL_FRAMEBUFFER, fboID );
+	FFGLStateValidation::SetBinding( FFGLStateValidation::BINDING_DRAW_FBO, fboID );
+	FFGLStateValidation::SetBinding( FFGLStateValidation::BINDING_READ_FBO, fboID );
 }
 ScopedFBOBinding::~ScopedFBOBinding()
 {
@@ -27,8 +43,22 @@ void ScopedFBOBinding::EndScope()
 {
 	if( isBound )
 	{
-		glBindFramebuffer( GL_DRAW_FRAMEBUFFER, previousDrawFboID );
-		glBindFramebuffer( GL_READ_FRAMEBUFFER, previosReadFboID );
+		if( stateCache != nullptr && previousDrawFboID == previosReadFboID )
+		{
+			stateCache->BindFramebuffer( GL_FRAMEBUFFER, previousDrawFboID );
+		}
+		else if( stateCache != nullptr )
+		{
+			stateCache->BindFramebuffer( GL_DRAW_FRAMEBUFFER, previousDrawFboID );
+			stateCache->BindFramebuffer( GL_READ_FRAMEBUFFER, previosReadFboID );
+		}
+		else
+		{
+			glBindFramebuffer( GL_DRAW_FRAMEBUFFER, previousDrawFboID );
+			glBindFramebuffer( GL_READ_FRAMEBUFFER, previosReadFboID );
+		}
+		FFGLStateValidation::SetBinding( FFGLStateValidation::BINDING_DRAW_FBO, (GLuint)previousDrawFboID );
+		FFGLStateValidation::SetBinding( FFGLStateValidation::BINDING_READ_FBO, (GLuint)previosReadFboID );
 		isBound = false;
 	}
 }
@@ -1,5 +1,6 @@
 #pragma once
 #include "../ffgl/FFGL.h"//For OpenGL
+#include "FFGLStateCache.h"
 
 namespace ffglex
 {
@@ -23,6 +24,7 @@ private:
 
 	GLint previousDrawFboID;
 	GLint previosReadFboID;
+	FFGLStateCache* stateCache;//!< The state cache that was active when we were bound, nullptr if there wasn't one.
 };
 
 }//End namespace ffglex
\ No newline at end of file
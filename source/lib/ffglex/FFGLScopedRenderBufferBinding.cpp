@@ -1,11 +1,18 @@
 #include "FFGLScopedRenderBufferBinding.h"
+#include "../ffgl/FFGLStateValidation.h"
 
 namespace ffglex
 {
 ScopedRenderBufferBinding::ScopedRenderBufferBinding( GLuint renderbufferID ) :
-	isBound( true )
+	isBound( true ),
+	stateCache( FFGLStateCache::GetActive() ),
+	previousRenderbufferID( 0 )
 {
-	glBindRenderbuffer( GL_RENDERBUFFER, renderbufferID );
+	if( stateCache != nullptr )
+		previousRenderbufferID = stateCache->BindRenderbuffer( renderbufferID );
+	else
+		glBindRenderbuffer( GL_RENDERBUFFER, renderbufferID );
+	FFGLStateValidation::SetBinding( FFGLStateValidation::BINDING_RENDERBUFFER, renderbufferID );
 }
 ScopedRenderBufferBinding::~ScopedRenderBufferBinding()
 {
@@ -16,7 +23,11 @@ void ScopedRenderBufferBinding::EndScope()
 {
 	if( isBound )
 	{
-		glBindRenderbuffer( GL_RENDERBUFFER, 0 );
+		if( stateCache != nullptr )
+			stateCache->BindRenderbuffer( previousRenderbufferID );
+		else
+			glBindRenderbuffer( GL_RENDERBUFFER, previousRenderbufferID );
+		FFGLStateValidation::SetBinding( FFGLStateValidation::BINDING_RENDERBUFFER, previousRenderbufferID );
 		isBound = false;
 	}
 }
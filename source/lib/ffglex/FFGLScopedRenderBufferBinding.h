@@ -1,5 +1,6 @@
 #pragma once
 #include "../ffgl/FFGL.h"//For OpenGL
+#include "FFGLStateCache.h"
 
 namespace ffglex
 {
@@ -13,6 +14,8 @@ public:
 
 private:
 	bool isBound;
+	FFGLStateCache* stateCache;   //!< The state cache that was active when we were bound, nullptr if there wasn't one.
+	GLuint previousRenderbufferID;//!< The renderbuffer to restore at the end of our scope. Without a state cache we assume the default state, so that's 0.
 };
 
 }//End namespace ffglex
\ No newline at end of file
@@ -1,11 +1,18 @@
 #include "FFGLScopedSamplerActivation.h"
+#include "../ffgl/FFGLStateValidation.h"
 
 namespace ffglex
 {
 ScopedSamplerActivation::ScopedSamplerActivation( GLuint samplerIndex ) :
-	isBound( true )
+	isBound( true ),
+	stateCache( FFGLStateCache::GetActive() ),
+	previousUnit( GL_TEXTURE0 )
 {
-	glActiveTexture( GL_TEXTURE0 + samplerIndex );
+	if( stateCache != nullptr )
+		previousUnit = stateCache->ActiveTexture( GL_TEXTURE0 + samplerIndex );
+	else
+		glActiveTexture( GL_TEXTURE0 + samplerIndex );
+	FFGLStateValidation::SetBinding( FFGLStateValidation::BINDING_ACTIVE_TEXTURE, GL_TEXTURE0 + samplerIndex );
 }
 ScopedSamplerActivation::~ScopedSamplerActivation()
 {
@@ -16,7 +23,11 @@ void ScopedSamplerActivation::EndScope()
 {
 	if( isBound )
 	{
-		glActiveTexture( GL_TEXTURE0 + 0 );
+		if( stateCache != nullptr )
+			stateCache->ActiveTexture( previousUnit );
+		else
+			glActiveTexture( previousUnit );
+		FFGLStateValidation::SetBinding( FFGLStateValidation::BINDING_ACTIVE_TEXTURE, previousUnit );
 		isBound = false;
 	}
 }
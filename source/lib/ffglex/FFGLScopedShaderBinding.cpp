@@ -1,11 +1,18 @@
 #include "FFGLScopedShaderBinding.h"
+#include "../ffgl/FFGLStateValidation.h"
 
 namespace ffglex
 {
 ScopedShaderBinding::ScopedShaderBinding( GLuint shaderID ) :
-	isBound( true )
+	isBound( true ),
+	stateCache( FFGLStateCache::GetActive() ),
+	previousShaderID( 0 )
 {
-	glUseProgram( shaderID );
+	if( stateCache != nullptr )
+		previousShaderID = stateCache->UseProgram( shaderID );
+	else
+		glUseProgram( shaderID );
+	FFGLStateValidation::SetBinding( FFGLStateValidation::BINDING_PROGRAM, shaderID );
 }
 ScopedShaderBinding::~ScopedShaderBinding()
 {
@@ -16,7 +23,11 @@ void ScopedShaderBinding::EndScope()
 {
 	if( isBound )
 	{
-		glUseProgram( 0 );
+		if( stateCache != nullptr )
+			stateCache->UseProgram( previousShaderID );
+		else
+			glUseProgram( previousShaderID );
+		FFGLStateValidation::SetBinding( FFGLStateValidation::BINDING_PROGRAM, previousShaderID );
 		isBound = false;
 	}
 }
@@ -1,12 +1,19 @@
 #include "FFGLScopedTextureBinding.h"
+#include "../ffgl/FFGLStateValidation.h"
 
 namespace ffglex
 {
 ScopedTextureBinding::ScopedTextureBinding( GLenum target, GLuint textureID ) :
 	target( target ),
-	isBound( true )
+	isBound( true ),
+	stateCache( FFGLStateCache::GetActive() ),
+	previousTextureID( 0 )
 {
-	glBindTexture( target, textureID );
+	if( stateCache != nullptr )
+		previousTextureID = stateCache->BindTexture( target, textureID );
+	else
+		glBindTexture( target, textureID );
+	FFGLStateValidation::SetTextureBinding( target, textureID );
 }
 ScopedTextureBinding::~ScopedTextureBinding()
 {
@@ -17,7 +24,11 @@ void ScopedTextureBinding::EndScope()
 {
 	if( isBound )
 	{
-		glBindTexture( target, 0 );
+		if( stateCache != nullptr )
+			stateCache->BindTexture( target, previousTextureID );
+		else
+			glBindTexture( target, previousTextureID );
+		FFGLStateValidation::SetTextureBinding( target, previousTextureID );
 		isBound = false;
 	}
 }
@@ -1,5 +1,6 @@
 #pragma once
 #include "../ffgl/FFGL.h"//For OpenGL
+#include "FFGLStateCache.h"
 
 namespace ffglex
 {
@@ -14,6 +15,8 @@ public:
 private:
 	GLenum target;
 	bool isBound;
+	FFGLStateCache* stateCache;//!< The state cache that was active when we were bound, nullptr if there wasn't one.
+	GLuint previousTextureID;  //!< The texture to restore at the end of our scope. Without a state cache we assume the default state, so that's 0.
 };
 
 class Scoped2DTextureBinding : public ScopedTextureBinding
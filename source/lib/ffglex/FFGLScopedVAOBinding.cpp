@@ -1,11 +1,18 @@
 #include "FFGLScopedVAOBinding.h"
+#include "../ffgl/FFGLStateValidation.h"
 
 namespace ffglex
 {
 ScopedVAOBinding::ScopedVAOBinding( GLuint vaoID ) :
-	isBound( true )
+	isBound( true ),
+	stateCache( FFGLStateCache::GetActive() ),
+	previousVaoID( 0 )
 {
-	glBindVertexArray( vaoID );
+	if( stateCache != nullptr )
+		previousVaoID = stateCache->BindVertexArray( vaoID );
+	else
+		glBindVertexArray( vaoID );
+	FFGLStateValidation::SetBinding( FFGLStateValidation::BINDING_VAO, vaoID );
 }
 ScopedVAOBinding::~ScopedVAOBinding()
 {
@@ -16,7 +23,11 @@ void ScopedVAOBinding::EndScope()
 {
 	if( isBound )
 	{
-		glBindVertexArray( 0 );
+		if( stateCache != nullptr )
+			stateCache->BindVertexArray( previousVaoID );
+		else
+			glBindVertexArray( previousVaoID );
+		FFGLStateValidation::SetBinding( FFGLStateValidation::BINDING_VAO, previousVaoID );
 		isBound = false;
 	}
 }
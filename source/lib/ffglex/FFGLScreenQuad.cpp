@@ -3,6 +3,7 @@
 #include "FFGLScopedVAOBinding.h"
 #include "FFGLScopedBufferBinding.h"
 #include "FFGLUtilities.h"
+#include "../ffgl/FFGLInstanceStats.h"
 
 namespace ffglex
 {
@@ -30,6 +31,7 @@ bool FFGLScreenQuad::Initialise( bool flipV )
 {
 	glGenVertexArrays( 1, &vaoID );
 	glGenBuffers( 1, &vboID );
+	FFGLInstanceStats::AddGLObjects( ( vaoID != 0 ? 1 : 0 ) + ( vboID != 0 ? 1 : 0 ) );
 	if( vaoID == 0 || vboID == 0 )
 	{
 		Release();
@@ -44,6 +46,7 @@ bool FFGLScreenQuad::Initialise( bool flipV )
 		glBufferData( GL_ARRAY_BUFFER, sizeof( FLIPPED_TEXTURED_QUAD_VERTICES ), FLIPPED_TEXTURED_QUAD_VERTICES, GL_STATIC_DRAW );
 	else
 		glBufferData( GL_ARRAY_BUFFER, sizeof( TEXTURED_QUAD_VERTICES ), TEXTURED_QUAD_VERTICES, GL_STATIC_DRAW );
+	FFGLInstanceStats::AddUploadedBytes( sizeof( TEXTURED_QUAD_VERTICES ) );
 
 	glEnableVertexAttribArray( 0 );
 	glVertexAttribPointer( 0, 3, GL_FLOAT, false, sizeof( TEXTURED_QUAD_VERTICES[ 0 ] ), (char*)NULL + 2 * sizeof( float ) );
@@ -72,6 +75,7 @@ void FFGLScreenQuad::Draw()
  */
 void FFGLScreenQuad::Release()
 {
+	FFGLInstanceStats::AddGLObjects( -( ( vaoID != 0 ? 1 : 0 ) + ( vboID != 0 ? 1 : 0 ) ) );
 	glDeleteBuffers( 1, &vboID );
 	vboID = 0;
 	glDeleteVertexArrays( 1, &vaoID );
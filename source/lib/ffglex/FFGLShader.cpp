@@ -2,12 +2,156 @@
 #include <stdio.h>
 #include <vector>
 #include <assert.h>
+#include <algorithm>
 #include "FFGLUtilities.h"
+#include "../ffgl/FFGLInstanceStats.h"
 
 #define LOGSHADERERRORS
 
 namespace ffglex
 {
+/**
+ * FNV-1a hash of a uniform's name. We're using our own hash on the raw string instead of std::hash
+ * so that finding a uniform doesn't require constructing an std::string.
+ */
+static size_t HashUniformName( const char* name )
+{
+	size_t hash = 2166136261u;
+	for( ; *name != 0; ++name )
+	{
+		hash ^= (unsigned char)*name;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+/**
+ * The number of components a uniform of the given type has, used to validate that a handle is set using the right Set overload.
+ * Matrices aren't settable through the Set functions so they report 0.
+ */
+static int GetNumComponents( GLenum type )
+{
+	switch( type )
+	{
+	case GL_FLOAT_VEC2:
+	case GL_INT_VEC2:
+	case GL_UNSIGNED_INT_VEC2:
+	case GL_BOOL_VEC2:
+		return 2;
+	case GL_FLOAT_VEC3:
+	case GL_INT_VEC3:
+	case GL_UNSIGNED_INT_VEC3:
+	case GL_BOOL_VEC3:
+		return 3;
+	case GL_FLOAT_VEC4:
+	case GL_INT_VEC4:
+	case GL_UNSIGNED_INT_VEC4:
+	case GL_BOOL_VEC4:
+		return 4;
+	case GL_FLOAT_MAT2:
+	case GL_FLOAT_MAT3:
+	case GL_FLOAT_MAT4:
+	case GL_FLOAT_MAT2x3:
+	case GL_FLOAT_MAT2x4:
+	case GL_FLOAT_MAT3x2:
+	case GL_FLOAT_MAT3x4:
+	case GL_FLOAT_MAT4x2:
+	case GL_FLOAT_MAT4x3:
+		return 0;
+	default:
+		//Scalars, bools and samplers.
+		return 1;
+	}
+}
+/**
+ * Combines everything a program is built from into a single string, which is used as the program's key in the registry.
+ * The stages are separated by a nul character so that moving code from one stage to the next results in a different key.
+ */
+static std::string GetProgramSources( const char* vertexShader, const char* geometryShader, const char* fragmentShader, const std::vector< std::string >& transformFeedbackVaryings )
+{
+	std::string sources = vertexShader;
+	sources += '\0';
+	if( geometryShader != nullptr )
+		sources += geometryShader;
+	sources += '\0';
+	if( fragmentShader != nullptr )
+		sources += fragmentShader;
+	for( const std::string& varying : transformFeedbackVaryings )
+	{
+		sources += '\0';
+		sources += varying;
+	}
+	return sources;
+}
+/**
+ * Whether or not the driver can compile and link in the background and tell us when it's done, without that
+ * querying whether a shader has compiled blocks until the driver is done compiling it.
+ */
+static bool HasParallelShaderCompile()
+{
+#if defined( FFGL_MACOS )
+	return false;
+#else
+	return GLEW_KHR_parallel_shader_compile == GL_TRUE;
+#endif
+}
+/**
+ * Checks whether a shader compiled successfully, logging the driver's errors if it didn't and the shader's log site allows it.
+ */
+static bool CheckCompileStatus( GLuint shaderID, const char* errorPrefix, FFGLLogSite& logSite )
+{
+	GLint compileStatus;
+	glGetShaderiv( shaderID, GL_COMPILE_STATUS, &compileStatus );
+
+	uint32_t numSuppressed = 0;
+	if( compileStatus != GL_TRUE && logSite.ShouldLog( numSuppressed ) )
+	{
+#ifdef LOGSHADERERRORS
+		GLint logLength;
+		glGetShaderiv( shaderID, GL_INFO_LOG_LENGTH, &logLength );
+		std::vector< GLchar > log( logLength + 1 );
+		memset( log.data(), 0, logLength + 1 );
+		glGetShaderInfoLog( shaderID, logLength, NULL, log.data() );
+
+		FFGLLog::LogToHost( FFGLLog::LL_ERROR, errorPrefix + std::string( log.data() ), numSuppressed );
+#endif
+	}
+
+	return compileStatus == GL_TRUE;
+}
+/**
+ * Checks whether a program linked successfully, logging the driver's errors if it didn't and the shader's log site allows it.
+ */
+static bool CheckLinkStatus( GLuint programID, FFGLLogSite& logSite )
+{
+	GLint linkStatus = 0;
+	glGetProgramiv( programID, GL_LINK_STATUS, &linkStatus );
+
+	uint32_t numSuppressed = 0;
+	if( linkStatus != GL_TRUE && logSite.ShouldLog( numSuppressed ) )
+	{
+#ifdef LOGSHADERERRORS
+		//get the log so we can peek at the error string
+		char log[ 1024 ];
+		GLsizei returnedLength = 0;
+		glGetProgramInfoLog( programID, sizeof( log ) - 1, &returnedLength, log );
+		log[ returnedLength ] = 0;
+
+		FFGLLog::LogToHost( FFGLLog::LL_ERROR, "Program link error: " + std::string( log ), numSuppressed );
+#endif
+	}
+
+	return linkStatus == GL_TRUE;
+}
+/**
+ * Whether or not a program has linked successfully, without logging anything. Waits for the driver if it's still linking.
+ */
+static bool IsProgramLinked( GLuint programID )
+{
+	GLint linkStatus = 0;
+	glGetProgramiv( programID, GL_LINK_STATUS, &linkStatus );
+	return linkStatus == GL_TRUE;
+}
+
 /**
  * The default constructor just initializes this object to represent no shader.
  */
@@ -15,7 +159,10 @@ FFGLShader::FFGLShader() :
 	vertexShaderID( 0 ),
 	geometryShaderID( 0 ),
 	fragmentShaderID( 0 ),
-	programID( 0 )
+	programID( 0 ),
+	sharedProgram( nullptr ),
+	asyncCompile( false ),
+	isCompiling( false )
 {
 }
 /**
@@ -28,6 +175,7 @@ FFGLShader::~FFGLShader()
 	assert( geometryShaderID == 0 );
 	assert( fragmentShaderID == 0 );
 	assert( programID == 0 );
+	assert( sharedProgram == nullptr );
 }
 
 /**
@@ -42,6 +190,20 @@ void FFGLShader::AddTransformFeedbackVarying( const std::string& varyingName )
 {
 	transformFeedbackVaryings.push_back( varyingName );
 }
+/**
+ * Makes Compile only submit the shaders to the driver instead of waiting for it to compile and link them. Compiling
+ * can easily take tens of milliseconds, which is a visible hitch when a plugin is loaded while the host is rendering.
+ * After an async compile the shader isn't ready until PollCompile has returned true, call that each frame and skip
+ * rendering with this shader until it does.
+ * The driver can only compile in the background if it supports KHR_parallel_shader_compile, without it PollCompile
+ * waits for the driver to finish on the first poll.
+ *
+ * @param async: Whether or not subsequent calls to Compile should return before the driver has finished compiling.
+ */
+void FFGLShader::SetAsyncCompile( bool async )
+{
+	asyncCompile = async;
+}
 /**
  * Compiles and links two shaders into a shader program.
  *
@@ -78,6 +240,12 @@ bool FFGLShader::Compile( const char* vertexShader, const char* fragmentShader )
 	if( ( fragmentShader == nullptr || strlen( fragmentShader ) == 0 ) && transformFeedbackVaryings.empty() )
 		return false;
 
+	//Another instance of this plugin has probably linked these same sources already, then we can use that program right away.
+	//Otherwise a previous run of the plugin may have stored the program in the cache.
+	std::string sources = GetProgramSources( vertexShader, nullptr, fragmentShader, transformFeedbackVaryings );
+	if( AcquireSharedProgram( sources ) || LoadCachedProgram( sources ) )
+		return true;
+
 	//Everything needs to succeed for this to be a usable shader. If anything fails we'll be cleaning up everything
 	//so that we wont keep anything that wont be used alive.
 	if( !CompileVertexShader( vertexShader ) )
@@ -96,6 +264,17 @@ bool FFGLShader::Compile( const char* vertexShader, const char* fragmentShader )
 		FreeGLResources();
 		return false;
 	}
+	if( asyncCompile )
+	{
+		//The driver is compiling in the background, PollCompile checks the results once it's done. The program is registered
+		//right away so that shaders compiling the same sources in the meantime share this compile instead of starting their own.
+		sharedProgram  = FFGLProgramRegistry::Add( sources, programID, true );
+		pendingSources = std::move( sources );
+		isCompiling    = true;
+		return true;
+	}
+	FFGLProgramCache::Store( sources, programID );
+	sharedProgram = FFGLProgramRegistry::Add( sources, programID );
 
 	return true;
 }
@@ -122,6 +301,10 @@ bool FFGLShader::Compile( const char* vertexShader, const char* geometryShader,
 	if( ( fragmentShader == nullptr || strlen( fragmentShader ) == 0 ) && transformFeedbackVaryings.empty() )
 		return false;
 
+	std::string sources = GetProgramSources( vertexShader, geometryShader, fragmentShader, transformFeedbackVaryings );
+	if( AcquireSharedProgram( sources ) || LoadCachedProgram( sources ) )
+		return true;
+
 	//If anything fails we'll be cleaning up everything so that we wont keep anything that wont be used alive.
 	if( !CompileVertexShader( vertexShader ) )
 	{
@@ -146,6 +329,17 @@ bool FFGLShader::Compile( const char* vertexShader, const char* geometryShader,
 		FreeGLResources();
 		return false;
 	}
+	if( asyncCompile )
+	{
+		//The driver is compiling in the background, PollCompile checks the results once it's done. The program is registered
+		//right away so that shaders compiling the same sources in the meantime share this compile instead of starting their own.
+		sharedProgram  = FFGLProgramRegistry::Add( sources, programID, true );
+		pendingSources = std::move( sources );
+		isCompiling    = true;
+		return true;
+	}
+	FFGLProgramCache::Store( sources, programID );
+	sharedProgram = FFGLProgramRegistry::Add( sources, programID );
 
 	return true;
 }
@@ -159,26 +353,43 @@ void FFGLShader::FreeGLResources()
 	if( vertexShaderID != 0 )
 	{
 		glDeleteShader( vertexShaderID );
+		FFGLInstanceStats::AddGLObjects( -1 );
 		vertexShaderID = 0;
 	}
 
 	if( fragmentShaderID != 0 )
 	{
 		glDeleteShader( fragmentShaderID );
+		FFGLInstanceStats::AddGLObjects( -1 );
 		fragmentShaderID = 0;
 	}
 
 	if( geometryShaderID != 0 )
 	{
 		glDeleteShader( geometryShaderID );
+		FFGLInstanceStats::AddGLObjects( -1 );
 		geometryShaderID = 0;
 	}
 
+	if( sharedProgram != nullptr )
+	{
+		//Other shaders may still be using our program, the registry deletes it once the last one has released it.
+		if( sharedProgram->uniformOwner == this )
+			sharedProgram->uniformOwner = nullptr;
+		FFGLProgramRegistry::Release( sharedProgram );
+		sharedProgram = nullptr;
+		programID     = 0;
+	}
 	if( programID != 0 )
 	{
 		glDeleteProgram( programID );
+		FFGLInstanceStats::AddGLObjects( -1 );
 		programID = 0;
 	}
+
+	uniforms.clear();
+	pendingSources.clear();
+	isCompiling = false;
 }
 
 void FFGLShader::Set( const char* name, float value )
@@ -201,14 +412,96 @@ void FFGLShader::Set( const char* name, int value )
 {
 	glUniform1i( FindUniform( name ), value );
 }
+void FFGLShader::Set( UniformHandle uniform, float value )
+{
+	assert( !uniform.IsValid() || GetNumComponents( uniform.type ) == 1 );
+	glUniform1f( uniform.location, value );
+}
+void FFGLShader::Set( UniformHandle uniform, float v1, float v2 )
+{
+	assert( !uniform.IsValid() || GetNumComponents( uniform.type ) == 2 );
+	glUniform2f( uniform.location, v1, v2 );
+}
+void FFGLShader::Set( UniformHandle uniform, float v1, float v2, float v3 )
+{
+	assert( !uniform.IsValid() || GetNumComponents( uniform.type ) == 3 );
+	glUniform3f( uniform.location, v1, v2, v3 );
+}
+void FFGLShader::Set( UniformHandle uniform, float v1, float v2, float v3, float v4 )
+{
+	assert( !uniform.IsValid() || GetNumComponents( uniform.type ) == 4 );
+	glUniform4f( uniform.location, v1, v2, v3, v4 );
+}
+void FFGLShader::Set( UniformHandle uniform, int value )
+{
+	assert( !uniform.IsValid() || GetNumComponents( uniform.type ) == 1 );
+	glUniform1i( uniform.location, value );
+}
 
+/**
+ * Finishes an async compile once the driver is done compiling and linking. Call this each frame after an async
+ * Compile until it returns true, without KHR_parallel_shader_compile the first call waits for the driver.
+ * If compiling or linking failed the errors are logged and the shader's gl resources are freed, just like a failed
+ * synchronous Compile would do, so when this returns false while IsCompiling is false the shader has failed.
+ *
+ * @return: Whether or not the shader is ready to be used for rendering.
+ */
+bool FFGLShader::PollCompile()
+{
+	if( !isCompiling )
+		return IsReady();
+
+	if( HasParallelShaderCompile() )
+	{
+		GLint isComplete = GL_FALSE;
+		glGetProgramiv( programID, GL_COMPLETION_STATUS_KHR, &isComplete );
+		if( isComplete != GL_TRUE )
+			return false;
+	}
+
+	//Everything needs to succeed for this to be a usable shader. If anything fails we'll be cleaning up everything
+	//so that we wont keep anything that wont be used alive. Shaders that share another shader's compile dont have the
+	//shaders to check, they only check the link status and leave logging the errors to the shader that compiled them.
+	bool succeeded;
+	if( vertexShaderID != 0 )
+	{
+		succeeded = CheckCompileStatus( vertexShaderID, "Vertex Shader error: ", errorLogSite );
+		succeeded = succeeded && ( geometryShaderID == 0 || CheckCompileStatus( geometryShaderID, "Geometry Shader error: ", errorLogSite ) );
+		succeeded = succeeded && ( fragmentShaderID == 0 || CheckCompileStatus( fragmentShaderID, "Fragment Shader error: ", errorLogSite ) );
+		succeeded = succeeded && CheckLinkStatus( programID, errorLogSite );
+	}
+	else
+	{
+		succeeded = IsProgramLinked( programID );
+	}
+	if( !succeeded )
+	{
+		FreeGLResources();
+		return false;
+	}
+
+	isCompiling              = false;
+	sharedProgram->isLinking = false;
+	CacheUniforms();
+	if( !pendingSources.empty() )
+		FFGLProgramCache::Store( pendingSources, programID );
+	pendingSources.clear();
+	return true;
+}
+/**
+ * Whether or not an async compile has been started that PollCompile hasn't finished yet.
+ */
+bool FFGLShader::IsCompiling() const
+{
+	return isCompiling;
+}
 /**
  * Whether or not previous complilation succeeded and this shader is ready to be used for rendering.
  */
 bool FFGLShader::IsReady() const
 {
 	//The shaders themselves are optional, it's the program we're using when rendering with those shaders.
-	return programID != 0;
+	return programID != 0 && !isCompiling;
 }
 /**
  * Gets the OpenGL ID that represents the linked shader program.
@@ -229,12 +522,91 @@ GLuint FFGLShader::GetGLID() const
  */
 GLint FFGLShader::FindUniform( const char* name ) const
 {
-	return glGetUniformLocation( programID, name );
+	return GetUniform( name ).location;
+}
+/**
+ * Resolves a uniform by name into a handle that can be used to set it without looking it up again.
+ * All active uniforms are cached when the program is linked so this doesn't need a round trip to the driver,
+ * but if you're setting a uniform each frame you should still get it's handle once and hold on to it.
+ *
+ * @param name: The name of the uniform, array uniforms can be found by their name, or by the name of any of their elements (eg "colors[2]").
+ * @return: The uniform's handle. The handle is invalid if the uniform doesn't exist or has been optimized out by the compiler,
+ * setting an invalid handle is a no-op just like setting location -1.
+ */
+UniformHandle FFGLShader::GetUniform( const char* name ) const
+{
+	CachedUniform key;
+	key.nameHash = HashUniformName( name );
+	auto it      = std::lower_bound( uniforms.begin(), uniforms.end(), key );
+	for( ; it != uniforms.end() && it->nameHash == key.nameHash; ++it )
+	{
+		if( it->name == name )
+			return it->handle;
+	}
+
+	return UniformHandle();
+}
+/**
+ * Makes this shader the one whose uniform values the program holds.
+ * Shaders that are compiled from the same sources share their program, and uniform values are stored in the program. If you're only
+ * setting the uniforms that have changed since the previous frame you need to call this first, when it returns false another shader
+ * may have set the uniforms since you've last set them, so you have to set all of them again.
+ * Shaders that set all of their uniforms before drawing, like most plugins do, dont need to care about this.
+ *
+ * @return: Whether the program's uniforms still hold the values this shader has set.
+ */
+bool FFGLShader::ClaimUniforms()
+{
+	if( sharedProgram == nullptr )
+		return true;
+
+	bool wasOwner               = sharedProgram->uniformOwner == this;
+	sharedProgram->uniformOwner = this;
+	return wasOwner;
+}
+
+bool FFGLShader::AcquireSharedProgram( const std::string& sources )
+{
+	sharedProgram = FFGLProgramRegistry::Acquire( sources );
+	if( sharedProgram == nullptr )
+		return false;
+
+	programID = sharedProgram->programID;
+	//Another shader is still compiling the program async. Async shaders poll it just like they'd poll their own compile,
+	//others have to wait for the driver. If it failed we compile it ourselves so that the errors are reported to us as well.
+	if( sharedProgram->isLinking )
+	{
+		if( asyncCompile )
+		{
+			isCompiling = true;
+			return true;
+		}
+		if( !IsProgramLinked( programID ) )
+		{
+			FFGLProgramRegistry::Release( sharedProgram );
+			sharedProgram = nullptr;
+			programID     = 0;
+			return false;
+		}
+		sharedProgram->isLinking = false;
+	}
+	CacheUniforms();
+	return true;
 }
+bool FFGLShader::LoadCachedProgram( const std::string& sources )
+{
+	programID = FFGLProgramCache::Load( sources );
+	if( programID == 0 )
+		return false;
 
+	sharedProgram = FFGLProgramRegistry::Add( sources, programID );
+	CacheUniforms();
+	return true;
+}
 bool FFGLShader::CompileVertexShader( const char* vertexShader )
 {
 	vertexShaderID = glCreateShader( GL_VERTEX_SHADER );
+	FFGLInstanceStats::AddGLObjects( 1 );
 
 	// Load Shader Sources
 	glShaderSource( vertexShaderID, 1, &vertexShader, NULL );
@@ -242,27 +614,13 @@ bool FFGLShader::CompileVertexShader( const char* vertexShader )
 	// Compile The Shaders
 	glCompileShader( vertexShaderID );
 
-	GLint compileStatus;
-	glGetShaderiv( vertexShaderID, GL_COMPILE_STATUS, &compileStatus );
-
-	if( compileStatus != GL_TRUE )
-	{
-#ifdef LOGSHADERERRORS
-		GLint logLength;
-		glGetShaderiv( vertexShaderID, GL_INFO_LOG_LENGTH, &logLength );
-		std::vector< GLchar > log( logLength + 1 );
-		memset( log.data(), 0, logLength + 1 );
-		glGetShaderInfoLog( vertexShaderID, logLength, NULL, log.data() );
-
-		Log( "Vertex Shader error: ", log.data() );
-#endif
-	}
-
-	return compileStatus == GL_TRUE;
+	//When compiling async the driver may not be done yet, PollCompile checks the result once it is.
+	return asyncCompile || CheckCompileStatus( vertexShaderID, "Vertex Shader error: ", errorLogSite );
 }
 bool FFGLShader::CompileGeometryShader( const char* geometryShader )
 {
 	geometryShaderID = glCreateShader( GL_GEOMETRY_SHADER );
+	FFGLInstanceStats::AddGLObjects( 1 );
 
 	// Load Shader Sources
 	glShaderSource( geometryShaderID, 1, &geometryShader, NULL );
@@ -270,27 +628,13 @@ bool FFGLShader::CompileGeometryShader( const char* geometryShader )
 	// Compile The Shaders
 	glCompileShader( geometryShaderID );
 
-	GLint compileStatus;
-	glGetShaderiv( geometryShaderID, GL_COMPILE_STATUS, &compileStatus );
-
-	if( compileStatus != GL_TRUE )
-	{
-#ifdef LOGSHADERERRORS
-		GLint logLength;
-		glGetShaderiv( geometryShaderID, GL_INFO_LOG_LENGTH, &logLength );
-		std::vector< GLchar > log( logLength + 1 );
-		memset( log.data(), 0, logLength + 1 );
-		glGetShaderInfoLog( geometryShaderID, logLength, NULL, log.data() );
-
-		Log( "Geometry Shader error: ", log.data() );
-#endif
-	}
-
-	return compileStatus == GL_TRUE;
+	//When compiling async the driver may not be done yet, PollCompile checks the result once it is.
+	return asyncCompile || CheckCompileStatus( geometryShaderID, "Geometry Shader error: ", errorLogSite );
 }
 bool FFGLShader::CompileFragmentShader( const char* fragmentShader )
 {
 	fragmentShaderID = glCreateShader( GL_FRAGMENT_SHADER );
+	FFGLInstanceStats::AddGLObjects( 1 );
 
 	// Load Shader Sources
 	glShaderSource( fragmentShaderID, 1, &fragmentShader, NULL );
@@ -298,27 +642,13 @@ bool FFGLShader::CompileFragmentShader( const char* fragmentShader )
 	// Compile The Shaders
 	glCompileShader( fragmentShaderID );
 
-	GLint compileStatus;
-	glGetShaderiv( fragmentShaderID, GL_COMPILE_STATUS, &compileStatus );
-
-	if( compileStatus != GL_TRUE )
-	{
-#ifdef LOGSHADERERRORS
-		GLint logLength;
-		glGetShaderiv( fragmentShaderID, GL_INFO_LOG_LENGTH, &logLength );
-		std::vector< GLchar > log( logLength + 1 );
-		memset( log.data(), 0, logLength + 1 );
-		glGetShaderInfoLog( fragmentShaderID, logLength, NULL, log.data() );
-
-		Log( "Fragment Shader error: ", log.data() );
-#endif
-	}
-
-	return compileStatus == GL_TRUE;
+	//When compiling async the driver may not be done yet, PollCompile checks the result once it is.
+	return asyncCompile || CheckCompileStatus( fragmentShaderID, "Fragment Shader error: ", errorLogSite );
 }
 bool FFGLShader::LinkProgram()
 {
 	programID = glCreateProgram();
+	FFGLInstanceStats::AddGLObjects( 1 );
 
 	glAttachShader( programID, vertexShaderID );
 	if( geometryShaderID != 0 )
@@ -334,24 +664,70 @@ bool FFGLShader::LinkProgram()
 		glTransformFeedbackVaryings( programID, (GLsizei)feedbackVaryingNames.size(), feedbackVaryingNames.data(), GL_INTERLEAVED_ATTRIBS );
 	}
 
-	GLint linkStatus = 0;
+	//Drivers may only keep the binary around for the cache if we ask them to before linking.
+	if( FFGLProgramCache::IsEnabled() )
+		glProgramParameteri( programID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE );
+
 	glLinkProgram( programID );
-	glGetProgramiv( programID, GL_LINK_STATUS, &linkStatus );
+	if( asyncCompile )
+		return true;
+	if( !CheckLinkStatus( programID, errorLogSite ) )
+		return false;
 
-	if( linkStatus != GL_TRUE )
-	{
-#ifdef LOGSHADERERRORS
-		//get the log so we can peek at the error string
-		char log[ 1024 ];
-		GLsizei returnedLength;
-		glGetProgramInfoLog( fragmentShaderID, sizeof( log ) - 1, &returnedLength, log );
-		log[ returnedLength ] = 0;
+	CacheUniforms();
+	return true;
+}
+void FFGLShader::CacheUniforms()
+{
+	uniforms.clear();
 
-		Log( "Fragment Shader error: ", log );
-#endif
+	GLint numUniforms   = 0;
+	GLint maxNameLength = 0;
+	glGetProgramiv( programID, GL_ACTIVE_UNIFORMS, &numUniforms );
+	glGetProgramiv( programID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength );
+
+	std::vector< GLchar > nameBuffer( maxNameLength + 1 );
+	for( GLint index = 0; index < numUniforms; ++index )
+	{
+		GLsizei nameLength = 0;
+		UniformHandle handle;
+		glGetActiveUniform( programID, (GLuint)index, (GLsizei)nameBuffer.size(), &nameLength, &handle.size, &handle.type, nameBuffer.data() );
+		std::string name( nameBuffer.data(), nameLength );
+
+		//Members of uniform blocks are reported as active uniforms too, but they dont have a location.
+		handle.location = glGetUniformLocation( programID, name.c_str() );
+		if( handle.location == -1 )
+			continue;
+		AddUniform( name, handle );
+
+		//Arrays are reported by the name of their first element, eg "colors[0]". Glsl allows to address them by their
+		//base name and by each of their elements so we're caching all of those too.
+		size_t arraySuffix = name.rfind( "[0]" );
+		if( arraySuffix == std::string::npos || arraySuffix + 3 != name.size() )
+			continue;
+		std::string baseName = name.substr( 0, arraySuffix );
+		AddUniform( baseName, handle );
+		for( GLint element = 1; element < handle.size; ++element )
+		{
+			std::string elementName = baseName + "[" + std::to_string( element ) + "]";
+			UniformHandle elementHandle;
+			elementHandle.location = glGetUniformLocation( programID, elementName.c_str() );
+			elementHandle.type     = handle.type;
+			elementHandle.size     = handle.size - element;
+			if( elementHandle.location != -1 )
+				AddUniform( elementName, elementHandle );
+		}
 	}
 
-	return linkStatus == GL_TRUE;
+	std::sort( uniforms.begin(), uniforms.end() );
+}
+void FFGLShader::AddUniform( const std::string& name, UniformHandle handle )
+{
+	CachedUniform uniform;
+	uniform.nameHash = HashUniformName( name.c_str() );
+	uniform.name     = name;
+	uniform.handle   = handle;
+	uniforms.push_back( uniform );
 }
 
 }//End namespace ffglex
\ No newline at end of file
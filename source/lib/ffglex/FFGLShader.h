@@ -1,15 +1,38 @@
 #pragma once
 #include "../ffgl/FFGL.h"//For OpenGL
+#include "FFGLProgramRegistry.h"
+#include "FFGLProgramCache.h"
+#include "../ffgl/FFGLLog.h"
 #include <vector>
 #include <string>
-#include <string>
 
 namespace ffglex
 {
+/**
+ * A UniformHandle is the resolved location of a uniform inside a specific shader program. Get one from FFGLShader::GetUniform
+ * once after compiling and pass it to FFGLShader::Set to update the uniform without having to look it up again.
+ * Handles are invalidated when the shader is recompiled or when it's gl resources are freed.
+ */
+struct UniformHandle
+{
+	GLint location = -1;//!< The location to pass into glUniform*. -1 if the uniform doesn't exist or has been optimized out.
+	GLenum type    = 0; //!< The uniform's type as reported by glGetActiveUniform, eg GL_FLOAT_VEC3.
+	GLint size     = 0; //!< The number of array elements starting at this location, 1 for non-array uniforms.
+
+	bool IsValid() const
+	{
+		return location != -1;
+	}
+};
+
 /**
  * The FFGLShader is a helper class you can use to compile glsl shader strings
  * and link them together into a shader program. You can then get the program id
  * and use it to bind the resulting shader to use it for the next rendering operation.
+ * Shaders compiled from the same sources on the same context share their program through the FFGLProgramRegistry,
+ * so that only the first instance of a plugin has to wait for the driver to compile and link it. When the FFGLProgramCache
+ * is enabled the first instance loads the program from disk if it has been linked before.
+ * When even that first compile shouldn't block the render thread the shader can be compiled async, see SetAsyncCompile.
  */
 class FFGLShader final
 {
@@ -22,31 +45,63 @@ public:
 	bool Compile( const char* vertexShader, const char* fragmentShader );                            //Compiles and links two shaders into a shader program.
 	bool Compile( const char* vertexShader, const char* geometryShader, const char* fragmentShader );//Compiles and links a vertex/geometry/fragment shader into a single shader program.
 	void FreeGLResources();                                                                          //Frees any GL resources that this shader is holding.
+	void SetAsyncCompile( bool async );                                                              //Makes Compile return before the driver has compiled and linked the shaders, call PollCompile until the shader is ready.
+	bool PollCompile();                                                                              //Finishes an async compile once the driver is done. Returns whether or not the shader is ready to be used for rendering.
+	bool IsCompiling() const;                                                                        //Whether or not an async compile has been started that PollCompile hasn't finished yet.
 
 	void Set( const char* name, float value );
 	void Set( const char* name, float v1, float v2 );
 	void Set( const char* name, float v1, float v2, float v3 );
 	void Set( const char* name, float v1, float v2, float v3, float v4 );
 	void Set( const char* name, int value );
+	void Set( UniformHandle uniform, float value );
+	void Set( UniformHandle uniform, float v1, float v2 );
+	void Set( UniformHandle uniform, float v1, float v2, float v3 );
+	void Set( UniformHandle uniform, float v1, float v2, float v3, float v4 );
+	void Set( UniformHandle uniform, int value );
 
-	bool IsReady() const;                       //Whether or not previous complilation succeeded and this shader is ready to be used for rendering.
-	GLuint GetGLID() const;                     //Gets the OpenGL ID that represents the linked shader program.
-	GLint FindUniform( const char* name ) const;//Finds the uniform location that needs to be used to addess a uniform with a certain name.
+	bool IsReady() const;                              //Whether or not previous complilation succeeded and this shader is ready to be used for rendering.
+	GLuint GetGLID() const;                            //Gets the OpenGL ID that represents the linked shader program.
+	GLint FindUniform( const char* name ) const;       //Finds the uniform location that needs to be used to addess a uniform with a certain name.
+	UniformHandle GetUniform( const char* name ) const;//Resolves a uniform by name into a handle that can be used to set it without looking it up again.
+	bool ClaimUniforms();                              //Makes this shader the one whose uniform values the program holds. Returns false if another shader sharing the program may have changed them.
 
 	FFGLShader& operator=( const FFGLShader& ) = delete;
 	FFGLShader& operator=( FFGLShader&& ) = delete;
 
 private:
-	bool CompileVertexShader( const char* vertexShader );    //Internal utility function that tries to compile a vertex shader and updates the internal vertexShaderID. Doesn't clean up on failure.
-	bool CompileGeometryShader( const char* geometryShader );//Internal utility function that tries to compile a geometry shader and updates the internal geometryShaderID. Doesn't clean up on failure.
-	bool CompileFragmentShader( const char* fragmentShader );//Internal utility function that tries to compile a fragment shader and updates the internal fragmentShaderID. Doesn't clean up on failure.
-	bool LinkProgram();                                      //Internal utility function that tries to link the two previously compiled vertex and fragment shaders into a program. Doesn't clean up on failure.
+	bool CompileVertexShader( const char* vertexShader );            //Internal utility function that tries to compile a vertex shader and updates the internal vertexShaderID. Doesn't clean up on failure.
+	bool CompileGeometryShader( const char* geometryShader );        //Internal utility function that tries to compile a geometry shader and updates the internal geometryShaderID. Doesn't clean up on failure.
+	bool CompileFragmentShader( const char* fragmentShader );        //Internal utility function that tries to compile a fragment shader and updates the internal fragmentShaderID. Doesn't clean up on failure.
+	bool LinkProgram();                                              //Internal utility function that tries to link the two previously compiled vertex and fragment shaders into a program. Doesn't clean up on failure.
+	void CacheUniforms();                                            //Internal utility function that fills the uniform cache with all active uniforms of the linked program.
+	void AddUniform( const std::string& name, UniformHandle handle );//Internal utility function that adds a single entry to the uniform cache.
+	bool AcquireSharedProgram( const std::string& sources );         //Internal utility function that tries to use a program that another shader has already linked from the same sources.
+	bool LoadCachedProgram( const std::string& sources );            //Internal utility function that tries to load the program from the program binary cache.
+
+	struct CachedUniform
+	{
+		size_t nameHash;
+		std::string name;
+		UniformHandle handle;
+
+		bool operator<( const CachedUniform& other ) const
+		{
+			return nameHash < other.nameHash;
+		}
+	};
 
 	GLuint vertexShaderID;                               //!< The ID OpenGL gave our vertex shader. 0 for invalid.
 	GLuint geometryShaderID;                             //!< The ID OpenGL gave our geometry shader. 0 if not present or invalid.
 	GLuint fragmentShaderID;                             //!< The ID OpenGL gave our fragment shader. 0 for invalid.
 	GLuint programID;                                    //!< The ID OpenGL gave our shader program. Bind this to use this shader. 0 for invalid.
+	SharedProgram* sharedProgram;                        //!< The registry's entry for our program, through which other shaders compiled from the same sources share it, even while it's being compiled async. nullptr while not compiled.
+	bool asyncCompile;                                   //!< Whether or not Compile should return without waiting for the driver to finish compiling.
+	bool isCompiling;                                    //!< Whether or not the driver may still be compiling our shaders, until PollCompile has checked the results.
+	std::string pendingSources;                          //!< The sources of the program that we're compiling async, used to cache it once it's done. Empty if we're sharing another shader's compile.
 	std::vector< std::string > transformFeedbackVaryings;//!< The varyings that will be captured using a transform feedback. Ordered in the order of capturing.
+	std::vector< CachedUniform > uniforms;               //!< The active uniforms of the linked program sorted by name hash, so that finding a uniform doesn't need a round trip to the driver.
+	FFGLLogSite errorLogSite;                            //!< Limits how often this shader logs compile and link errors, so that retrying a broken shader every frame doesn't flood the log.
 };
 
 }//End namespace ffglex
\ No newline at end of file
@@ -0,0 +1,275 @@
+#include "FFGLStateCache.h"
+#include <atomic>
+
+namespace ffglex
+{
+static thread_local FFGLStateCache* activeCache = nullptr;
+static std::atomic< uint64_t > numElidedCalls( 0 );
+static std::atomic< uint64_t > numIssuedCalls( 0 );
+
+const GLuint FFGLStateCache::UNKNOWN;
+
+/**
+ * Activates the cache for this thread. The context needs to be in FFGL's default state, which is how the host calls
+ * into ProcessOpenGL, so construct this before any scoped binding.
+ *
+ * @param hostFBO: The fbo the host has bound, available in ProcessOpenGLStruct::HostFBO.
+ */
+FFGLStateCache::FFGLStateCache( GLuint hostFBO ) :
+	previousCache( activeCache ),
+	program( 0 ),
+	vao( 0 ),
+	renderbuffer( 0 ),
+	drawFBO( hostFBO ),
+	readFBO( hostFBO ),
+	activeTexture( GL_TEXTURE0 ),
+	isDefaultState( true )
+{
+	activeCache = this;
+}
+/**
+ * Deactivates the cache, reactivating the cache that was active before this one was constructed.
+ */
+FFGLStateCache::~FFGLStateCache()
+{
+	activeCache = previousCache;
+}
+
+/**
+ * The cache the scoped bindings on this thread should use. nullptr if there is none, in which case the scoped bindings
+ * always bind and unbind to 0.
+ */
+FFGLStateCache* FFGLStateCache::GetActive()
+{
+	return activeCache;
+}
+
+/**
+ * Binds a program unless it's already bound.
+ *
+ * @return: The program that was bound before, which is what a scope should restore. 0 if we've lost track of it.
+ */
+GLuint FFGLStateCache::UseProgram( GLuint programID )
+{
+	GLuint previous = program;
+	if( Elide( previous, programID ) )
+		return previous;
+	glUseProgram( programID );
+	program = programID;
+	return previous == UNKNOWN ? 0 : previous;
+}
+/**
+ * Binds a vao unless it's already bound.
+ *
+ * @return: The vao that was bound before, which is what a scope should restore. 0 if we've lost track of it.
+ */
+GLuint FFGLStateCache::BindVertexArray( GLuint vaoID )
+{
+	GLuint previous = vao;
+	if( Elide( previous, vaoID ) )
+		return previous;
+	glBindVertexArray( vaoID );
+	vao = vaoID;
+	return previous == UNKNOWN ? 0 : previous;
+}
+/**
+ * Binds a renderbuffer unless it's already bound.
+ *
+ * @return: The renderbuffer that was bound before, which is what a scope should restore. 0 if we've lost track of it.
+ */
+GLuint FFGLStateCache::BindRenderbuffer( GLuint renderbufferID )
+{
+	GLuint previous = renderbuffer;
+	if( Elide( previous, renderbufferID ) )
+		return previous;
+	glBindRenderbuffer( GL_RENDERBUFFER, renderbufferID );
+	renderbuffer = renderbufferID;
+	return previous == UNKNOWN ? 0 : previous;
+}
+/**
+ * Activates a texture unit unless it's already active.
+ *
+ * @param textureUnit: The unit to activate, eg GL_TEXTURE0 + 1.
+ * @return: The unit that was active before, which is what a scope should restore. GL_TEXTURE0 if we've lost track of it.
+ */
+GLenum FFGLStateCache::ActiveTexture( GLenum textureUnit )
+{
+	GLenum previous = activeTexture;
+	if( Elide( previous, textureUnit ) )
+		return previous;
+	glActiveTexture( textureUnit );
+	activeTexture = textureUnit;
+	return previous == UNKNOWN ? GL_TEXTURE0 : previous;
+}
+/**
+ * Binds a texture to the active texture unit unless it's already bound.
+ *
+ * @return: The texture that was bound to the target of the active unit, which is what a scope should restore. 0 if we've lost track of it.
+ */
+GLuint FFGLStateCache::BindTexture( GLenum target, GLuint textureID )
+{
+	GLuint* binding = FindTexture( target );
+	GLuint previous = binding != nullptr ? *binding : UNKNOWN;
+	if( Elide( previous, textureID ) )
+		return previous;
+	glBindTexture( target, textureID );
+	if( binding != nullptr )
+		*binding = textureID;
+	return previous == UNKNOWN ? 0 : previous;
+}
+/**
+ * Binds a buffer unless it's already bound.
+ * The element array buffer binding is part of the vao's state, so we're not tracking that one and always bind it.
+ *
+ * @return: The buffer that was bound to the target, which is what a scope should restore. 0 if we've lost track of it.
+ */
+GLuint FFGLStateCache::BindBuffer( GLenum target, GLuint bufferID )
+{
+	GLuint* binding = target != GL_ELEMENT_ARRAY_BUFFER ? FindBuffer( target, 0, false ) : nullptr;
+	GLuint previous = binding != nullptr ? *binding : UNKNOWN;
+	if( Elide( previous, bufferID ) )
+		return previous;
+	glBindBuffer( target, bufferID );
+	if( binding != nullptr )
+		*binding = bufferID;
+	return previous == UNKNOWN ? 0 : previous;
+}
+/**
+ * Binds a buffer to an indexed binding point unless it's already bound there. Just like glBindBufferBase this
+ * also binds the buffer to the target's generic binding point.
+ *
+ * @return: The buffer that was bound to the binding point, which is what a scope should restore. 0 if we've lost track of it.
+ */
+GLuint FFGLStateCache::BindBufferBase( GLenum target, GLuint index, GLuint bufferID )
+{
+	//We can only skip the bind if the generic binding point already has the buffer as well.
+	GLuint previous = *FindBuffer( target, index, true );
+	GLuint current  = *FindBuffer( target, 0, false ) == previous ? previous : UNKNOWN;
+	if( Elide( current, bufferID ) )
+		return previous;
+	glBindBufferBase( target, index, bufferID );
+	*FindBuffer( target, index, true ) = bufferID;
+	*FindBuffer( target, 0, false )    = bufferID;
+	return previous == UNKNOWN ? 0 : previous;
+}
+/**
+ * Binds a framebuffer unless it's already bound.
+ *
+ * @param target: GL_FRAMEBUFFER to bind to both the draw and read targets, or GL_DRAW_FRAMEBUFFER or GL_READ_FRAMEBUFFER.
+ */
+void FFGLStateCache::BindFramebuffer( GLenum target, GLuint fboID )
+{
+	bool isDraw = target == GL_FRAMEBUFFER || target == GL_DRAW_FRAMEBUFFER;
+	bool isRead = target == GL_FRAMEBUFFER || target == GL_READ_FRAMEBUFFER;
+	GLuint current;
+	if( isDraw && isRead )
+		current = drawFBO == readFBO ? drawFBO : UNKNOWN;
+	else
+		current = isDraw ? drawFBO : readFBO;
+	if( Elide( current, fboID ) )
+		return;
+	glBindFramebuffer( target, fboID );
+	if( isDraw )
+		drawFBO = fboID;
+	if( isRead )
+		readFBO = fboID;
+}
+/**
+ * The framebuffer that's bound to the draw or read target. Querying the binding stalls the driver, so we only do that
+ * if we've lost track of it since the last Invalidate.
+ *
+ * @param target: GL_DRAW_FRAMEBUFFER or GL_READ_FRAMEBUFFER.
+ */
+GLuint FFGLStateCache::GetBoundFramebuffer( GLenum target )
+{
+	GLuint& binding = target == GL_READ_FRAMEBUFFER ? readFBO : drawFBO;
+	if( binding != UNKNOWN )
+	{
+		numElidedCalls++;
+		return binding;
+	}
+
+	GLint queriedBinding = 0;
+	glGetIntegerv( target == GL_READ_FRAMEBUFFER ? GL_READ_FRAMEBUFFER_BINDING : GL_DRAW_FRAMEBUFFER_BINDING, &queriedBinding );
+	numIssuedCalls++;
+	binding = (GLuint)queriedBinding;
+	return binding;
+}
+/**
+ * Forget all bindings. Call this after changing bindings with direct gl calls, after which the scoped bindings
+ * go back to always binding and unbinding to 0 until they've rebound what they're using.
+ */
+void FFGLStateCache::Invalidate()
+{
+	program        = UNKNOWN;
+	vao            = UNKNOWN;
+	renderbuffer   = UNKNOWN;
+	drawFBO        = UNKNOWN;
+	readFBO        = UNKNOWN;
+	activeTexture  = UNKNOWN;
+	isDefaultState = false;
+	textures.clear();
+	buffers.clear();
+}
+
+/**
+ * The number of gl calls that have been skipped because of the caches of all threads. Compare this to
+ * GetNumIssuedCalls to see how much the cache is saving.
+ */
+uint64_t FFGLStateCache::GetNumElidedCalls()
+{
+	return numElidedCalls.load();
+}
+/**
+ * The number of gl calls that the caches of all threads have passed on to the driver.
+ */
+uint64_t FFGLStateCache::GetNumIssuedCalls()
+{
+	return numIssuedCalls.load();
+}
+
+GLuint* FFGLStateCache::FindTexture( GLenum target )
+{
+	//Without knowing the active unit we can't tell which binding changes.
+	if( activeTexture == UNKNOWN )
+		return nullptr;
+
+	for( TextureBinding& binding : textures )
+	{
+		if( binding.textureUnit == activeTexture && binding.target == target )
+			return &binding.textureID;
+	}
+	TextureBinding binding;
+	binding.textureUnit = activeTexture;
+	binding.target      = target;
+	binding.textureID   = isDefaultState ? 0 : UNKNOWN;
+	textures.push_back( binding );
+	return &textures.back().textureID;
+}
+GLuint* FFGLStateCache::FindBuffer( GLenum target, GLuint index, bool isIndexed )
+{
+	for( BufferBinding& binding : buffers )
+	{
+		if( binding.target == target && binding.index == index && binding.isIndexed == isIndexed )
+			return &binding.bufferID;
+	}
+	BufferBinding binding;
+	binding.target    = target;
+	binding.index     = index;
+	binding.isIndexed = isIndexed;
+	binding.bufferID  = isDefaultState ? 0 : UNKNOWN;
+	buffers.push_back( binding );
+	return &buffers.back().bufferID;
+}
+bool FFGLStateCache::Elide( GLuint current, GLuint binding )
+{
+	if( current != UNKNOWN && current == binding )
+	{
+		numElidedCalls++;
+		return true;
+	}
+	numIssuedCalls++;
+	return false;
+}
+
+}//End namespace ffglex
\ No newline at end of file
@@ -0,0 +1,77 @@
+#pragma once
+#include "../ffgl/FFGL.h"//For OpenGL
+#include <vector>
+#include <stdint.h>
+
+namespace ffglex
+{
+/**
+ * The FFGLStateCache shadows the context's bindings so that the scoped bindings can skip binds that wouldn't change anything,
+ * and can restore the previous binding at the end of their scope without having to query it. Eg when your Render function
+ * binds the shader that's already bound by your ProcessOpenGL both the bind and the unbind are skipped.
+ *
+ * The cache relies on the FFGL convention that the host calls into the plugin with the context in it's default state, with the
+ * host's fbo bound. Construct one at the start of ProcessOpenGL, before any scoped binding, and it'll be used by all scoped bindings
+ * that are constructed on this thread while it's alive. Everything that's bound through the scoped bindings is restored when their
+ * scope ends, so the context is back in the default state when the cache goes out of scope.
+ *
+ * If you're changing bindings with direct gl calls while the cache is alive, call Invalidate afterwards. The cache then forgets
+ * what it knows and the scoped bindings go back to always binding, and unbinding to 0.
+ */
+class FFGLStateCache
+{
+public:
+	FFGLStateCache( GLuint hostFBO );//Activates the cache for this thread, assuming the context is in FFGL's default state with the host's fbo bound.
+	FFGLStateCache( const FFGLStateCache& ) = delete;
+	~FFGLStateCache();               //Deactivates the cache, reactivating the cache that was active before this one was constructed.
+
+	static FFGLStateCache* GetActive();//The cache the scoped bindings on this thread should use. nullptr if there is none.
+
+	GLuint UseProgram( GLuint programID );                                //Binds a program unless it's already bound. Returns the program that was bound.
+	GLuint BindVertexArray( GLuint vaoID );                               //Binds a vao unless it's already bound. Returns the vao that was bound.
+	GLuint BindRenderbuffer( GLuint renderbufferID );                     //Binds a renderbuffer unless it's already bound. Returns the renderbuffer that was bound.
+	GLenum ActiveTexture( GLenum textureUnit );                           //Activates a texture unit unless it's already active. Returns the unit that was active.
+	GLuint BindTexture( GLenum target, GLuint textureID );                //Binds a texture to the active unit unless it's already bound. Returns the texture that was bound.
+	GLuint BindBuffer( GLenum target, GLuint bufferID );                  //Binds a buffer unless it's already bound. Returns the buffer that was bound.
+	GLuint BindBufferBase( GLenum target, GLuint index, GLuint bufferID );//Binds a buffer to an indexed binding point unless it's already bound there. Returns the buffer that was bound there.
+	void BindFramebuffer( GLenum target, GLuint fboID );                  //Binds a framebuffer to the draw and/or read target unless it's already bound.
+	GLuint GetBoundFramebuffer( GLenum target );                          //The framebuffer that's bound to the draw or read target, only queries it if we've lost track of it.
+	void Invalidate();                                                    //Forget all bindings, call this after changing bindings with direct gl calls.
+
+	static uint64_t GetNumElidedCalls();//The number of gl calls that have been skipped because of the caches of all threads.
+	static uint64_t GetNumIssuedCalls();//The number of gl calls that the caches of all threads have passed on to the driver.
+
+private:
+	static const GLuint UNKNOWN = 0xFFFFFFFF;//!< What we store for bindings that we've lost track of since the last Invalidate.
+
+	struct TextureBinding
+	{
+		GLenum textureUnit;
+		GLenum target;
+		GLuint textureID;
+	};
+	struct BufferBinding
+	{
+		GLenum target;
+		GLuint index;  //!< The binding point within the target for indexed bindings.
+		bool isIndexed;//!< Whether or not this is the indexed binding point, or the target's generic binding point.
+		GLuint bufferID;
+	};
+
+	GLuint* FindTexture( GLenum target );                             //Internal utility that finds the binding of a target in the active unit, adding it if needed.
+	GLuint* FindBuffer( GLenum target, GLuint index, bool isIndexed );//Internal utility that finds the binding of a buffer binding point, adding it if needed.
+	bool Elide( GLuint current, GLuint binding );                     //Internal utility that counts the call and returns whether or not it can be skipped.
+
+	FFGLStateCache* previousCache;        //!< The cache that was active on this thread when we were constructed.
+	GLuint program;                       //!< The program that's in use.
+	GLuint vao;                           //!< The bound vertex array.
+	GLuint renderbuffer;                  //!< The bound renderbuffer.
+	GLuint drawFBO;                       //!< The framebuffer that's bound to GL_DRAW_FRAMEBUFFER.
+	GLuint readFBO;                       //!< The framebuffer that's bound to GL_READ_FRAMEBUFFER.
+	GLenum activeTexture;                 //!< The active texture unit, eg GL_TEXTURE0.
+	bool isDefaultState;                  //!< Whether or not textures and buffers that aren't listed below are still unbound, false after Invalidate.
+	std::vector< TextureBinding > textures;//!< The texture bindings we've seen since construction, all others are unbound.
+	std::vector< BufferBinding > buffers;  //!< The buffer bindings we've seen since construction, all others are unbound.
+};
+
+}//End namespace ffglex
\ No newline at end of file
@@ -0,0 +1,212 @@
+#include "FFGLStreamingTexture.h"
+#include <assert.h>
+#include <string.h>
+#include "FFGLScopedBufferBinding.h"
+#include "FFGLScopedTextureBinding.h"
+#include "FFGLUtilities.h"
+#include "../ffgl/FFGLInstanceStats.h"
+
+namespace ffglex
+{
+static const GLuint64 WAIT_TIMEOUT = 1000000000;//!< How long we wait for the gpu to finish reading a buffer before giving up, in nanoseconds.
+
+FFGLStreamingTexture::FFGLStreamingTexture() :
+	width( 0 ),
+	height( 0 ),
+	format( 0 ),
+	type( 0 ),
+	frameSize( 0 ),
+	unpackAlignment( 4 ),
+	textureID( 0 ),
+	nextBuffer( 0 ),
+	numStalls( 0 )
+{
+}
+FFGLStreamingTexture::~FFGLStreamingTexture()
+{
+	//If this assertion hits you forgot to release this texture.
+	assert( textureID == 0 );
+}
+
+/**
+ * Allocate the texture's storage and the pixel unpack buffers. This function needs to be called using an active OpenGL context,
+ * for example in your plugin's InitGL function.
+ *
+ * @param width: The width of the texture in number of pixels.
+ * @param height: The height of the texture in number of pixels.
+ * @param internalFormat: The format of the texture, eg GL_RG8.
+ * @param format: The format of the pixels you're uploading, eg GL_RG.
+ * @param type: The type of the pixels you're uploading, eg GL_UNSIGNED_BYTE.
+ * @param numBuffers: The number of frames that can be in flight, before an upload has to wait for the gpu.
+ * @return: Whether or not initialising succeeded.
+ */
+bool FFGLStreamingTexture::Initialise( GLsizei width, GLsizei height, GLint internalFormat, GLenum format, GLenum type, unsigned int numBuffers )
+{
+	//Cannot initialize if we're already initialized, please Release us first.
+	if( textureID != 0 )
+		return false;
+
+	GLsizei bytesPerPixel = GetBytesPerPixel( format, type );
+	if( bytesPerPixel == 0 || width <= 0 || height <= 0 || numBuffers == 0 )
+		return false;
+
+	this->width     = width;
+	this->height    = height;
+	this->format    = format;
+	this->type      = type;
+	frameSize       = (GLsizeiptr)bytesPerPixel * width * height;
+	unpackAlignment = ( bytesPerPixel * width ) % 4 == 0 ? 4 : 1;
+	nextBuffer      = 0;
+
+	glGenTextures( 1, &textureID );
+	if( textureID == 0 )
+		return false;
+	FFGLInstanceStats::AddGLObjects( 1 );
+
+	{
+		Scoped2DTextureBinding textureBinding( textureID );
+		//Immutable storage lets the driver skip validating the texture's completeness on every update. It's not available on OpenGL 4.1,
+		//in which case we allocate the storage once with glTexImage2D.
+#if !defined( FFGL_MACOS )
+		if( GLEW_ARB_texture_storage == GL_TRUE )
+			glTexStorage2D( GL_TEXTURE_2D, 1, internalFormat, width, height );
+		else
+#endif
+			glTexImage2D( GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, type, NULL );
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0 );
+
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
+
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+	}
+
+	for( unsigned int index = 0; index < numBuffers; ++index )
+	{
+		PixelBuffer buffer;
+		buffer.fence = nullptr;
+		glGenBuffers( 1, &buffer.bufferID );
+		if( buffer.bufferID == 0 )
+		{
+			Release();
+			return false;
+		}
+		buffers.push_back( buffer );
+		FFGLInstanceStats::AddGLObjects( 1 );
+
+		ScopedBufferBinding bufferBinding( GL_PIXEL_UNPACK_BUFFER, buffer.bufferID );
+		glBufferData( GL_PIXEL_UNPACK_BUFFER, frameSize, NULL, GL_STREAM_DRAW );
+	}
+
+	return true;
+}
+/**
+ * Release all gl resources. Call this before destruction if you've previously initialised us, usually from your plugin's DeInitGL.
+ */
+void FFGLStreamingTexture::Release()
+{
+	for( PixelBuffer& buffer : buffers )
+	{
+		if( buffer.fence != nullptr )
+			glDeleteSync( buffer.fence );
+		glDeleteBuffers( 1, &buffer.bufferID );
+	}
+	FFGLInstanceStats::AddGLObjects( -(int)buffers.size() );
+	buffers.clear();
+
+	if( textureID != 0 )
+	{
+		glDeleteTextures( 1, &textureID );
+		FFGLInstanceStats::AddGLObjects( -1 );
+		textureID = 0;
+	}
+
+	width  = 0;
+	height = 0;
+}
+
+/**
+ * Copy a full frame of pixels into the next buffer, and update the texture from it. The update is queued on the gpu, so this
+ * returns without waiting for it. Only when all buffers are still being read this has to wait for the oldest one.
+ *
+ * @param pixels: width * height pixels of the format and type we've been initialised with, rows are tightly packed.
+ * @return: Whether or not the texture has been updated.
+ */
+bool FFGLStreamingTexture::Upload( const void* pixels )
+{
+	if( textureID == 0 || pixels == nullptr )
+		return false;
+
+	PixelBuffer& buffer = buffers[ nextBuffer ];
+	nextBuffer          = ( nextBuffer + 1 ) % buffers.size();
+
+	//Once the gpu is done with the buffer nobody else is using it, so we can tell the driver to not synchronize the mapping.
+	//If we couldn't wait for the fence we let the driver synchronize it instead.
+	GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT;
+	if( WaitForBuffer( buffer ) )
+		access |= GL_MAP_UNSYNCHRONIZED_BIT;
+
+	ScopedBufferBinding bufferBinding( GL_PIXEL_UNPACK_BUFFER, buffer.bufferID );
+	void* mappedPixels = glMapBufferRange( GL_PIXEL_UNPACK_BUFFER, 0, frameSize, access );
+	if( mappedPixels == nullptr )
+		return false;
+	memcpy( mappedPixels, pixels, (size_t)frameSize );
+	if( glUnmapBuffer( GL_PIXEL_UNPACK_BUFFER ) != GL_TRUE )
+		return false;
+	FFGLInstanceStats::AddUploadedBytes( (uint64_t)frameSize );
+
+	//With a pixel unpack buffer bound the pixels argument is an offset into the buffer.
+	Scoped2DTextureBinding textureBinding( textureID );
+	if( unpackAlignment != 4 )
+		glPixelStorei( GL_UNPACK_ALIGNMENT, unpackAlignment );
+	glTexSubImage2D( GL_TEXTURE_2D, 0, 0, 0, width, height, format, type, NULL );
+	if( unpackAlignment != 4 )
+		glPixelStorei( GL_UNPACK_ALIGNMENT, 4 );//Set it back to the context's default state as required by ffgl.
+
+	buffer.fence = glFenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE, 0 );
+	return true;
+}
+
+GLuint FFGLStreamingTexture::GetGLID() const
+{
+	return textureID;
+}
+FFGLTextureStruct FFGLStreamingTexture::GetTextureInfo() const
+{
+	FFGLTextureStruct t;
+
+	t.Width = t.HardwareWidth = width;
+	t.Height = t.HardwareHeight = height;
+
+	t.Handle = textureID;
+
+	return t;
+}
+/**
+ * The number of uploads that had to wait for the gpu to finish reading a buffer. Every stall blocks the cpu,
+ * so if this keeps growing you need to initialise the texture with more buffers.
+ */
+uint64_t FFGLStreamingTexture::GetNumStalls() const
+{
+	return numStalls;
+}
+
+bool FFGLStreamingTexture::WaitForBuffer( PixelBuffer& buffer )
+{
+	if( buffer.fence == nullptr )
+		return true;
+
+	//Polling without a timeout doesn't block, only when that tells us the gpu is still reading we're stalling.
+	GLenum result = glClientWaitSync( buffer.fence, 0, 0 );
+	if( result == GL_TIMEOUT_EXPIRED )
+	{
+		numStalls++;
+		result = glClientWaitSync( buffer.fence, GL_SYNC_FLUSH_COMMANDS_BIT, WAIT_TIMEOUT );
+	}
+	glDeleteSync( buffer.fence );
+	buffer.fence = nullptr;
+	return result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED;
+}
+
+}//End namespace ffglex
\ No newline at end of file
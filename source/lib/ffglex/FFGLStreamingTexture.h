@@ -0,0 +1,53 @@
+#pragma once
+#include "../ffgl/FFGL.h"//For OpenGL
+#include <stdint.h>
+#include <vector>
+
+namespace ffglex
+{
+/**
+ * The FFGLStreamingTexture is a texture that you can upload new cpu generated pixels into every frame without stalling the
+ * driver. The texture's storage is allocated once. Uploads go through a ring of pixel unpack buffers: the pixels are copied
+ * into the next buffer and the texture is updated from that buffer, which the gpu does asynchronously. Every buffer is guarded
+ * by a fence, so we only write into a buffer once the gpu is done reading from it.
+ *
+ * The texture is created with linear filtering and clamped edges, bind it with a Scoped2DTextureBinding to change those.
+ */
+class FFGLStreamingTexture
+{
+public:
+	FFGLStreamingTexture();
+	FFGLStreamingTexture( const FFGLStreamingTexture& ) = delete;
+	~FFGLStreamingTexture();
+
+	bool Initialise( GLsizei width, GLsizei height, GLint internalFormat, GLenum format, GLenum type, unsigned int numBuffers = 3 );//Allocate the texture's storage and the pixel unpack buffers.
+	void Release();                                                                                                              //Release all gl resources. Call this before destruction if you've previously initialised us.
+
+	bool Upload( const void* pixels );//Copy a full frame of pixels into the next buffer, and update the texture from it.
+
+	GLuint GetGLID() const;                  //The texture's id, bind this to sample the most recently uploaded pixels.
+	FFGLTextureStruct GetTextureInfo() const;//Information about the texture, eg to render it with a quickstart plugin.
+	uint64_t GetNumStalls() const;           //The number of uploads that had to wait for the gpu to finish reading a buffer. If this keeps growing you need more buffers.
+
+private:
+	struct PixelBuffer
+	{
+		GLuint bufferID;
+		GLsync fence;//!< Signaled once the gpu has finished reading from the buffer. nullptr if it isn't being read.
+	};
+
+	bool WaitForBuffer( PixelBuffer& buffer );//Internal utility that waits until the gpu is done reading the buffer, returns false if waiting failed.
+
+	GLsizei width;
+	GLsizei height;
+	GLenum format;
+	GLenum type;
+	GLsizeiptr frameSize;              //!< The number of bytes of a full frame.
+	GLint unpackAlignment;             //!< The row alignment of the pixels we're given.
+	GLuint textureID;                  //!< 0 if we're not initialised.
+	std::vector< PixelBuffer > buffers;//!< The ring of pixel unpack buffers.
+	size_t nextBuffer;                 //!< The buffer the next upload goes through.
+	uint64_t numStalls;
+};
+
+}//End namespace ffglex
\ No newline at end of file
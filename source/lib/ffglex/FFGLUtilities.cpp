@@ -4,11 +4,14 @@
 #include <Windows.h>
 #elif defined( FFGL_MACOS )
 #include <Carbon/Carbon.h>
+#include <OpenGL/OpenGL.h>
+#elif defined( FFGL_LINUX )
+#include <GL/glx.h>
+#include <dlfcn.h>
 #endif
 
 #include <math.h>
 #include <random>
-#include <iostream>
 #include <algorithm>
 
 namespace ffglex
@@ -164,14 +167,84 @@ void ReplaceAll( std::string& utf8String, const std::string& valueToReplace, con
 	for( std::string::size_type offset = utf8String.find( valueToReplace ); offset != std::string::npos; offset = utf8String.find( valueToReplace, offset ) )
 		utf8String.replace( offset, valueToReplace.length(), replaceWith );
 }
-void Log( const std::string& message )
+/**
+ * Identifies the OpenGL context that's current on this thread, used to key objects that can only be used on the context
+ * they were created on. Returns nullptr if we can't identify the context, users should not share objects under that key
+ * as it may stand for any number of different contexts.
+ */
+void* GetCurrentGLContext()
 {
 #if defined( FFGL_WINDOWS )
-	OutputDebugStringA( message.c_str() );
-	OutputDebugStringA( "\n" );
-	std::cout << message << std::endl;
+	return wglGetCurrentContext();
+#elif defined( FFGL_MACOS )
+	return CGLGetCurrentContext();
 #else
-	printf( "%s", ( message + "\n" ).c_str() );
+	void* context = glXGetCurrentContext();
+	if( context != nullptr )
+		return context;
+
+	//Hosts on Linux may be using EGL instead of GLX. We look up eglGetCurrentContext in the libraries the host has already
+	//loaded rather than linking libEGL ourselves, a host that uses EGL has it loaded and other hosts don't need it.
+	typedef void* ( *GetCurrentContextFunction )();
+	static GetCurrentContextFunction eglGetCurrentContext = (GetCurrentContextFunction)dlsym( RTLD_DEFAULT, "eglGetCurrentContext" );
+	return eglGetCurrentContext != nullptr ? eglGetCurrentContext() : nullptr;
 #endif
 }
+/**
+ * The number of bytes a pixel takes in cpu memory when it's transferred with this format and type pair, 0 if we dont know the pair.
+ */
+GLsizei GetBytesPerPixel( GLenum format, GLenum type )
+{
+	switch( type )
+	{
+	case GL_UNSIGNED_INT_2_10_10_10_REV:
+	case GL_UNSIGNED_INT_10F_11F_11F_REV:
+	case GL_UNSIGNED_INT_8_8_8_8_REV:
+		return 4;
+	default:
+		break;
+	}
+
+	GLsizei numComponents;
+	switch( format )
+	{
+	case GL_RED:
+		numComponents = 1;
+		break;
+	case GL_RG:
+		numComponents = 2;
+		break;
+	case GL_RGB:
+	case GL_BGR:
+		numComponents = 3;
+		break;
+	case GL_RGBA:
+	case GL_BGRA:
+		numComponents = 4;
+		break;
+	default:
+		return 0;
+	}
+
+	switch( type )
+	{
+	case GL_UNSIGNED_BYTE:
+	case GL_BYTE:
+		return numComponents;
+	case GL_UNSIGNED_SHORT:
+	case GL_SHORT:
+	case GL_HALF_FLOAT:
+		return numComponents * 2;
+	case GL_UNSIGNED_INT:
+	case GL_INT:
+	case GL_FLOAT:
+		return numComponents * 4;
+	default:
+		return 0;
+	}
+}
+void Log( const std::string& message )
+{
+	FFGLLog::LogToHost( FFGLLog::LL_INFO, message );
+}
 }//End namespace ffglex
@@ -2,6 +2,7 @@
 #include <string>
 #include <sstream>
 #include "../ffgl/FFGL.h"//For OpenGL
+#include "../ffgl/FFGLLog.h"
 
 namespace ffglex
 {
@@ -173,6 +174,9 @@ float map( float value, float low, float high, float newLow, float newHigh );
 
 void ReplaceAll( std::string& utf8String, const std::string& valueToReplace, const std::string& replaceWith );
 
+void* GetCurrentGLContext();
+GLsizei GetBytesPerPixel( GLenum format, GLenum type );
+
 template< typename T >
 void VariadicMessageBuilder( std::ostream& o, T t )
 {
@@ -187,14 +191,30 @@ void VariadicMessageBuilder( std::ostream& o, T t, const Args&... args )
 void Log( const std::string& message );
 /**
  * This function logs anything that's streamable to a stringstream, just provide it as many arguments as you want
- * and it'll concatenate all of them into a string and show it in your debugger.
+ * and it'll concatenate all of them into a string and pass it on to the host's log, see FFGLLog.
  */
 template< typename... Args >
 void Log( const Args&... args )
 {
+	if( !FFGLLog::IsLevelEnabled( FFGLLog::LL_INFO ) )
+		return;
 	std::ostringstream oss;
 	VariadicMessageBuilder( oss, args... );
 	Log( oss.str() );
 }
+/**
+ * Same as above, but with a level and limited to the rate of logSite. The message is only built if it's going to be logged,
+ * so this is the one to use in code that may run every frame.
+ */
+template< typename... Args >
+void Log( FFGLLogSite& logSite, FFGLLog::Level level, const Args&... args )
+{
+	uint32_t numSuppressed = 0;
+	if( !FFGLLog::IsLevelEnabled( level ) || !logSite.ShouldLog( numSuppressed ) )
+		return;
+	std::ostringstream oss;
+	VariadicMessageBuilder( oss, args... );
+	FFGLLog::LogToHost( level, oss.str(), numSuppressed );
+}
 
 }//End namespace ffglex
\ No newline at end of file
@@ -18,15 +18,14 @@ Effect::Effect( bool supportTopLeftTextureOrientation ) :
 		#version 410 core
 		uniform vec2 maxUV;
 
-		layout( location = 0 ) in vec4 vPosition;
-		layout( location = 1 ) in vec2 vUV;
-
 		out vec2 i_uv;
 
 		void main()
 		{
-			gl_Position = vPosition;
-			i_uv = vUV * maxUV;
+			//Generates a triangle that covers the whole viewport, see FFGLFullScreenPass.
+			vec2 position = vec2( ( gl_VertexID & 1 ) * 4 - 1, ( gl_VertexID & 2 ) * 2 - 1 );
+			gl_Position = vec4( position, 0.0, 1.0 );
+			i_uv = ( position * 0.5 + 0.5 ) * maxUV;
 		}
 	)";
 }
@@ -51,7 +50,7 @@ FFResult Effect::Render( ProcessOpenGLStruct* inputTextures )
 	shader.Set( "inputTexture", 0 );
 	FFGLTexCoords maxCoords = GetMaxGLTexCoords( *inputTextures->inputTextures[ 0 ] );
 	shader.Set( "maxUV", maxCoords.s, maxCoords.t );
-	quad.Draw();
+	DrawFullScreen();
 	return FF_SUCCESS;
 }
 
@@ -22,17 +22,16 @@ Mixer::Mixer( bool supportTopLeftTextureOrientation ) :
 		uniform vec2 maxUVDest;
 		uniform vec2 maxUVSrc;
 
-		layout( location = 0 ) in vec4 vPosition;
-		layout( location = 1 ) in vec2 vUV;
-
 		out vec2 i_uv_dest;
 		out vec2 i_uv_src;
 
 		void main()
 		{
-			gl_Position = vPosition;
-			i_uv_dest = vUV * maxUVDest;
-			i_uv_src = vUV * maxUVSrc;
+			//Generates a triangle that covers the whole viewport, see FFGLFullScreenPass.
+			vec2 position = vec2( ( gl_VertexID & 1 ) * 4 - 1, ( gl_VertexID & 2 ) * 2 - 1 );
+			gl_Position = vec4( position, 0.0, 1.0 );
+			i_uv_dest = ( position * 0.5 + 0.5 ) * maxUVDest;
+			i_uv_src = ( position * 0.5 + 0.5 ) * maxUVSrc;
 		}
 	)";
 	AddParam( Param::Create( "mixVal" ) );
@@ -65,7 +64,7 @@ FFResult Mixer::Render( ProcessOpenGLStruct* inputTextures )
 	shader.Set( "textureSrc", 1 );
 	maxCoords = GetMaxGLTexCoords( *inputTextures->inputTextures[ 1 ] );
 	shader.Set( "maxUVSrc", maxCoords.s, maxCoords.t );
-	quad.Draw();
+	DrawFullScreen();
 	return FF_SUCCESS;
 }
 
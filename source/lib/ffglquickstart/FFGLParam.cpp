@@ -41,6 +41,7 @@ Param::Param( std::string name, FFUInt32 type, float value ) :
 void Param::SetValue( float v )
 {
 	value = v;
+	++version;
 }
 
 float Param::GetValue() const
@@ -55,5 +56,9 @@ FFUInt32 Param::GetType() const
 {
 	return type;
 }
+unsigned int Param::GetVersion() const
+{
+	return version;
+}
 
 }//End namespace ffglqs
\ No newline at end of file
@@ -23,11 +23,15 @@ public:
 	virtual float GetValue() const;
 	const std::string& GetName() const;
 	FFUInt32 GetType() const;
+	/// Returns a counter that changes every time the value changes, the plugin compares it with the version
+	/// it last sent to the shader so that it only sends the params that changed.
+	unsigned int GetVersion() const;
 
 protected:
 	float value = 0;
 	std::string name;
 	FFUInt32 type;
+	unsigned int version = 0;//!< Subclasses that change the value without calling SetValue have to increment this as well.
 };
 
 }//End namespace ffglqs
\ No newline at end of file
@@ -32,6 +32,7 @@ void ParamOption::SetValue( float newValue )
 		value = newValue;
 
 	currentOption = options[ valueAsIndex ];
+	++version;
 }
 
 float ParamOption::GetRealValue() const
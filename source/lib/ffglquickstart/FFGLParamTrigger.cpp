@@ -15,6 +15,7 @@ ParamTrigger::ParamTrigger( std::string name ) :
 void ParamTrigger::Consume()
 {
 	value = false;
+	++version;
 }
 
 }//End namespace ffglqs
\ No newline at end of file
@@ -1,15 +1,27 @@
 #include "FFGLPlugin.h"
+#include <algorithm>
 #include "FFGLParamRange.h"
 #include "FFGLParamOption.h"
 #include "FFGLParamFFT.h"
 #include "FFGLParamText.h"
 #include "FFGLParamTrigger.h"
+#include "../ffglex/FFGLScopedBufferBinding.h"
+#include "../ffglex/FFGLRenderTargetPool.h"
 using namespace ffglex;
 
 namespace ffglqs
 {
+/**
+ * Rounds the offset up to the next multiple of the alignment, which has to be a power of two.
+ */
+static unsigned int AlignOffset( unsigned int offset, unsigned int alignment )
+{
+	return ( offset + alignment - 1 ) & ~( alignment - 1 );
+}
+
 Plugin::Plugin( bool supportTopLeftTextureOrientation ) :
-	CFFGLPlugin( supportTopLeftTextureOrientation )
+	CFFGLPlugin( supportTopLeftTextureOrientation ),
+	gpuTimer( "ProcessOpenGL" )
 {
 }
 
@@ -19,17 +31,35 @@ Plugin::~Plugin()
 
 FFResult Plugin::InitGL( const FFGLViewportStruct* viewPort )
 {
+	//The pool deletes this context's targets once the last instance on it is gone, see DeInitGL.
+	FFGLRenderTargetPool::RetainContext();
+	hasRetainedContext = true;
 	std::string fragmentShaderCode = CreateFragmentShader( fragmentShaderBase );
+	shader.SetAsyncCompile( useAsyncCompile );
 	if( !shader.Compile( vertexShaderCode, fragmentShaderCode ) )
 	{
 		DeInitGL();
 		return FF_FAIL;
 	}
+	//When the shader is compiling async we can only build the upload plan once it's linked, ProcessOpenGL takes care of that.
+	if( !shader.IsCompiling() )
+	{
+		BuildUploadPlan();
+		SelectVertexInput();
+	}
+	if( !fullScreenPass.Initialise() )
+	{
+		DeInitGL();
+		return FF_FAIL;
+	}
+	//Subclasses that override Render may still draw the quad themselves, so it's initialised regardless of our shader.
 	if( !quad.Initialise() )
 	{
 		DeInitGL();
 		return FF_FAIL;
 	}
+	//Measuring the gpu time is optional, if the driver doesn't support timestamps we just render without it.
+	gpuTimer.Initialise();
 	if( Init() == FF_FAIL )
 	{
 		DeInitGL();
@@ -40,14 +70,52 @@ FFResult Plugin::InitGL( const FFGLViewportStruct* viewPort )
 }
 
 FFResult Plugin::ProcessOpenGL( ProcessOpenGLStruct* inputTextures )
+{
+	if( shader.IsCompiling() )
+	{
+		//Don't wait for the driver to finish compiling, just keep the output sensible until the shader is ready.
+		if( !shader.PollCompile() )
+			return shader.IsCompiling() ? RenderWhileCompiling( inputTextures ) : FF_FAIL;
+		BuildUploadPlan();
+		SelectVertexInput();
+	}
+	//A shader that failed to compile has freed it's program, drawing without one would fail on every frame after that.
+	if( !shader.IsReady() )
+		return FF_FAIL;
+
+	ScopedGpuZone gpuZone( gpuTimer );
+	//The state cache assumes the context is in the default state, so it has to be active before any of our scoped bindings.
+	if( useStateCache )
+	{
+		FFGLStateCache stateCache( inputTextures->HostFBO );
+		return RenderFrame( inputTextures );
+	}
+	return RenderFrame( inputTextures );
+}
+
+FFResult Plugin::RenderFrame( ProcessOpenGLStruct* inputTextures )
 {
 	UpdateAudioAndTime();
 	//Activate our shader using the scoped binding so that we'll restore the context state when we're done.
 	ScopedShaderBinding shaderBinding( shader.GetGLID() );
 	SendDefaultParams( shader );
 	SendParams( shader );
-	Update();
-	FFResult result = Render( inputTextures );
+	FFResult result;
+	if( uniformBlockBuffer != 0 )
+	{
+		//The params have been written to the cpu side copy of the Params block, upload all of them at once and keep the
+		//block bound while rendering. The scoped binding restores the context state when we're done.
+		ScopedUBOBinding paramsBinding( uniformBlockBuffer, PARAMS_BLOCK_BINDING );
+		glBufferSubData( GL_UNIFORM_BUFFER, 0, (GLsizeiptr)uniformBlockData.size(), uniformBlockData.data() );
+		FFGLInstanceStats::AddUploadedBytes( uniformBlockData.size() );
+		Update();
+		result = Render( inputTextures );
+	}
+	else
+	{
+		Update();
+		result = Render( inputTextures );
+	}
 	consumeAllTrigger();
 
 	return result;
@@ -55,9 +123,32 @@ FFResult Plugin::ProcessOpenGL( ProcessOpenGLStruct* inputTextures )
 
 FFResult Plugin::DeInitGL()
 {
+	paramUploads.clear();
+	hasUploadPlan = false;
+	if( uniformBlockBuffer != 0 )
+	{
+		glDeleteBuffers( 1, &uniformBlockBuffer );
+		FFGLInstanceStats::AddGLObjects( -1 );
+		uniformBlockBuffer = 0;
+	}
+	uniformBlockData.clear();
+	if( passthroughFBO != 0 )
+	{
+		glDeleteFramebuffers( 1, &passthroughFBO );
+		FFGLInstanceStats::AddGLObjects( -1 );
+		passthroughFBO = 0;
+	}
 	shader.FreeGLResources();
+	fullScreenPass.Release();
 	quad.Release();
+	useScreenQuad = false;
+	gpuTimer.Release();
 	Clean();
+	if( hasRetainedContext )
+	{
+		FFGLRenderTargetPool::ReleaseContext();
+		hasRetainedContext = false;
+	}
 	return FF_SUCCESS;
 }
 
@@ -65,37 +156,59 @@ FFResult Plugin::Render( ProcessOpenGLStruct* inputTextures )
 {
 	//Activate our shader using the scoped binding so that we'll restore the context state when we're done.
 	ScopedShaderBinding shaderBinding( shader.GetGLID() );
-	quad.Draw();
+	DrawFullScreen();
 	return FF_SUCCESS;
 }
 
 std::string Plugin::CreateFragmentShader( std::string base )
 {
-	std::string fragmentShaderCode = fragmentShaderCodeStart;
-	int i                          = 0;
+	//The default uniforms need to stay in this order, the Params block's layout is mirrored by DefaultUniformsBlock.
+	std::vector< std::string > declarations = {
+		"vec2 resolution",
+		"float time",
+		"float deltaTime",
+		"int frame",
+		"float bpm",
+		"float phase"
+	};
+	int i = 0;
 	while( i < params.size() )
 	{
 		if( IsRGBColor( i ) )
 		{
-			fragmentShaderCode += "uniform vec3 " + params[ i ]->GetName() + ";\n";
+			declarations.push_back( "vec3 " + params[ i ]->GetName() );
 			i += 2;
 		}
 		else if( IsHueColor( i ) )
 		{
-			fragmentShaderCode += "uniform vec4 " + params[ i ]->GetName() + ";\n";
+			declarations.push_back( "vec4 " + params[ i ]->GetName() );
 			i += 3;
 		}
 		else if( params[ i ]->GetType() == FF_TYPE_BOOLEAN || params[ i ]->GetType() == FF_TYPE_EVENT )
 		{
-			fragmentShaderCode += "uniform bool " + params[ i ]->GetName() + ";\n";
+			declarations.push_back( "bool " + params[ i ]->GetName() );
 		}
 		else if( params[ i ]->GetType() != FF_TYPE_BUFFER )
 		{
-			fragmentShaderCode += "uniform float " + params[ i ]->GetName() + ";\n";
+			declarations.push_back( "float " + params[ i ]->GetName() );
 		}
 		i += 1;
 	}
 
+	std::string fragmentShaderCode = fragmentShaderCodeStart;
+	if( useUniformBlock )
+	{
+		fragmentShaderCode += "layout( std140 ) uniform Params\n{\n";
+		for( const std::string& declaration : declarations )
+			fragmentShaderCode += "\t" + declaration + ";\n";
+		fragmentShaderCode += "};\n";
+	}
+	else
+	{
+		for( const std::string& declaration : declarations )
+			fragmentShaderCode += "uniform " + declaration + ";\n";
+	}
+
 	for( auto snippet : includedSnippets )
 	{
 		fragmentShaderCode += shader::snippets.find( snippet )->second;
@@ -118,61 +231,154 @@ void Plugin::UpdateAudioAndTime()
 	for( auto entry : audioParams )
 	{
 		std::shared_ptr< ParamFFT > param = entry.first;
-		ParamInfo* fftInfo                = FindParamInfo( param->index );
-		for( size_t index = 0; index < param->fftData.size(); ++index )
-			param->fftData[ index ] = fftInfo->elements[ index ].value;
+		const float* fftValues            = GetBufferParamValues( param->index );
+		std::copy( fftValues, fftValues + param->fftData.size(), param->fftData.begin() );
 		audioParams[ param ].Update( param->fftData );
 	}
 }
 
 void Plugin::SendParams( FFGLShader& shader )
 {
-	int i = 0;
-	while( i < params.size() )
+	//Any other shader than our own main shader doesn't have an upload plan, so it needs to get all the params.
+	//Uniforms keep their value in the program, so for our main shader we only have to send what has changed.
+	if( &shader != &this->shader || !hasUploadPlan )
 	{
-		if( IsRGBColor( i ) )
+		int i = 0;
+		while( i < params.size() )
 		{
-			std::string name = params[ i ]->GetName();
-			float r          = params[ i ]->GetValue();
-			float g          = params[ i + 1 ]->GetValue();
-			float b          = params[ i + 2 ]->GetValue();
-			shader.Set( name.c_str(), r, g, b );
-			i += 2;
+			if( IsRGBColor( i ) )
+			{
+				std::string name = params[ i ]->GetName();
+				float r          = params[ i ]->GetValue();
+				float g          = params[ i + 1 ]->GetValue();
+				float b          = params[ i + 2 ]->GetValue();
+				shader.Set( name.c_str(), r, g, b );
+				i += 3;
+			}
+			else if( IsHueColor( i ) )
+			{
+				float rgb[ 3 ];
+				std::string name = params[ i ]->GetName();
+				float hue        = params[ i ]->GetValue();
+				float saturation = params[ i + 1 ]->GetValue();
+				float brightness = params[ i + 2 ]->GetValue();
+				float alpha      = params[ i + 3 ]->GetValue();
+				//we need to make sure the hue doesn't reach 1.0f, otherwise the result will be pink and not red how it should be
+				hue = ( hue == 1.0f ) ? 0.0f : hue;
+				HSVtoRGB( hue, saturation, brightness, rgb[ 0 ], rgb[ 1 ], rgb[ 2 ] );
+				shader.Set( name.c_str(), rgb[ 0 ], rgb[ 1 ], rgb[ 2 ], alpha );
+				i += 4;
+			}
+			else
+			{
+				if( params[ i ]->GetType() == FF_TYPE_BOOLEAN || params[ i ]->GetType() == FF_TYPE_EVENT )
+					shader.Set( params[ i ]->GetName().c_str(), (bool)params[ i ]->GetValue() );
+				else if( params[ i ]->GetType() != FF_TYPE_BUFFER )
+					shader.Set( params[ i ]->GetName().c_str(), params[ i ]->GetValue() );
+				i += 1;
+			}
 		}
-		else if( IsHueColor( i ) )
+		return;
+	}
+
+	//The program is shared with the other instances of this plugin. If one of them has set the uniforms since we did, the program
+	//holds their values and we have to send all of ours again. The Params block doesn't have this problem as each instance has it's own buffer.
+	if( !useUniformBlock && !shader.ClaimUniforms() )
+		std::fill( dirtyParams.begin(), dirtyParams.end(), true );
+
+	for( const ParamUpload& upload : paramUploads )
+	{
+		bool isDirty = false;
+		for( unsigned int index = upload.firstParam; index < upload.firstParam + upload.numParams; ++index )
+			isDirty |= dirtyParams[ index ] || params[ index ]->GetVersion() != sentParamVersions[ index ];
+		if( !isDirty )
+			continue;
+
+		//In uniform block mode we're only writing the values into the block's cpu side copy, ProcessOpenGL uploads them all at once.
+		const unsigned int i = upload.firstParam;
+		switch( upload.kind )
 		{
-			float rgb[ 3 ];
-			std::string name = params[ i ]->GetName();
-			float hue        = params[ i ]->GetValue();
-			float saturation = params[ i + 1 ]->GetValue();
-			float brightness = params[ i + 2 ]->GetValue();
-			float alpha      = params[ i + 3 ]->GetValue();
-			//we need to make sure the hue doesn't reach 1.0f, otherwise the result will be pink and not red how it should be
-			hue = ( hue == 1.0f ) ? 0.0f : hue;
-			HSVtoRGB( hue, saturation, brightness, rgb[ 0 ], rgb[ 1 ], rgb[ 2 ] );
-			shader.Set( name.c_str(), rgb[ 0 ], rgb[ 1 ], rgb[ 2 ], alpha );
-			i += 3;
+		case ParamUpload::Kind::FLOAT:
+		{
+			float value = params[ i ]->GetValue();
+			if( useUniformBlock )
+				WriteUniformBlock( upload.blockOffset, &value, sizeof( value ) );
+			else
+				shader.Set( upload.uniform, value );
+			break;
 		}
-		if( params[ i ]->GetType() == FF_TYPE_BOOLEAN || params[ i ]->GetType() == FF_TYPE_EVENT )
+		case ParamUpload::Kind::BOOL:
 		{
-			shader.Set( params[ i ]->GetName().c_str(), (bool)params[ i ]->GetValue() );
+			GLint value = (bool)params[ i ]->GetValue();
+			if( useUniformBlock )
+				WriteUniformBlock( upload.blockOffset, &value, sizeof( value ) );
+			else
+				shader.Set( upload.uniform, value );
+			break;
 		}
-		else if( params[ i ]->GetType() != FF_TYPE_BUFFER )
+		case ParamUpload::Kind::RGB:
 		{
-			shader.Set( params[ i ]->GetName().c_str(), params[ i ]->GetValue() );
+			float rgb[ 3 ] = { params[ i ]->GetValue(), params[ i + 1 ]->GetValue(), params[ i + 2 ]->GetValue() };
+			if( useUniformBlock )
+				WriteUniformBlock( upload.blockOffset, rgb, sizeof( rgb ) );
+			else
+				shader.Set( upload.uniform, rgb[ 0 ], rgb[ 1 ], rgb[ 2 ] );
+			break;
+		}
+		case ParamUpload::Kind::HSBA:
+		{
+			float rgba[ 4 ];
+			float hue = params[ i ]->GetValue();
+			//we need to make sure the hue doesn't reach 1.0f, otherwise the result will be pink and not red how it should be
+			hue = ( hue == 1.0f ) ? 0.0f : hue;
+			HSVtoRGB( hue, params[ i + 1 ]->GetValue(), params[ i + 2 ]->GetValue(), rgba[ 0 ], rgba[ 1 ], rgba[ 2 ] );
+			rgba[ 3 ] = params[ i + 3 ]->GetValue();
+			if( useUniformBlock )
+				WriteUniformBlock( upload.blockOffset, rgba, sizeof( rgba ) );
+			else
+				shader.Set( upload.uniform, rgba[ 0 ], rgba[ 1 ], rgba[ 2 ], rgba[ 3 ] );
+			break;
+		}
 		}
-		i += 1;
 	}
+	std::fill( dirtyParams.begin(), dirtyParams.end(), false );
+	for( size_t index = 0; index < params.size(); ++index )
+		sentParamVersions[ index ] = params[ index ]->GetVersion();
 }
 
 void Plugin::SendDefaultParams( ffglex::FFGLShader& shader )
 {
-	shader.Set( "time", timeNow );
-	shader.Set( "deltaTime", deltaTime );
-	shader.Set( "frame", frame );
-	shader.Set( "resolution", (float)currentViewport.width, (float)currentViewport.height );
-	shader.Set( "bpm", bpm );
-	shader.Set( "phase", barPhase );
+	if( &shader != &this->shader || !hasUploadPlan )
+	{
+		shader.Set( "time", timeNow );
+		shader.Set( "deltaTime", deltaTime );
+		shader.Set( "frame", frame );
+		shader.Set( "resolution", (float)currentViewport.width, (float)currentViewport.height );
+		shader.Set( "bpm", bpm );
+		shader.Set( "phase", barPhase );
+		return;
+	}
+
+	if( useUniformBlock )
+	{
+		DefaultUniformsBlock defaults;
+		defaults.resolution[ 0 ] = (float)currentViewport.width;
+		defaults.resolution[ 1 ] = (float)currentViewport.height;
+		defaults.time            = timeNow;
+		defaults.deltaTime       = deltaTime;
+		defaults.frame           = frame;
+		defaults.bpm             = bpm;
+		defaults.phase           = barPhase;
+		WriteUniformBlock( 0, &defaults, sizeof( defaults ) );
+		return;
+	}
+
+	shader.Set( defaultUniforms.time, timeNow );
+	shader.Set( defaultUniforms.deltaTime, deltaTime );
+	shader.Set( defaultUniforms.frame, frame );
+	shader.Set( defaultUniforms.resolution, (float)currentViewport.width, (float)currentViewport.height );
+	shader.Set( defaultUniforms.bpm, bpm );
+	shader.Set( defaultUniforms.phase, barPhase );
 }
 
 char* Plugin::GetParameterDisplay( unsigned int index )
@@ -199,6 +405,7 @@ FFResult Plugin::SetFloatParameter( unsigned int index, float value )
 	if( index < params.size() )
 	{
 		params[ index ]->SetValue( value );
+		MarkParamDirty( index );
 		return FF_SUCCESS;
 	}
 	else
@@ -230,6 +437,7 @@ FFResult Plugin::SetTextParameter( unsigned int index, const char* value )
 		return FF_FAIL;
 
 	paramText->text = value == nullptr ? "" : value;
+	MarkParamDirty( index );
 	return FF_SUCCESS;
 }
 
@@ -261,11 +469,35 @@ void Plugin::SetFragmentShader( std::string base )
 	fragmentShaderBase = base;
 }
 
+void Plugin::UseUniformBlock( bool useBlock )
+{
+	useUniformBlock = useBlock;
+}
+
+void Plugin::UseAsyncCompile( bool async )
+{
+	useAsyncCompile = async;
+}
+
+void Plugin::UseStateCache( bool useCache )
+{
+	useStateCache = useCache;
+}
+
+ffglex::FFGLGpuTimer::Stats Plugin::GetGpuStats() const
+{
+	return gpuTimer.GetStats();
+}
+
 void Plugin::AddParam( std::shared_ptr< Param > param )
 {
 	unsigned int new_index = (unsigned int)params.size();
 	SetParamInfo( new_index, param->GetName().c_str(), param->GetType(), param->GetValue() );
 	params.push_back( param );
+	dirtyParams.push_back( true );
+	sentParamVersions.push_back( param->GetVersion() );
+	if( std::dynamic_pointer_cast< ParamTrigger >( param ) )
+		triggerParams.push_back( new_index );
 }
 
 void Plugin::AddParam( std::shared_ptr< ParamRange > param )
@@ -275,12 +507,14 @@ void Plugin::AddParam( std::shared_ptr< ParamRange > param )
 	//In FFGLPluginManager.cpp, line 274, SetParamInfo clamps the default value to 0...1 in case of FF_TYPE_STANDARD 
 	if( param->GetValue() < 0.0f || param->GetValue() > 1.0f )
 	{
-		ParamInfo* paramInfo = FindParamInfo( new_index );
-		if ( paramInfo != nullptr ) 
-			paramInfo->defaultFloatVal = param->GetValue();
+		const ParamInfo* paramInfo = GetParamInfo( new_index );
+		if ( paramInfo != nullptr && paramInfo->defaultFloatVal != param->GetValue() )
+			GetMutableParamInfo( new_index )->defaultFloatVal = param->GetValue();
 	}
 	SetParamRange( new_index, param->GetRange().min, param->GetRange().max );
 	params.push_back( param );
+	dirtyParams.push_back( true );
+	sentParamVersions.push_back( param->GetVersion() );
 }
 
 void Plugin::AddParam( std::shared_ptr< ParamOption > param )
@@ -293,6 +527,8 @@ void Plugin::AddParam( std::shared_ptr< ParamOption > param )
 		SetParamElementInfo( new_index, i, param->options[ i ].name.c_str(), (float)i );
 	}
 	params.push_back( param );
+	dirtyParams.push_back( true );
+	sentParamVersions.push_back( param->GetVersion() );
 }
 
 void Plugin::AddParam( std::shared_ptr< ParamFFT > param )
@@ -301,6 +537,8 @@ void Plugin::AddParam( std::shared_ptr< ParamFFT > param )
 	param->index         = (unsigned int)params.size();
 	SetBufferParamInfo( param->index, param->GetName().c_str(), static_cast< unsigned int >( param->fftData.size() ), FF_USAGE_FFT );
 	params.push_back( param );
+	dirtyParams.push_back( true );
+	sentParamVersions.push_back( param->GetVersion() );
 }
 
 void Plugin::AddHueColorParam( std::string name )
@@ -345,6 +583,12 @@ bool Plugin::IsRGBColor( int index )
 	return isColorType;
 }
 
+void Plugin::MarkParamDirty( unsigned int index )
+{
+	if( index < dirtyParams.size() )
+		dirtyParams[ index ] = true;
+}
+
 std::shared_ptr< Param > Plugin::GetParam( std::string name )
 {
 	for( int i = 0; i < params.size(); i++ )
@@ -400,16 +644,141 @@ void Plugin::Include( std::set< shader::snippet_id > snippets )
 	}
 }
 
+void Plugin::DrawFullScreen()
+{
+	if( useScreenQuad )
+		quad.Draw();
+	else
+		fullScreenPass.Draw();
+}
+
 void Plugin::consumeAllTrigger()
 {
-	for( int i = 0; i < params.size(); i++ )
+	for( unsigned int index : triggerParams )
+	{
+		//Only a trigger that fired needs to be sent again after consuming it.
+		if( params[ index ]->GetValue() == 0.0f )
+			continue;
+		std::static_pointer_cast< ParamTrigger >( params[ index ] )->Consume();
+	}
+}
+
+void Plugin::BuildUploadPlan()
+{
+	paramUploads.clear();
+
+	//This needs to follow the exact same pattern as CreateFragmentShader so that each upload matches the uniform that was generated for it.
+	//The block offsets follow the std140 rules: scalars are aligned to 4 bytes, vec3 and vec4 to 16 bytes.
+	unsigned int blockOffset = sizeof( DefaultUniformsBlock );
+	unsigned int i           = 0;
+	while( i < params.size() )
 	{
-		auto trigger = std::dynamic_pointer_cast< ParamTrigger >( params[ i ] );
-		if( trigger )
+		ParamUpload upload;
+		upload.firstParam = i;
+		if( IsRGBColor( i ) )
+		{
+			upload.kind      = ParamUpload::Kind::RGB;
+			upload.numParams = 3;
+		}
+		else if( IsHueColor( i ) )
+		{
+			upload.kind      = ParamUpload::Kind::HSBA;
+			upload.numParams = 4;
+		}
+		else
+		{
+			upload.kind      = params[ i ]->GetType() == FF_TYPE_BOOLEAN || params[ i ]->GetType() == FF_TYPE_EVENT ? ParamUpload::Kind::BOOL : ParamUpload::Kind::FLOAT;
+			upload.numParams = 1;
+		}
+		i += upload.numParams;
+
+		//Buffers dont have a uniform and uniforms that aren't used by the shader dont need to be sent.
+		if( params[ upload.firstParam ]->GetType() == FF_TYPE_BUFFER )
+			continue;
+		bool isColor       = upload.kind == ParamUpload::Kind::RGB || upload.kind == ParamUpload::Kind::HSBA;
+		upload.blockOffset = AlignOffset( blockOffset, isColor ? 16 : 4 );
+		blockOffset        = upload.blockOffset + ( isColor ? upload.numParams : 1 ) * 4;
+		upload.uniform     = shader.GetUniform( params[ upload.firstParam ]->GetName().c_str() );
+		if( upload.uniform.IsValid() || useUniformBlock )
+			paramUploads.push_back( upload );
+	}
+
+	if( useUniformBlock )
+	{
+		//A block's size is rounded up to a multiple of a vec4.
+		uniformBlockData.assign( AlignOffset( blockOffset, 16 ), 0 );
+		GLuint blockIndex = glGetUniformBlockIndex( shader.GetGLID(), "Params" );
+		if( blockIndex != GL_INVALID_INDEX )
 		{
-			trigger->Consume();
+#if defined( FFGL_DEBUG )
+			GLint blockSize;
+			glGetActiveUniformBlockiv( shader.GetGLID(), blockIndex, GL_UNIFORM_BLOCK_DATA_SIZE, &blockSize );
+			assert( blockSize == (GLint)uniformBlockData.size() );
+#endif
+			glUniformBlockBinding( shader.GetGLID(), blockIndex, PARAMS_BLOCK_BINDING );
 		}
+
+		glGenBuffers( 1, &uniformBlockBuffer );
+		FFGLInstanceStats::AddGLObjects( 1 );
+		ScopedUBOBinding uboBinding( uniformBlockBuffer );
+		glBufferData( GL_UNIFORM_BUFFER, (GLsizeiptr)uniformBlockData.size(), nullptr, GL_DYNAMIC_DRAW );
 	}
+
+	defaultUniforms.time       = shader.GetUniform( "time" );
+	defaultUniforms.deltaTime  = shader.GetUniform( "deltaTime" );
+	defaultUniforms.frame      = shader.GetUniform( "frame" );
+	defaultUniforms.resolution = shader.GetUniform( "resolution" );
+	defaultUniforms.bpm        = shader.GetUniform( "bpm" );
+	defaultUniforms.phase      = shader.GetUniform( "phase" );
+
+	//The program has just been linked so none of the uniforms have a value yet.
+	std::fill( dirtyParams.begin(), dirtyParams.end(), true );
+	hasUploadPlan = true;
+}
+
+void Plugin::SelectVertexInput()
+{
+	//Vertex shaders written for older versions of the sdk read the quad's corners from the vPosition and vUV attributes.
+	//fullScreenPass doesn't source any attributes, those shaders would compile fine but render nothing.
+	useScreenQuad = glGetAttribLocation( shader.GetGLID(), "vPosition" ) != -1;
+	if( useScreenQuad )
+		FFGLLog::LogToHost( FFGLLog::LL_WARNING, "The vertex shader reads the vPosition attribute, drawing it with FFGLScreenQuad. Generate the corners from gl_VertexID to use FFGLFullScreenPass instead." );
+}
+
+FFResult Plugin::RenderWhileCompiling( ProcessOpenGLStruct* inputTextures )
+{
+	//Sources dont have an input to show yet, they just output transparent frames.
+	if( inputTextures->numInputTextures == 0 || inputTextures->inputTextures[ 0 ] == nullptr )
+	{
+		glClearColor( 0.0f, 0.0f, 0.0f, 0.0f );
+		glClear( GL_COLOR_BUFFER_BIT );
+		return FF_SUCCESS;
+	}
+
+	//Effects and mixers pass their first input through. Blitting doesn't need a shader, so this doesn't have to wait for the driver either.
+	const FFGLTextureStruct& input = *inputTextures->inputTextures[ 0 ];
+	if( passthroughFBO == 0 )
+	{
+		glGenFramebuffers( 1, &passthroughFBO );
+		FFGLInstanceStats::AddGLObjects( 1 );
+	}
+	//The host calls us with it's fbo bound, so the state cache can restore it without querying the binding.
+	FFGLStateCache stateCache( inputTextures->HostFBO );
+	stateCache.BindFramebuffer( GL_READ_FRAMEBUFFER, passthroughFBO );
+	glFramebufferTexture2D( GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, input.Handle, 0 );
+	GLint viewportEndX = (GLint)( currentViewport.x + currentViewport.width );
+	GLint viewportEndY = (GLint)( currentViewport.y + currentViewport.height );
+	glBlitFramebuffer( 0, 0, (GLint)input.Width, (GLint)input.Height, (GLint)currentViewport.x, (GLint)currentViewport.y, viewportEndX, viewportEndY, GL_COLOR_BUFFER_BIT, GL_LINEAR );
+	glFramebufferTexture2D( GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, 0, 0 );
+	stateCache.BindFramebuffer( GL_READ_FRAMEBUFFER, inputTextures->HostFBO );
+
+	return FF_SUCCESS;
+}
+
+void Plugin::WriteUniformBlock( unsigned int offset, const void* data, size_t size )
+{
+	assert( offset + size <= uniformBlockData.size() );
+	memcpy( uniformBlockData.data() + offset, data, size );
 }
 
-}//End namespace ffglqs
+}//End namespace ffglqs
\ No newline at end of file
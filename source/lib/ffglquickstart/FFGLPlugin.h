@@ -7,7 +7,9 @@
 #include "../ffgl/FFGLPluginSDK.h"
 #include "../ffgl/FFGLLib.h"
 #include "../ffglex/FFGLShader.h"
+#include "../ffglex/FFGLFullScreenPass.h"
 #include "../ffglex/FFGLScreenQuad.h"
+#include "../ffglex/FFGLGpuTimer.h"
 #include "../ffglex/FFGLUtilities.h"
 #include "../ffglex/FFGLScopedShaderBinding.h"
 #include "FFGLUtils.h"
@@ -105,7 +107,8 @@ public:
 	/// This function is called by the plugin before each render it allows to update all the params that
 	/// are sent to the main shader.
 	void UpdateAudioAndTime();
-	/// This function will send all the parameter registered by your plugin to the shader.
+	/// This function will send all the parameter registered by your plugin to the shader. When called with the plugin's
+	/// own shader only the params that changed since the last call are sent, any other shader always gets all of them.
 	/// \param	shader		The shader to send the params
 	void SendParams( ffglex::FFGLShader& shader );
 	/// This function will send all the default parameter (like time, bpm, resolution...) to the shader.
@@ -145,6 +148,28 @@ public:
 	/// them.
 	/// \param	base		The fragment shader
 	void SetFragmentShader( std::string base );
+	/// Call this in the constructor of your plugin to have CreateFragmentShader declare the params and the default uniforms
+	/// (time, resolution, bpm...) as members of one std140 uniform block instead of as loose uniforms. The plugin keeps a cpu side copy
+	/// of the block which is uploaded with a single buffer update each frame, instead of setting each uniform separately. The block doesn't
+	/// have an instance name so your shader code can keep using the names of the params as is.
+	/// \param	useBlock	Whether or not to use the uniform block
+	void UseUniformBlock( bool useBlock );
+	/// Call this in the constructor of your plugin to compile the main shader without blocking the host. Compiling a shader can take
+	/// long enough to cause a visible hitch when your plugin is loaded while the host is rendering, with this enabled the driver compiles
+	/// it in the background and until it's done effects and mixers pass their first input through while sources output transparent frames.
+	/// The main shader isn't ready yet when Init is called, so don't use it in there.
+	/// \param	async		Whether or not to compile the main shader async
+	void UseAsyncCompile( bool async );
+	/// Call this in the constructor of your plugin to render with an ffglex::FFGLStateCache active, which makes the scoped bindings skip
+	/// binds that wouldn't change anything. Eg the default Render binds the shader that ProcessOpenGL has already bound. If your Render changes
+	/// bindings with direct gl calls instead of the scoped bindings you need to call Invalidate on FFGLStateCache::GetActive() afterwards.
+	/// \param	useCache	Whether or not to use the state cache
+	void UseStateCache( bool useCache );
+	/// This function gives you the gpu time that ProcessOpenGL has taken, so that you can see what your plugin costs without
+	/// a gpu profiler. The time is measured with timestamp queries that are read a frame or two later without waiting for the gpu,
+	/// so the stats lag a bit behind the frames that have been rendered.
+	/// \return				The gpu time stats of all frames that have been measured so far.
+	ffglex::FFGLGpuTimer::Stats GetGpuStats() const;
 	/// This function allows you to add a new parameter to the plugin. There is differents kind of
 	/// parameters available, you can check them in Params.h. Adding a parameter allows the plugin to be
 	/// aware of them, make them available to the host and take of all the communication with it.
@@ -181,6 +206,11 @@ public:
 	/// \param	index		The index of the first parameter that could correspond to a RGB color.
 	bool IsRGBColor( int index );
 
+	/// Params are only sent to the shader when they've changed. Changes made through Param::SetValue are tracked
+	/// automatically, you only need to call this if your own Param subclass changes it's value some other way.
+	/// \param	index		The index of the parameter that changed
+	void MarkParamDirty( unsigned int index );
+
 	/// This function allows to get a parameter by it's name.
 	/// \param	name		The name of the parameter to get.
 	/// \return				The parameter if we managed to find it.
@@ -199,6 +229,9 @@ protected:
 	std::vector< std::shared_ptr< Param > > params;
 	std::map< std::shared_ptr< ParamFFT >, Audio > audioParams;
 	ffglex::FFGLShader shader;
+	ffglex::FFGLFullScreenPass fullScreenPass;
+	/// Deprecated, use fullScreenPass or DrawFullScreen instead. It's still initialised by InitGL for plugins that
+	/// draw it themselves, and DrawFullScreen uses it for vertex shaders that read the vPosition and vUV attributes.
 	ffglex::FFGLScreenQuad quad;
 
 	float timeNow                                                         = 0;
@@ -212,17 +245,75 @@ protected:
 	std::string fragmentShaderCodeStart = R"(
 		#version 410 core
 		out vec4 fragColor;
-		uniform vec2 resolution;
-		uniform float time;
-		uniform float deltaTime;
-		uniform int frame;
-		uniform float bpm;
-		uniform float phase;
 	)";
 	std::string vertexShaderCode;
 
 	// This function will consume the value for all ParamTrigger
 	void consumeAllTrigger();
+	/// Applies the main shader to the whole viewport. This draws fullScreenPass, unless your vertex shader still reads
+	/// the vPosition attribute in which case it draws the quad that sources vPosition and vUV from a vertex buffer.
+	void DrawFullScreen();
+
+private:
+	/// One entry of the upload plan, describes how one uniform of the main shader is built from one or more params.
+	struct ParamUpload
+	{
+		enum class Kind
+		{
+			FLOAT,
+			BOOL,
+			RGB,
+			HSBA
+		};
+		Kind kind;
+		unsigned int firstParam;      //!< Index of the first param that's used to build this uniform.
+		unsigned int numParams;       //!< Colours are built from 3 (rgb) or 4 (hsba) consecutive params.
+		ffglex::UniformHandle uniform;//!< The uniform in the main shader, resolved once when building the plan.
+		unsigned int blockOffset;     //!< Byte offset of the uniform within the Params block when using the uniform block.
+	};
+	struct DefaultUniforms
+	{
+		ffglex::UniformHandle time, deltaTime, frame, resolution, bpm, phase;
+	};
+	/// Cpu side mirror of the default uniforms at the start of the Params block, the members are laid out to match their std140 offsets.
+	struct DefaultUniformsBlock
+	{
+		float resolution[ 2 ];
+		float time;
+		float deltaTime;
+		GLint frame;
+		float bpm;
+		float phase;
+	};
+	static const GLuint PARAMS_BLOCK_BINDING = 0;//!< The uniform buffer binding point that the Params block is bound to.
+
+	/// Resolves how each param maps onto the main shader's uniforms, so that we dont need to redo
+	/// the colour pattern checks and uniform lookups every frame.
+	void BuildUploadPlan();
+	/// Draws the main shader with the quad instead of fullScreenPass if it's vertex shader reads the vPosition attribute.
+	void SelectVertexInput();
+	/// Sends the params and renders a frame with the main shader.
+	FFResult RenderFrame( ProcessOpenGLStruct* inputTextures );
+	/// Renders a frame while the main shader is still compiling async.
+	FFResult RenderWhileCompiling( ProcessOpenGLStruct* inputTextures );
+	/// Copies the value of a uniform into the cpu side copy of the Params block.
+	void WriteUniformBlock( unsigned int offset, const void* data, size_t size );
+
+	bool hasUploadPlan = false;                   //!< Whether or not InitGL compiled the main shader and built the upload plan for it.
+	bool useScreenQuad = false;                   //!< Whether or not the main shader reads vertex attributes and is drawn with the quad instead of fullScreenPass.
+	bool hasRetainedContext = false;              //!< Whether or not InitGL retained the context in the FFGLRenderTargetPool, DeInitGL can be called more than once.
+	std::vector< ParamUpload > paramUploads;      //!< How to send the params to the main shader, only contains the uniforms that the shader actually uses.
+	std::vector< bool > dirtyParams;              //!< Per param whether or not it has to be sent again regardless of it's version.
+	std::vector< unsigned int > sentParamVersions;//!< Per param the version that was last sent to the main shader.
+	std::vector< unsigned int > triggerParams;    //!< Indices of the params that are triggers and need to be consumed after each frame.
+	DefaultUniforms defaultUniforms;              //!< Handles for the default uniforms in the main shader.
+	bool useUniformBlock      = false;            //!< Whether or not the params and default uniforms are declared in the Params uniform block.
+	GLuint uniformBlockBuffer = 0;                //!< The uniform buffer that backs the Params block.
+	std::vector< GLubyte > uniformBlockData;      //!< Cpu side copy of the Params block in std140 layout, uploaded once per frame.
+	bool useAsyncCompile  = false;                //!< Whether or not the main shader is compiled without waiting for the driver to finish.
+	GLuint passthroughFBO = 0;                    //!< Framebuffer used to blit the input to the output while the main shader is compiling.
+	bool useStateCache    = false;                //!< Whether or not frames are rendered with an FFGLStateCache active.
+	ffglex::FFGLGpuTimer gpuTimer;                //!< Measures the gpu time of ProcessOpenGL.
 };
 
 template< typename PluginType >
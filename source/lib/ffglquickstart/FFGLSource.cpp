@@ -12,15 +12,14 @@ Source::Source( bool supportTopLeftTextureOrientation ) :
 	)";
 	vertexShaderCode = R"(
 		#version 410 core
-		layout( location = 0 ) in vec4 vPosition;
-		layout( location = 1 ) in vec2 vUV;
-
 		out vec2 i_uv;
 
 		void main()
 		{
-			gl_Position = vPosition;
-			i_uv = vUV;
+			//Generates a triangle that covers the whole viewport, see FFGLFullScreenPass.
+			vec2 position = vec2( ( gl_VertexID & 1 ) * 4 - 1, ( gl_VertexID & 2 ) * 2 - 1 );
+			gl_Position = vec4( position, 0.0, 1.0 );
+			i_uv = position * 0.5 + 0.5;
 		}
 	)";
 }
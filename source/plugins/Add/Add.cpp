@@ -19,17 +19,16 @@ static const char _vertexShaderCode[] = R"(#version 410 core
 uniform vec2 MaxUVDest;
 uniform vec2 MaxUVSrc;
 
-layout( location = 0 ) in vec4 vPosition;
-layout( location = 1 ) in vec2 vUV;
-
 out vec2 uvDest;
 out vec2 uvSrc;
 
 void main()
 {
-	gl_Position = vPosition;
-	uvDest = vUV * MaxUVDest;
-	uvSrc = vUV * MaxUVSrc;
+	//Generates a triangle that covers the whole viewport, see FFGLFullScreenPass.
+	vec2 position = vec2( ( gl_VertexID & 1 ) * 4 - 1, ( gl_VertexID & 2 ) * 2 - 1 );
+	gl_Position = vec4( position, 0.0, 1.0 );
+	uvDest = ( position * 0.5 + 0.5 ) * MaxUVDest;
+	uvSrc = ( position * 0.5 + 0.5 ) * MaxUVSrc;
 }
 )";
 
@@ -84,7 +83,7 @@ FFResult Add::InitGL( const FFGLViewportStruct* vp )
 		DeInitGL();
 		return FF_FAIL;
 	}
-	if( !quad.Initialise() )
+	if( !fullScreenPass.Initialise() )
 	{
 		DeInitGL();
 		return FF_FAIL;
@@ -124,14 +123,14 @@ FFResult Add::ProcessOpenGL( ProcessOpenGLStruct* pGL )
 	//This takes care of sending all the parameter that the plugin registered to the shader.
 	SendParams( shader );
 
-	//Apply our shader to the full screen quad.
-	quad.Draw();
+	//Apply our shader to the whole viewport.
+	fullScreenPass.Draw();
 
 	return FF_SUCCESS;
 }
 FFResult Add::DeInitGL()
 {
 	shader.FreeGLResources();
-	quad.Release();
+	fullScreenPass.Release();
 	return FF_SUCCESS;
 }
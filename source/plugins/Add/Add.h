@@ -21,6 +21,6 @@ public:
 	}
 
 private:
-	ffglex::FFGLShader shader;  //!< Utility to help us compile and link some shaders into a program.
-	ffglex::FFGLScreenQuad quad;//!< Utility to help us render a full screen quad.
+	ffglex::FFGLShader shader;                //!< Utility to help us compile and link some shaders into a program.
+	ffglex::FFGLFullScreenPass fullScreenPass;//!< Utility to help us apply our shader to the whole viewport.
 };
@@ -24,15 +24,14 @@ static CFFGLPluginInfo PluginInfo(
 static const char _vertexShaderCode[] = R"(#version 410 core
 uniform vec2 MaxUV;
 
-layout( location = 0 ) in vec4 vPosition;
-layout( location = 1 ) in vec2 vUV;
-
 out vec2 uv;
 
 void main()
 {
-	gl_Position = vPosition;
-	uv = vUV * MaxUV;
+	//Generates a triangle that covers the whole viewport, see FFGLFullScreenPass.
+	vec2 position = vec2( ( gl_VertexID & 1 ) * 4 - 1, ( gl_VertexID & 2 ) * 2 - 1 );
+	gl_Position = vec4( position, 0.0, 1.0 );
+	uv = ( position * 0.5 + 0.5 ) * MaxUV;
 }
 )";
 
@@ -83,12 +82,16 @@ FFResult AddSubtract::InitGL( const FFGLViewportStruct* vp )
 		DeInitGL();
 		return FF_FAIL;
 	}
-	if( !quad.Initialise() )
+	if( !fullScreenPass.Initialise() )
 	{
 		DeInitGL();
 		return FF_FAIL;
 	}
 
+	inputTextureUniform = shader.GetUniform( "InputTexture" );
+	maxUVUniform        = shader.GetUniform( "MaxUV" );
+	brightnessUniform   = shader.GetUniform( "Brightness" );
+
 	//Use base-class init as success result so that it retains the viewport.
 	return CFFGLPlugin::InitGL( vp );
 }
@@ -107,23 +110,23 @@ FFResult AddSubtract::ProcessOpenGL( ProcessOpenGLStruct* pGL )
 	ScopedSamplerActivation activateSampler( 0 );
 	Scoped2DTextureBinding textureBinding( pGL->inputTextures[ 0 ]->Handle );
 
-	shader.Set( "InputTexture", 0 );
+	shader.Set( inputTextureUniform, 0 );
 
 	//The input texture's dimension might change each frame and so might the content area.
 	//We're adopting the texture's maxUV using a uniform because that way we dont have to update our vertex buffer each frame.
 	FFGLTexCoords maxCoords = GetMaxGLTexCoords( *pGL->inputTextures[ 0 ] );
-	shader.Set( "MaxUV", maxCoords.s, maxCoords.t );
+	shader.Set( maxUVUniform, maxCoords.s, maxCoords.t );
 
-	glUniform3f( shader.FindUniform( "Brightness" ), r, g, b );
+	shader.Set( brightnessUniform, r, g, b );
 
-	quad.Draw();
+	fullScreenPass.Draw();
 
 	return FF_SUCCESS;
 }
 FFResult AddSubtract::DeInitGL()
 {
 	shader.FreeGLResources();
-	quad.Release();
+	fullScreenPass.Release();
 
 	return FF_SUCCESS;
 }
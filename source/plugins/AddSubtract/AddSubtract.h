@@ -18,8 +18,12 @@ public:
 	float GetFloatParameter( unsigned int index ) override;
 
 private:
-	ffglex::FFGLShader shader;  //!< Utility to help us compile and link some shaders into a program.
-	ffglex::FFGLScreenQuad quad;//!< Utility to help us render a full screen quad.
+	ffglex::FFGLShader shader;                //!< Utility to help us compile and link some shaders into a program.
+	ffglex::FFGLFullScreenPass fullScreenPass;//!< Utility to help us apply our shader to the whole viewport.
+
+	ffglex::UniformHandle inputTextureUniform;//!< Resolved once after compiling so that we dont need to look them up every frame.
+	ffglex::UniformHandle maxUVUniform;
+	ffglex::UniformHandle brightnessUniform;
 
 	float r, g, b;
 };
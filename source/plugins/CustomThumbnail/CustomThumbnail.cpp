@@ -79,11 +79,11 @@ static CFFGLThumbnailInfo ThumbnailInfo( THUMBNAIL_WIDTH, THUMBNAIL_HEIGHT, gene
 #endif
 
 static const char vertexShaderCode[] = R"(#version 410
-layout( location = 0 ) in vec4 vPosition;
-
 void main()
 {
-	gl_Position = vPosition;
+	//Generates a triangle that covers the whole viewport, see FFGLFullScreenPass.
+	vec2 position = vec2( ( gl_VertexID & 1 ) * 4 - 1, ( gl_VertexID & 2 ) * 2 - 1 );
+	gl_Position = vec4( position, 0.0, 1.0 );
 }
 )";
 
@@ -135,7 +135,7 @@ FFResult CustomThumbnail::InitGL( const FFGLViewportStruct* vp )
 		DeInitGL();
 		return FF_FAIL;
 	}
-	if( !quad.Initialise() )
+	if( !fullScreenPass.Initialise() )
 	{
 		DeInitGL();
 		return FF_FAIL;
@@ -154,14 +154,14 @@ FFResult CustomThumbnail::ProcessOpenGL( ProcessOpenGLStruct* pGL )
 	ScopedShaderBinding shaderBinding( shader.GetGLID() );
 	glUniform1f( intensityLocation, intensity );
 
-	quad.Draw();
+	fullScreenPass.Draw();
 
 	return FF_SUCCESS;
 }
 FFResult CustomThumbnail::DeInitGL()
 {
 	shader.FreeGLResources();
-	quad.Release();
+	fullScreenPass.Release();
 	intensityLocation = -1;
 
 	return FF_SUCCESS;
@@ -24,17 +24,17 @@ private:
 
 namespace PNGHelpers
 {
-static void __cdecl readCallback( png_structp png, png_bytep data, png_size_t length )
+static void PNGCBAPI readCallback( png_structp png, png_bytep data, png_size_t length )
 {
 	ByteStream& stream = *reinterpret_cast< ByteStream* >( png_get_io_ptr( png ) );
 	stream.Read( data, length );
 }
 
-static void __cdecl errorCallback( png_structp png_ptr, png_const_charp error_message )
+static void PNGCBAPI errorCallback( png_structp png_ptr, png_const_charp error_message )
 {
 	throw std::runtime_error( error_message );
 }
-static void __cdecl warningCallback( png_structp, png_const_charp )
+static void PNGCBAPI warningCallback( png_structp, png_const_charp )
 {
 }
 
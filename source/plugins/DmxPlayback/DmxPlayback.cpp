@@ -17,15 +17,14 @@ static CFFGLPluginInfo PluginInfo(
 );
 
 static const char vertexShaderCode[] = R"(#version 410 core
-layout( location = 0 ) in vec4 vPosition;
-layout( location = 1 ) in vec2 vUV;
-
 out vec2 uv;
 
 void main()
 {
-	gl_Position = vPosition;
-	uv = vUV;
+	//Generates a triangle that covers the whole viewport, see FFGLFullScreenPass.
+	vec2 position = vec2( ( gl_VertexID & 1 ) * 4 - 1, ( gl_VertexID & 2 ) * 2 - 1 );
+	gl_Position = vec4( position, 0.0, 1.0 );
+	uv = position * 0.5 + 0.5;
 }
 )";
 
@@ -44,7 +43,7 @@ void main()
 )";
 
 DmxPlayback::DmxPlayback() :
-	dmxDataTextureId( -1 )
+	gpuTimer( "DmxPlayback" )
 {
 	// Input properties (0 means that it is a source, if it has inputs, it is an effect)
 	SetMinInputs( 0 );
@@ -82,44 +81,48 @@ DmxPlayback::DmxPlayback() :
 	}
 
 	// Loop over all the parameters and make them known in the UI
-	for( auto& layer : layers )
+	// Instances that are created after the first one share it's params, so they can skip this.
+	if( !UseSharedParamSchema() )
 	{
-		// Define the group name where parameters of this layer should be grouped into
-		std::stringstream group_name_ss;
-		group_name_ss << "Layer " << std::to_string(layer.layerNumber) << " recordings";
-
-		// Configure recording file parameters
-		for( auto& recordedSequence : layer.recordedSequences )
+		for( auto& layer : layers )
 		{
-			// Configure a recording file parameter
-			std::stringstream recording_param_ss;
-			recording_param_ss << "Recording " << std::to_string(layer.layerNumber) << "." << std::to_string(recordedSequence.sequenceNumber);
-			SetFileParamInfo( recordedSequence.recordingParameterId, recording_param_ss.str().c_str(), { "csv" }, "" );
+			// Define the group name where parameters of this layer should be grouped into
+			std::stringstream group_name_ss;
+			group_name_ss << "Layer " << std::to_string(layer.layerNumber) << " recordings";
 
-			// Assign the parameter to a group
-			SetParamGroup( recordedSequence.recordingParameterId, group_name_ss.str() );
-		}
+			// Configure recording file parameters
+			for( auto& recordedSequence : layer.recordedSequences )
+			{
+				// Configure a recording file parameter
+				std::stringstream recording_param_ss;
+				recording_param_ss << "Recording " << std::to_string(layer.layerNumber) << "." << std::to_string(recordedSequence.sequenceNumber);
+				SetFileParamInfo( recordedSequence.recordingParameterId, recording_param_ss.str().c_str(), { "csv" }, "" );
 
-		// Configure an active clip parameter
-		std::stringstream active_clip_ss;
-		active_clip_ss << "L" << std::to_string(layer.layerNumber) << " active clip";
-		SetOptionParamInfo( layer.activeClipParameterId, active_clip_ss.str().c_str(), numSequencesPerLayer, layer.activeClipParameterValue );
-		for( std::uint8_t clipCounter = 0; clipCounter < numSequencesPerLayer; ++clipCounter )
-		{
-			SetParamElementInfo( layer.activeClipParameterId, clipCounter, std::to_string( clipCounter + 1 ).c_str(), (float)(clipCounter + 1));
-		}
+				// Assign the parameter to a group
+				SetParamGroup( recordedSequence.recordingParameterId, group_name_ss.str() );
+			}
+
+			// Configure an active clip parameter
+			std::stringstream active_clip_ss;
+			active_clip_ss << "L" << std::to_string(layer.layerNumber) << " active clip";
+			SetOptionParamInfo( layer.activeClipParameterId, active_clip_ss.str().c_str(), numSequencesPerLayer, layer.activeClipParameterValue );
+			for( std::uint8_t clipCounter = 0; clipCounter < numSequencesPerLayer; ++clipCounter )
+			{
+				SetParamElementInfo( layer.activeClipParameterId, clipCounter, std::to_string( clipCounter + 1 ).c_str(), (float)(clipCounter + 1));
+			}
 
-		// Configure a frame position parameter
-		std::stringstream frame_position_ss;
-		frame_position_ss << "L" << std::to_string( layer.layerNumber ) << " frame";
-		SetParamInfof( layer.framePositionParameterId, frame_position_ss.str().c_str(), FF_TYPE_STANDARD );
-		SetParamRange( layer.framePositionParameterId, 0, 1 );
-
-		// Configure an opacity parameter
-		std::stringstream opacity_ss;
-		opacity_ss << "L" << std::to_string(layer.layerNumber) << " opacity";
-		SetParamInfof( layer.opacityParameterId, opacity_ss.str().c_str(), FF_TYPE_ALPHA );
-		SetParamRange( layer.opacityParameterId, 0, 1 );
+			// Configure a frame position parameter
+			std::stringstream frame_position_ss;
+			frame_position_ss << "L" << std::to_string( layer.layerNumber ) << " frame";
+			SetParamInfof( layer.framePositionParameterId, frame_position_ss.str().c_str(), FF_TYPE_STANDARD );
+			SetParamRange( layer.framePositionParameterId, 0, 1 );
+
+			// Configure an opacity parameter
+			std::stringstream opacity_ss;
+			opacity_ss << "L" << std::to_string(layer.layerNumber) << " opacity";
+			SetParamInfof( layer.opacityParameterId, opacity_ss.str().c_str(), FF_TYPE_ALPHA );
+			SetParamRange( layer.opacityParameterId, 0, 1 );
+		}
 	}
 
 	FFGLLog::LogToHost( "Created DMX Playback source" );
@@ -131,13 +134,36 @@ FFResult DmxPlayback::InitGL( const FFGLViewportStruct* vp )
 		DeInitGL();
 		return FF_FAIL;
 	}
-	if( !quad.Initialise() )
+	if( !fullScreenPass.Initialise() )
 	{
 		DeInitGL();
 		return FF_FAIL;
 	}
 
-	dmxDataTextureId = shader.FindUniform( "DmxDataTexture" );
+	// Generate a texture for the dmx data. A pixel data format with only RED and ALPHA is not available, but as an alternative, GL_RG also has two color channels RED and GREEN.
+	// We can store the RED channel in the RED channel and the and ALPHA channel in the GREEN channel.
+	if( !dmxDataTexture.Initialise( 32, 16, GL_RG8, GL_RG, GL_UNSIGNED_BYTE ) )
+	{
+		DeInitGL();
+		return FF_FAIL;
+	}
+	//Measuring the gpu time is optional, so we'll keep on rendering if the driver doesn't support it.
+	gpuTimer.Initialise();
+
+	//Use the scoped binding so that the context state is restored to it's default as required by ffgl.
+	Scoped2DTextureBinding textureBinding( dmxDataTexture.GetGLID() );
+
+	// Avoid color interpolation when sampling from the texture, with GL_NEAREST
+	// GL_NEAREST = Returns the value of the texture element that is nearest (in Manhattan distance) to the specified texture coordinates.
+	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST );
+	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST );
+
+	// Use a Swizzle mask to rearrange the color components of the texture again. This will only be used in the shader when retrieving colors.
+	// Since we have a texture with RED and GREEN color channels, we can remap the RED onto RED and GREEN onto ALPHA.
+	// Then, when sampling colors inside the shader we can use .rrra instead of the slightly more confusing .rrrg.
+	GLint swizzleMask[] = { GL_RED, GL_ZERO, GL_ZERO, GL_GREEN };
+	glTexParameteriv( GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzleMask );
+	textureBinding.EndScope();
 
 	//Use base-class init as success result so that it retains the viewport.
 	return CFFGLPlugin::InitGL( vp );
@@ -195,44 +221,36 @@ FFResult DmxPlayback::ProcessOpenGL( ProcessOpenGLStruct* pGL )
 		}
 	}
 
-	glGenTextures( 1, &dmxDataTextureId );
-	if( dmxDataTextureId == 0 )
-		return false;
-
-	//Use the scoped binding so that the context state is restored to it's default as required by ffgl.
-	Scoped2DTextureBinding textureBinding( dmxDataTextureId );
+	// Measure the gpu time of the upload and the draw, building the frame above only costs cpu time.
+	ScopedGpuZone gpuZone( gpuTimer );
 
-	// Avoid color interpolation when sampling from the texture, with GL_NEAREST
-	// GL_NEAREST = Returns the value of the texture element that is nearest (in Manhattan distance) to the specified texture coordinates.
-	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST );
-	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST );
-
-	// Generate a texture from the input data. A pixel data format with only RED and ALPHA is not available, but as an alternative, GL_RG also has two color channels RED and GREEN.
-	// We can store the RED channel in the RED channel and the and ALPHA channel in the GREEN channel.
-	glTexImage2D( GL_TEXTURE_2D, 0, GL_RG8, 32, 16, 0, GL_RG, GL_UNSIGNED_BYTE, dmxPixelDataFrame );
+	// Upload the frame through the streaming texture, which doesn't wait for the driver to copy the pixels.
+	if( !dmxDataTexture.Upload( dmxPixelDataFrame ) )
+		return FF_FAIL;
 
-	// Use a Swizzle mask to rearrange the color components of the texture again. This will only be used in the shader when retrieving colors.
-	// Since we have a texture with RED and GREEN color channels, we can remap the RED onto RED and GREEN onto ALPHA.
-	// Then, when sampling colors inside the shader we can use .rrra instead of the slightly more confusing .rrrg.
-	GLint swizzleMask[] = { GL_RED, GL_ZERO, GL_ZERO, GL_GREEN };
-	glTexParameteriv( GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzleMask );
+	//Use the scoped binding so that the context state is restored to it's default as required by ffgl.
+	Scoped2DTextureBinding textureBinding( dmxDataTexture.GetGLID() );
 
-	quad.Draw();
+	fullScreenPass.Draw();
 
 	return FF_SUCCESS;
 }
 
 FFResult DmxPlayback::DeInitGL()
 {
-	glDeleteTextures( 1, &dmxDataTextureId );
-	dmxDataTextureId = -1;
-
+	dmxDataTexture.Release();
 	shader.FreeGLResources();
-	quad.Release();
+	fullScreenPass.Release();
+	gpuTimer.Release();
 
 	return FF_SUCCESS;
 }
 
+ffglex::FFGLGpuTimer::Stats DmxPlayback::GetGpuStats() const
+{
+	return gpuTimer.GetStats();
+}
+
 FFResult DmxPlayback::SetFloatParameter( unsigned int index, float value )
 {
 	for( auto& layer : layers )
@@ -282,6 +300,9 @@ FFResult DmxPlayback::SetTextParameter( unsigned int index, const char* value )
 					return FF_SUCCESS;
 				}
 
+				// Reading a recording can take a while, show it as a zone of its own when tracing.
+				FFGLTraceZone traceZone( "LoadRecording", this );
+
 				// Create a vector of <uint16_t, uint8_t vector> pairs to store the time-based DMX recording data
 				// Each pair represents <DMX channel, series of DMX values for this channel over time>
 				std::vector< std::pair< std::uint16_t, std::vector< uint8_t > > > dmxRecordingData;
@@ -52,6 +52,8 @@ public:
 	float GetFloatParameter( unsigned int index ) override;
 	char* GetTextParameter( unsigned int index ) override;
 
+	ffglex::FFGLGpuTimer::Stats GetGpuStats() const;//The gpu time uploading and drawing the dmx data has taken.
+
 private:
 	std::vector< Layer > layers; // An inmemory map of all the source's layers and their parameters
 
@@ -61,8 +63,8 @@ private:
 	const std::uint16_t dataFrameLength = 32 * 16 * 2;
 	unsigned char dmxPixelDataFrame[ 32 * 16 * 2 ];
 
-	ffglex::FFGLShader shader;  //!< Utility to help us compile and link some shaders into a program.
-	ffglex::FFGLScreenQuad quad;//!< Utility to help us render a full screen quad.
-	
-	GLuint dmxDataTextureId;
+	ffglex::FFGLShader shader;                  //!< Utility to help us compile and link some shaders into a program.
+	ffglex::FFGLFullScreenPass fullScreenPass;  //!< Utility to help us apply our shader to the whole viewport.
+	ffglex::FFGLStreamingTexture dmxDataTexture;//!< The texture we upload a frame of dmx data into without stalling the driver.
+	ffglex::FFGLGpuTimer gpuTimer;              //!< Measures the gpu time of uploading and drawing the dmx data.
 };
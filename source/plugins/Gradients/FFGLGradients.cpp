@@ -2,19 +2,6 @@
 #include <math.h>//floor
 using namespace ffglex;
 
-enum ParamType : FFUInt32
-{
-	PT_RED1,
-	PT_GREEN1,
-	PT_BLUE1,
-	PT_ALP1,
-
-	PT_HUE2,
-	PT_SAT2,
-	PT_BRI2,
-	PT_ALP2,
-};
-
 static CFFGLPluginInfo PluginInfo(
 	PluginFactory< FFGLGradients >,// Create method
 	"RS01",                        // Plugin unique ID
@@ -29,15 +16,14 @@ static CFFGLPluginInfo PluginInfo(
 );
 
 static const char vertexShaderCode[] = R"(#version 410 core
-layout( location = 0 ) in vec4 vPosition;
-layout( location = 1 ) in vec2 vUV;
-
 out vec2 uv;
 
 void main()
 {
-	gl_Position = vPosition;
-	uv = vUV;
+	//Generates a triangle that covers the whole viewport, see FFGLFullScreenPass.
+	vec2 position = vec2( ( gl_VertexID & 1 ) * 4 - 1, ( gl_VertexID & 2 ) * 2 - 1 );
+	gl_Position = vec4( position, 0.0, 1.0 );
+	uv = position * 0.5 + 0.5;
 }
 )";
 
@@ -55,7 +41,20 @@ void main()
 }
 )";
 
+const FFGLParamDescription< FFGLGradients > FFGLGradients::PARAMS[] = {
+	{ "Red 1", FF_TYPE_RED, &FFGLGradients::red1, 1.0f },
+	{ "Green 1", FF_TYPE_GREEN, &FFGLGradients::green1, 1.0f },
+	{ "Blue 1", FF_TYPE_BLUE, &FFGLGradients::blue1, 0.0f },
+	{ "Alpha 1", FF_TYPE_ALPHA, &FFGLGradients::alpha1, 1.0f },
+
+	{ "Hue 2", FF_TYPE_HUE, &FFGLGradients::hue2, 0.5f },
+	{ "Saturation 2", FF_TYPE_SATURATION, &FFGLGradients::saturation2, 1.0f },
+	{ "Brightness 2", FF_TYPE_BRIGHTNESS, &FFGLGradients::brightness2, 1.0f },
+	{ "Alpha 2", FF_TYPE_ALPHA, &FFGLGradients::alpha2, 1.0f },
+};
+
 FFGLGradients::FFGLGradients() :
+	CFFGLParamTablePlugin( PARAMS ),
 	rgbLeftLocation( -1 ),
 	rgbRightLocation( -1 )
 {
@@ -63,18 +62,6 @@ FFGLGradients::FFGLGradients() :
 	SetMinInputs( 0 );
 	SetMaxInputs( 0 );
 
-	hsba2.hue = 0.5f;
-	// Parameters
-	SetParamInfof( PT_RED1, "Red 1", FF_TYPE_RED );
-	SetParamInfof( PT_GREEN1, "Green 1", FF_TYPE_GREEN );
-	SetParamInfof( PT_BLUE1, "Blue 1", FF_TYPE_BLUE );
-	SetParamInfof( PT_ALP1, "Alpha 1", FF_TYPE_ALPHA );
-
-	SetParamInfof( PT_HUE2, "Hue 2", FF_TYPE_HUE );
-	SetParamInfof( PT_SAT2, "Saturation 2", FF_TYPE_SATURATION );
-	SetParamInfof( PT_BRI2, "Brightness 2", FF_TYPE_BRIGHTNESS );
-	SetParamInfof( PT_ALP2, "Alpha 2", FF_TYPE_ALPHA );
-
 	FFGLLog::LogToHost( "Created Gradient generator" );
 }
 FFResult FFGLGradients::InitGL( const FFGLViewportStruct* vp )
@@ -84,7 +71,7 @@ FFResult FFGLGradients::InitGL( const FFGLViewportStruct* vp )
 		DeInitGL();
 		return FF_FAIL;
 	}
-	if( !quad.Initialise() )
+	if( !fullScreenPass.Initialise() )
 	{
 		DeInitGL();
 		return FF_FAIL;
@@ -101,88 +88,25 @@ FFResult FFGLGradients::InitGL( const FFGLViewportStruct* vp )
 FFResult FFGLGradients::ProcessOpenGL( ProcessOpenGLStruct* pGL )
 {
 	float rgba2[ 4 ];
-	float hue2 = ( hsba2.hue == 1.0f ) ? 0.0f : hsba2.hue;
-	HSVtoRGB( hue2, hsba2.sat, hsba2.bri, rgba2[ 0 ], rgba2[ 1 ], rgba2[ 2 ] );
-	rgba2[ 3 ] = hsba2.alpha;
+	float hue = ( hue2 == 1.0f ) ? 0.0f : hue2;
+	HSVtoRGB( hue, saturation2, brightness2, rgba2[ 0 ], rgba2[ 1 ], rgba2[ 2 ] );
+	rgba2[ 3 ] = alpha2;
 
 	//FFGL requires us to leave the context in a default state on return, so use this scoped binding to help us do that.
 	ScopedShaderBinding shaderBinding( shader.GetGLID() );
-	glUniform4f( rgbLeftLocation, rgba1.red, rgba1.green, rgba1.blue, rgba1.alpha );
+	glUniform4f( rgbLeftLocation, red1, green1, blue1, alpha1 );
 	glUniform4f( rgbRightLocation, rgba2[ 0 ], rgba2[ 1 ], rgba2[ 2 ], rgba2[ 3 ] );
 
-	quad.Draw();
+	fullScreenPass.Draw();
 
 	return FF_SUCCESS;
 }
 FFResult FFGLGradients::DeInitGL()
 {
 	shader.FreeGLResources();
-	quad.Release();
+	fullScreenPass.Release();
 	rgbLeftLocation  = -1;
 	rgbRightLocation = -1;
 
 	return FF_SUCCESS;
 }
-
-FFResult FFGLGradients::SetFloatParameter( unsigned int dwIndex, float value )
-{
-	switch( dwIndex )
-	{
-	case PT_RED1:
-		rgba1.red = value;
-		break;
-	case PT_GREEN1:
-		rgba1.green = value;
-		break;
-	case PT_BLUE1:
-		rgba1.blue = value;
-		break;
-	case PT_ALP1:
-		rgba1.alpha = value;
-		break;
-
-	case PT_HUE2:
-		hsba2.hue = value;
-		break;
-	case PT_SAT2:
-		hsba2.sat = value;
-		break;
-	case PT_BRI2:
-		hsba2.bri = value;
-		break;
-	case PT_ALP2:
-		hsba2.alpha = value;
-		break;
-
-	default:
-		return FF_FAIL;
-	}
-
-	return FF_SUCCESS;
-}
-
-float FFGLGradients::GetFloatParameter( unsigned int index )
-{
-	switch( index )
-	{
-	case PT_RED1:
-		return rgba1.red;
-	case PT_GREEN1:
-		return rgba1.green;
-	case PT_BLUE1:
-		return rgba1.blue;
-	case PT_ALP1:
-		return rgba1.alpha;
-
-	case PT_HUE2:
-		return hsba2.hue;
-	case PT_SAT2:
-		return hsba2.sat;
-	case PT_BRI2:
-		return hsba2.bri;
-	case PT_ALP2:
-		return hsba2.alpha;
-	}
-
-	return 0.0f;
-}
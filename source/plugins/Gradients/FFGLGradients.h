@@ -1,7 +1,7 @@
 #pragma once
 #include <FFGLSDK.h>
 
-class FFGLGradients : public CFFGLPlugin
+class FFGLGradients : public CFFGLParamTablePlugin< FFGLGradients >
 {
 public:
 	FFGLGradients();
@@ -11,30 +11,20 @@ public:
 	FFResult ProcessOpenGL( ProcessOpenGLStruct* pGL ) override;
 	FFResult DeInitGL() override;
 
-	FFResult SetFloatParameter( unsigned int dwIndex, float value ) override;
-
-	float GetFloatParameter( unsigned int index ) override;
-
 private:
-	struct RGBA
-	{
-		float red   = 1.0f;
-		float green = 1.0f;
-		float blue  = 0.0f;
-		float alpha = 1.0f;
-	};
-	struct HSBA
-	{
-		float hue   = 0.0f;
-		float sat   = 1.0f;
-		float bri   = 1.0f;
-		float alpha = 1.0f;
-	};
-	RGBA rgba1;
-	HSBA hsba2;
+	static const FFGLParamDescription< FFGLGradients > PARAMS[];//!< Our params, the sdk routes the host's values to these members for us.
+
+	float red1;
+	float green1;
+	float blue1;
+	float alpha1;
+	float hue2;
+	float saturation2;
+	float brightness2;
+	float alpha2;
 
-	ffglex::FFGLShader shader;  //!< Utility to help us compile and link some shaders into a program.
-	ffglex::FFGLScreenQuad quad;//!< Utility to help us render a full screen quad.
+	ffglex::FFGLShader shader;                //!< Utility to help us compile and link some shaders into a program.
+	ffglex::FFGLFullScreenPass fullScreenPass;//!< Utility to help us apply our shader to the whole viewport.
 	GLint rgbLeftLocation;
 	GLint rgbRightLocation;
 };
@@ -73,6 +73,8 @@ enum ParamID
 };
 
 Particles::Particles() :
+	updateTimer( "UpdateParticles" ),
+	renderTimer( "RenderParticles" ),
 	fadeoutStart( 0.2f ),
 	smokeStart( 0.5f ),
 	smokeIntensity( 0.4f ),
@@ -129,6 +131,9 @@ FFResult Particles::InitGL( const FFGLViewportStruct* vp )
 		DeInitGL();
 		return FF_FAIL;
 	}
+	//Measuring the gpu time is optional, so we'll keep on rendering if the driver doesn't support it.
+	updateTimer.Initialise();
+	renderTimer.Initialise();
 
 	//Use base-class init as success result so that it retains the viewport.
 	return CFFGLPlugin::InitGL( vp );
@@ -136,6 +141,8 @@ FFResult Particles::InitGL( const FFGLViewportStruct* vp )
 FFResult Particles::DeInitGL()
 {
 	glResources.Release();
+	updateTimer.Release();
+	renderTimer.Release();
 
 	return FF_SUCCESS;
 }
@@ -152,6 +159,15 @@ FFResult Particles::ProcessOpenGL( ProcessOpenGLStruct* pGL )
 	return FF_SUCCESS;
 }
 
+ffglex::FFGLGpuTimer::Stats Particles::GetUpdateGpuStats() const
+{
+	return updateTimer.GetStats();
+}
+ffglex::FFGLGpuTimer::Stats Particles::GetRenderGpuStats() const
+{
+	return renderTimer.GetStats();
+}
+
 char* Particles::GetParameterDisplay( unsigned int index )
 {
 	/**
@@ -292,13 +308,12 @@ float Particles::GetFloatParameter( unsigned int index )
 
 void Particles::UpdateParticles( float deltaTime )
 {
-	std::vector< float > fftData( MAX_BUCKETS );
-	const ParamInfo* fftInfo = FindParamInfo( PID_FFT_INPUT );
-	for( size_t index = 0; index < MAX_BUCKETS; ++index )
-		fftData[ index ] = fftInfo->elements[ index ].value;
+	const float* fftData = GetBufferParamValues( PID_FFT_INPUT );
 
 	glResources.FlipBuffers();
 
+	FFGLTraceZone traceZone( "UpdateParticles", this );
+	ScopedGpuZone gpuZone( updateTimer );
 	ScopedShaderBinding shaderBinding( glResources.GetUpdateShader().GetGLID() );
 
 	glEnable( GL_RASTERIZER_DISCARD );
@@ -309,7 +324,7 @@ void Particles::UpdateParticles( float deltaTime )
 	std::vector< float > spawnChances( numBuckets );
 	memset( spawnChances.data(), 0, spawnChances.size() * sizeof( float ) );
 	//TODO: Map from fft's num bins to our num buckets. Audio guys halp!
-	for( size_t index = 0; index < numBuckets && index < fftData.size(); ++index )
+	for( size_t index = 0; index < numBuckets && index < MAX_BUCKETS; ++index )
 	{
 		float widthPerBucket = 1.6f / numBuckets;
 		Rectf spawnArea;
@@ -346,6 +361,8 @@ void Particles::UpdateParticles( float deltaTime )
 }
 void Particles::RenderParticles()
 {
+	FFGLTraceZone traceZone( "RenderParticles", this );
+	ScopedGpuZone gpuZone( renderTimer );
 	ScopedShaderBinding shaderBinding( glResources.GetRenderShader().GetGLID() );
 	ScopedVAOBinding vaoBinding( glResources.GetBackVAOID() );
 	ScopedSamplerActivation samplerBinding( 0 );
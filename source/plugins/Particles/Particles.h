@@ -18,11 +18,16 @@ public:
 
 	float GetFloatParameter( unsigned int index ) override;
 
+	ffglex::FFGLGpuTimer::Stats GetUpdateGpuStats() const;//The gpu time the simulation has taken.
+	ffglex::FFGLGpuTimer::Stats GetRenderGpuStats() const;//The gpu time drawing the particles has taken.
+
 protected:
 	void UpdateParticles( float deltaTime );
 	void RenderParticles();
 
-	GLResources glResources;//!< The container of our OpenGL resources.
+	GLResources glResources;         //!< The container of our OpenGL resources.
+	ffglex::FFGLGpuTimer updateTimer;//!< Measures the gpu time of UpdateParticles.
+	ffglex::FFGLGpuTimer renderTimer;//!< Measures the gpu time of RenderParticles.
 
 	//Parameters
 	float fadeoutStart;